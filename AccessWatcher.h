@@ -0,0 +1,53 @@
+/**
+ * @file AccessWatcher.h
+ * @brief Notification interface for CPU reads and writes on watched pages
+ */
+
+#ifndef M6502_ACCESS_WATCHER_H
+#define M6502_ACCESS_WATCHER_H
+
+#include "Constants.h"
+
+namespace M6502 {
+
+    /**
+     * @brief Receives bus accesses to pages a debugger has asked to watch
+     *
+     * Memory's read path tests nothing: while a page is read-watched the
+     * CPU is stepping through its instrumented path, which reports the
+     * reads each instruction is about to make (Memory::ReadsWatched()).
+     * A watched write shares the test writes already make for cached
+     * code. MemoryBus routes watched pages through its I/O path, so its
+     * RAM and ROM fast path does not change at all. Only accesses to
+     * watched pages reach the watcher, which does the exact address
+     * match itself.
+     *
+     * Untimed accesses (operator[], ReadByteNoCycles) are not reported.
+     */
+    class AccessWatcher {
+    public:
+        /// Page flags for WatchAccesses()
+        static constexpr Byte WATCH_READ = 0x01;
+        static constexpr Byte WATCH_WRITE = 0x02;
+
+        /**
+         * @brief The CPU read `value` from `address` in a read-watched page
+         *
+         * Opcode and operand fetches are bus reads too and are reported.
+         */
+        virtual void OnWatchedRead(Address address, Byte value) = 0;
+
+        /**
+         * @brief The CPU wrote `value` to `address` in a write-watched page
+         *
+         * Reported after the write has reached memory or the device.
+         */
+        virtual void OnWatchedWrite(Address address, Byte value) = 0;
+
+    protected:
+        ~AccessWatcher() = default;
+    };
+
+} // namespace M6502
+
+#endif // M6502_ACCESS_WATCHER_H
@@ -0,0 +1,242 @@
+/**
+ * @file BatchRunner.cpp
+ * @brief Implementation of the work-stealing batch runner
+ */
+
+#include "BatchRunner.h"
+#include <algorithm>
+#include <array>
+
+namespace M6502 {
+
+    template <typename Timing>
+    BasicBatchRunner<Timing>::BasicBatchRunner(std::size_t threads)
+        : jobs(nullptr), results(nullptr), generation(0), busy(0), stopping(false) {
+        std::size_t count = threads;
+        if (count == 0) {
+            count = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+        }
+
+        // Every arena is allocated here, once; jobs only reuse them
+        for (std::size_t i = 0; i < count; i++) {
+            workers.push_back(std::make_unique<Worker>());
+            workers.back()->arena = std::make_unique<Arena>();
+        }
+
+        // Worker 0 is whichever thread calls Run()
+        for (std::size_t i = 1; i < count; i++) {
+            this->threads.emplace_back(&BasicBatchRunner::WorkerLoop, this, i);
+        }
+    }
+
+    template <typename Timing>
+    BasicBatchRunner<Timing>::~BasicBatchRunner() {
+        {
+            std::lock_guard<std::mutex> guard(control);
+            stopping = true;
+        }
+        wake.notify_all();
+
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    template <typename Timing>
+    std::vector<BatchResult> BasicBatchRunner<Timing>::Run(const std::vector<BatchJob>& jobs) {
+        std::vector<BatchResult> results(jobs.size());
+        Run(jobs.data(), jobs.size(), results.data());
+        return results;
+    }
+
+    template <typename Timing>
+    void BasicBatchRunner<Timing>::Run(const BatchJob* jobs, std::size_t count,
+                                       BatchResult* results) {
+        if (count == 0) {
+            return;
+        }
+
+        // One contiguous range per worker; stealing evens out the rest
+        const std::size_t workerCount = workers.size();
+        for (std::size_t i = 0; i < workerCount; i++) {
+            Worker& worker = *workers[i];
+            std::lock_guard<std::mutex> guard(worker.lock);
+            worker.begin = count * i / workerCount;
+            worker.end = count * (i + 1) / workerCount;
+            worker.steals = 0;
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(control);
+            this->jobs = jobs;
+            this->results = results;
+            busy = workerCount - 1;
+            generation++;
+        }
+        wake.notify_all();
+
+        Drain(0);
+
+        std::unique_lock<std::mutex> guard(control);
+        done.wait(guard, [this] { return busy == 0; });
+    }
+
+    template <typename Timing>
+    std::uint64_t BasicBatchRunner<Timing>::Steals() const {
+        std::uint64_t total = 0;
+        for (const auto& worker : workers) {
+            total += worker->steals;
+        }
+        return total;
+    }
+
+    // ====================================================================
+    // WORKERS
+    // ====================================================================
+
+    template <typename Timing>
+    void BasicBatchRunner<Timing>::WorkerLoop(std::size_t index) {
+        std::uint64_t seen = 0;
+
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> guard(control);
+                wake.wait(guard, [&] { return stopping || generation != seen; });
+                if (stopping) {
+                    return;
+                }
+                seen = generation;
+            }
+
+            Drain(index);
+
+            std::lock_guard<std::mutex> guard(control);
+            if (--busy == 0) {
+                done.notify_all();
+            }
+        }
+    }
+
+    template <typename Timing>
+    void BasicBatchRunner<Timing>::Drain(std::size_t index) {
+        Arena& arena = *workers[index]->arena;
+
+        for (;;) {
+            std::size_t job;
+            if (TakeJob(index, job)) {
+                RunJob(arena, jobs[job], results[job]);
+            } else if (!Steal(index)) {
+                // Every range is empty; jobs still running elsewhere are
+                // not ours to wait for
+                return;
+            }
+        }
+    }
+
+    template <typename Timing>
+    bool BasicBatchRunner<Timing>::TakeJob(std::size_t index, std::size_t& job) {
+        Worker& worker = *workers[index];
+        std::lock_guard<std::mutex> guard(worker.lock);
+
+        if (worker.begin == worker.end) {
+            return false;
+        }
+        job = worker.begin++;
+        return true;
+    }
+
+    template <typename Timing>
+    bool BasicBatchRunner<Timing>::Steal(std::size_t thief) {
+        const std::size_t workerCount = workers.size();
+
+        for (std::size_t offset = 1; offset < workerCount; offset++) {
+            Worker& victim = *workers[(thief + offset) % workerCount];
+
+            std::size_t first, last;
+            {
+                std::lock_guard<std::mutex> guard(victim.lock);
+                std::size_t remaining = victim.end - victim.begin;
+                if (remaining == 0) {
+                    continue;
+                }
+
+                // Take the back half (rounded up, so a single job moves too)
+                last = victim.end;
+                victim.end -= (remaining + 1) / 2;
+                first = victim.end;
+            }
+
+            Worker& worker = *workers[thief];
+            std::lock_guard<std::mutex> guard(worker.lock);
+            worker.begin = first;
+            worker.end = last;
+            worker.steals++;
+            return true;
+        }
+
+        return false;
+    }
+
+    template <typename Timing>
+    void BasicBatchRunner<Timing>::RunJob(Arena& arena, const BatchJob& job,
+                                          BatchResult& result) {
+        static const std::array<Byte, Memory::PAGE_SIZE> ZERO_PAGE{};
+
+        Memory& memory = arena.memory;
+        BasicCPU<Memory, Timing>& cpu = arena.cpu;
+
+        // Back to all zeros, touching only the pages the last job wrote
+        const Byte* dirty = memory.DirtyPageList();
+        for (std::size_t i = 0; i < memory.DirtyPageCount(); i++) {
+            memory.RestorePage(dirty[i], ZERO_PAGE.data());
+        }
+        memory.ClearDirtyPages();
+
+        result.final = job.initial;
+        result.cycles = 0;
+        result.halted = false;
+        result.output.clear();
+
+        result.loaded = memory.LoadProgram(job.loadAddress, job.image, job.imageSize);
+        if (!result.loaded) {
+            return;
+        }
+
+        // A fresh CPU: no TotalCycles, no interrupt lines left over
+        cpu = BasicCPU<Memory, Timing>();
+        cpu.A = job.initial.A;
+        cpu.X = job.initial.X;
+        cpu.Y = job.initial.Y;
+        cpu.SP = job.initial.SP;
+        cpu.P = job.initial.P;
+        cpu.PC = job.initial.PC;
+
+        if (job.stopAtHalt) {
+            const Address halt = job.haltAddress;
+            result.cycles = cpu.RunUntil(memory, job.budget,
+                [halt](const BasicCPU<Memory, Timing>& state) { return state.PC == halt; });
+            result.halted = cpu.PC == halt;
+        } else {
+            result.cycles = cpu.RunFor(job.budget, memory);
+        }
+
+        result.final.A = cpu.A;
+        result.final.X = cpu.X;
+        result.final.Y = cpu.Y;
+        result.final.SP = cpu.SP;
+        result.final.P = cpu.P;
+        result.final.PC = cpu.PC;
+
+        if (job.outputSize != 0) {
+            const Memory& view = memory;
+            std::size_t size = std::min<std::size_t>(job.outputSize, MEMORY_SIZE - job.outputAddress);
+            const Byte* first = &view[job.outputAddress];
+            result.output.assign(first, first + size);
+        }
+    }
+
+    // Explicit instantiations for both timing policies
+    template class BasicBatchRunner<CycleAccurate>;
+    template class BasicBatchRunner<Functional>;
+
+} // namespace M6502
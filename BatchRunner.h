@@ -0,0 +1,157 @@
+/**
+ * @file BatchRunner.h
+ * @brief Runs many independent CPU + Memory instances across a thread pool
+ */
+
+#ifndef M6502_BATCH_RUNNER_H
+#define M6502_BATCH_RUNNER_H
+
+#include "Constants.h"
+#include "CPU.h"
+#include "Memory.h"
+#include "Timing.h"
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace M6502 {
+
+    /**
+     * @brief Register file at the start or end of a batch job
+     */
+    struct BatchRegisters {
+        Byte A = 0;
+        Byte X = 0;
+        Byte Y = 0;
+        Byte SP = STACK_POINTER_RESET;
+        Byte P = FLAG_UNUSED | FLAG_INTERRUPT;
+        Word PC = 0;
+    };
+
+    /**
+     * @brief One program to run: an image, its starting registers and a budget
+     *
+     * Memory starts all zero with `imageSize` bytes of `image` copied to
+     * `loadAddress`. The image is only read, so many jobs can share one.
+     */
+    struct BatchJob {
+        const Byte* image = nullptr;    ///< Owned by the caller for the whole run
+        std::size_t imageSize = 0;
+        Address loadAddress = 0;
+
+        BatchRegisters initial;
+
+        /// Cycles (functional runner: instructions) before the job is stopped
+        Cycles budget = 0;
+
+        /// Stop as soon as PC reaches haltAddress (e.g. a JMP-to-self)
+        bool stopAtHalt = false;
+        Address haltAddress = 0;
+
+        /// Memory copied into BatchResult::output when the job ends
+        Address outputAddress = 0;
+        std::size_t outputSize = 0;
+    };
+
+    struct BatchResult {
+        BatchRegisters final;
+        Cycles cycles = 0;      ///< Cycles (functional runner: instructions) executed
+        bool halted = false;    ///< Reached haltAddress within the budget
+        bool loaded = false;    ///< False if the image did not fit; nothing was run
+        std::vector<Byte> output;
+    };
+
+    /**
+     * @brief Work-stealing pool that runs BatchJobs to completion
+     *
+     * Each worker owns an arena holding its CPU and 64 KiB Memory,
+     * allocated once when the pool starts. Starting a job reuses them:
+     * only the pages the previous job wrote are cleared back to zero
+     * (Memory's dirty-page list tells which), so an instance costs no
+     * allocation and usually far less than a 64 KiB clear.
+     *
+     * Run() splits the jobs into one contiguous range per worker. A
+     * worker takes jobs from the front of its own range; when that is
+     * empty it steals the back half of the next range that still has
+     * jobs. Jobs are independent, so results depend only on the job,
+     * never on which worker ran it or in what order.
+     *
+     * The calling thread works as worker 0 during Run(). One Run() at a
+     * time per runner.
+     */
+    template <typename Timing = CycleAccurate>
+    class BasicBatchRunner {
+    public:
+        /**
+         * @param threads Workers including the caller; 0 means one per hardware thread
+         */
+        explicit BasicBatchRunner(std::size_t threads = 0);
+        ~BasicBatchRunner();
+
+        BasicBatchRunner(const BasicBatchRunner&) = delete;
+        BasicBatchRunner& operator=(const BasicBatchRunner&) = delete;
+
+        /**
+         * @brief Run every job and return the results in job order
+         */
+        std::vector<BatchResult> Run(const std::vector<BatchJob>& jobs);
+
+        /**
+         * @brief Run `count` jobs into `results` (same order, caller-owned)
+         */
+        void Run(const BatchJob* jobs, std::size_t count, BatchResult* results);
+
+        std::size_t ThreadCount() const { return workers.size(); }
+
+        /// Ranges taken from another worker during the last Run()
+        std::uint64_t Steals() const;
+
+    private:
+        struct Arena {
+            BasicCPU<Memory, Timing> cpu;
+            Memory memory;
+        };
+
+        // Padded to a cache line so neighbouring workers' ranges do not
+        // share one
+        struct alignas(64) Worker {
+            std::mutex lock;
+            std::size_t begin = 0;   ///< Next job this worker will take
+            std::size_t end = 0;     ///< One past its last job
+            std::uint64_t steals = 0;
+            std::unique_ptr<Arena> arena;
+        };
+
+        void WorkerLoop(std::size_t index);
+        void Drain(std::size_t index);
+        bool TakeJob(std::size_t index, std::size_t& job);
+        bool Steal(std::size_t thief);
+        void RunJob(Arena& arena, const BatchJob& job, BatchResult& result);
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::vector<std::thread> threads;
+
+        // Current batch, published to the workers under `control`
+        const BatchJob* jobs;
+        BatchResult* results;
+
+        std::mutex control;
+        std::condition_variable wake;
+        std::condition_variable done;
+        std::uint64_t generation;
+        std::size_t busy;
+        bool stopping;
+    };
+
+    using BatchRunner = BasicBatchRunner<CycleAccurate>;
+    using FunctionalBatchRunner = BasicBatchRunner<Functional>;
+
+    extern template class BasicBatchRunner<CycleAccurate>;
+    extern template class BasicBatchRunner<Functional>;
+
+} // namespace M6502
+
+#endif // M6502_BATCH_RUNNER_H
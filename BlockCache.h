@@ -0,0 +1,195 @@
+/**
+ * @file BlockCache.h
+ * @brief Cache of translated basic blocks
+ */
+
+#ifndef M6502_BLOCK_CACHE_H
+#define M6502_BLOCK_CACHE_H
+
+#include "Constants.h"
+#include "CodeObserver.h"
+#include "Timing.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace M6502 {
+
+    template <typename Bus, typename Timing>
+    class BasicCPU;
+
+    /**
+     * @brief Straight-line runs of guest code translated to micro-ops
+     *
+     * Used with BasicCPU::RunFor(budget, bus, blocks). A block starts at
+     * the address it was first entered at and runs up to and including
+     * the next branch, JMP, JSR, RTS, RTI or BRK (or MAX_BLOCK_INSTRUCTIONS
+     * instructions, or the edge of an I/O page). Each instruction becomes a
+     * micro-op with its handler and operand already bound, and the block
+     * keeps the total of its opcode/operand fetch cycles so they are
+     * charged once per dispatch.
+     *
+     * Like DecodeCache, the cache registers itself as the bus's code
+     * observer and watches every page its blocks cover. A write to a
+     * watched page drops every block containing the written byte; a
+     * block that overwrites itself stops after the writing instruction.
+     * Only one code cache can be attached to a bus at a time.
+     *
+     * Micro-ops hold handlers of one core, so the cache takes the same
+     * timing policy as the CPU that runs it.
+     *
+     * Writes that bypass the bus are not seen; call Flush() after them.
+     */
+    template <typename Bus, typename Timing = CycleAccurate>
+    class BlockCache : public CodeObserver {
+    public:
+        static constexpr std::size_t MAX_BLOCK_INSTRUCTIONS = 32;
+
+        explicit BlockCache(Bus& memory)
+            : memory(memory), slots(MEMORY_SIZE) {
+            memory.SetCodeObserver(this);
+            ResetStatistics();
+        }
+
+        ~BlockCache() {
+            memory.SetCodeObserver(nullptr);
+        }
+
+        BlockCache(const BlockCache&) = delete;
+        BlockCache& operator=(const BlockCache&) = delete;
+
+        /**
+         * @brief Drop every translated block
+         */
+        void Flush() {
+            for (auto& block : slots) {
+                if (block != nullptr && block->valid) {
+                    Invalidate(*block);
+                }
+            }
+        }
+
+        /// Block dispatches served from the cache
+        std::uint64_t Hits() const { return hits; }
+
+        /// Dispatches that had to translate (or could not be cached)
+        std::uint64_t Misses() const { return misses; }
+
+        /// Blocks dropped because their bytes were written or remapped
+        std::uint64_t Invalidations() const { return invalidations; }
+
+        void ResetStatistics() {
+            hits = 0;
+            misses = 0;
+            invalidations = 0;
+        }
+
+        void OnCodeWrite(Address address) override {
+            // Collect first: invalidating edits the page lists
+            std::vector<Address>& candidates = pageBlocks[address >> 8];
+            victims.clear();
+            for (Address start : candidates) {
+                if (static_cast<Address>(address - start) < slots[start]->size) {
+                    victims.push_back(start);
+                }
+            }
+            for (Address start : victims) {
+                Invalidate(*slots[start]);
+            }
+        }
+
+        void OnCodePageChanged(Byte page) override {
+            victims = pageBlocks[page];
+            for (Address start : victims) {
+                Invalidate(*slots[start]);
+            }
+        }
+
+    private:
+        friend class BasicCPU<Bus, Timing>;
+
+        using Handler = void (BasicCPU<Bus, Timing>::*)(Bus&, typename Timing::Counter&, Word);
+
+        struct MicroOp {
+            Handler handler;
+            Word operand;
+            Byte length;    ///< Bytes fetched, which is also the fetch cycle cost
+        };
+
+        struct Block {
+            std::vector<MicroOp> ops;
+            Address start = 0;
+            Word size = 0;                  ///< Bytes covered
+            Cycles staticCycles = 0;        ///< Sum of the ops' fetch cycles
+            Cycles worstCaseCycles = 0;     ///< Upper bound for the whole block
+            bool valid = false;
+        };
+
+        /**
+         * @brief Slot for a block starting at `start`, reused across translations
+         */
+        Block& Slot(Address start) {
+            std::unique_ptr<Block>& slot = slots[start];
+            if (slot == nullptr) {
+                slot = std::make_unique<Block>();
+            }
+            return *slot;
+        }
+
+        /**
+         * @brief Mark a freshly translated block valid and start watching it
+         */
+        void Register(Block& block) {
+            block.valid = true;
+
+            Byte firstPage = block.start >> 8;
+            Byte lastPage = static_cast<Address>(block.start + block.size - 1) >> 8;
+            for (Byte page = firstPage; ; page++) {
+                pageBlocks[page].push_back(block.start);
+                memory.WatchCodePage(page);
+                if (page == lastPage) {
+                    break;
+                }
+            }
+        }
+
+        void Invalidate(Block& block) {
+            block.valid = false;
+            invalidations++;
+
+            Byte firstPage = block.start >> 8;
+            Byte lastPage = static_cast<Address>(block.start + block.size - 1) >> 8;
+            for (Byte page = firstPage; ; page++) {
+                std::vector<Address>& list = pageBlocks[page];
+                for (std::size_t i = 0; i < list.size(); i++) {
+                    if (list[i] == block.start) {
+                        list[i] = list.back();
+                        list.pop_back();
+                        break;
+                    }
+                }
+                if (page == lastPage) {
+                    break;
+                }
+            }
+        }
+
+        Bus& memory;
+
+        // Indexed by start address; a slot's storage is kept when its block
+        // is invalidated so a block never disappears while it is running
+        std::vector<std::unique_ptr<Block>> slots;
+
+        // Start addresses of the valid blocks touching each page
+        std::array<std::vector<Address>, 256> pageBlocks;
+        std::vector<Address> victims;
+
+        std::uint64_t hits;
+        std::uint64_t misses;
+        std::uint64_t invalidations;
+    };
+
+} // namespace M6502
+
+#endif // M6502_BLOCK_CACHE_H
@@ -4,22 +4,40 @@
  */
 
 #include "CPU.h"
+#include "Decimal.h"
+#include "Profiler.h"
+#include "Snapshot.h"
 #include <stdexcept>
 
 namespace M6502 {
 
-    CPU::CPU() {
+    template <typename Bus, typename Timing>
+    BasicCPU<Bus, Timing>::BasicCPU() {
         // Initialize all registers to zero
         A = X = Y = 0;
         PC = 0;
         SP = 0;
         P = 0;
         TotalCycles = 0;
+
+        // All interrupt inputs released
+        pendingInterrupts = 0;
+        nmiLine = false;
+
+        profiler = nullptr;
+        debugger = nullptr;
+
+#if M6502_TRACE
+        trace = nullptr;
+#endif
     }
 
-    void CPU::Reset(Memory& memory) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::Reset(Bus& memory) {
+        Clock cycles{};
+
         // Reset program counter from reset vector
-        PC = memory.ReadWord(VECTOR_RESET, TotalCycles);
+        PC = memory.ReadWord(VECTOR_RESET, cycles);
         
         // Initialize stack pointer to top of stack
         SP = STACK_POINTER_RESET;
@@ -32,40 +50,58 @@ namespace M6502 {
         
         // Clear registers
         A = X = Y = 0;
+
+        // Reset discards a latched NMI; a held IRQ line stays asserted
+        pendingInterrupts &= ~NMI_LATCHED;
         
         // Reset takes 8 cycles on real hardware
-        TotalCycles += 6;  // We already consumed 2 cycles reading the vector
+        cycles += 6;  // We already consumed 2 cycles reading the vector
+        TotalCycles += Progress(cycles, 0);
     }
 
     // ====================================================================
-    // FLAG OPERATIONS
+    // SNAPSHOTS
     // ====================================================================
 
-    void CPU::SetFlag(StatusFlags flag, bool condition) {
-        if (condition) {
-            P |= flag;  // Set the flag bit
-        } else {
-            P &= ~flag; // Clear the flag bit
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::SaveState(SnapshotWriter& writer) const {
+        writer.WriteByte(A);
+        writer.WriteByte(X);
+        writer.WriteByte(Y);
+        writer.WriteByte(SP);
+        writer.WriteByte(P);
+        writer.WriteWord(PC);
+        writer.WriteQuad(TotalCycles);
+        writer.WriteByte(static_cast<Byte>(pendingInterrupts & ~(ATTACHMENTS | BATCH_END_REQUESTED)));
+        writer.WriteByte(nmiLine ? 1 : 0);
+    }
+
+    template <typename Bus, typename Timing>
+    bool BasicCPU<Bus, Timing>::LoadState(SnapshotReader& reader) {
+        Byte status, pending, line;
+        std::uint64_t total;
+        if (!reader.ReadByte(A) || !reader.ReadByte(X) || !reader.ReadByte(Y) ||
+            !reader.ReadByte(SP) || !reader.ReadByte(status) || !reader.ReadWord(PC) ||
+            !reader.ReadQuad(total) || !reader.ReadByte(pending) ||
+            !reader.ReadByte(line)) {
+            return false;
         }
-    }
 
-    bool CPU::GetFlag(StatusFlags flag) const {
-        return (P & flag) != 0;
-    }
-
-    void CPU::UpdateZeroAndNegativeFlags(Byte value) {
-        // Zero flag: set if value is 0
-        SetFlag(FLAG_ZERO, value == 0);
-        
-        // Negative flag: set if bit 7 is set (value >= 128)
-        SetFlag(FLAG_NEGATIVE, (value & 0x80) != 0);
+        // An attached profiler or armed debugger stays so
+        pendingInterrupts = static_cast<Byte>((pending & ~(ATTACHMENTS | BATCH_END_REQUESTED)) |
+                                              (pendingInterrupts & ATTACHMENTS));
+        P = status;
+        TotalCycles = total;
+        nmiLine = line != 0;
+        return true;
     }
 
     // ====================================================================
     // STACK OPERATIONS
     // ====================================================================
 
-    void CPU::PushByteToStack(Memory& memory, Byte value, Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::PushByteToStack(Bus& memory, Byte value, Clock& cycles) {
         // Stack is at $0100 + SP
         Address stackAddress = STACK_BASE + SP;
         memory.WriteByte(stackAddress, value, cycles);
@@ -74,14 +110,16 @@ namespace M6502 {
         SP--;
     }
 
-    void CPU::PushWordToStack(Memory& memory, Word value, Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::PushWordToStack(Bus& memory, Word value, Clock& cycles) {
         // Push high byte first (stack grows downward)
         PushByteToStack(memory, (value >> 8) & 0xFF, cycles);
         // Then push low byte
         PushByteToStack(memory, value & 0xFF, cycles);
     }
 
-    Byte CPU::PopByteFromStack(Memory& memory, Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    Byte BasicCPU<Bus, Timing>::PopByteFromStack(Bus& memory, Clock& cycles) {
         // Increment SP first (stack grows downward)
         SP++;
         
@@ -90,7 +128,8 @@ namespace M6502 {
         return memory.ReadByte(stackAddress, cycles);
     }
 
-    Word CPU::PopWordFromStack(Memory& memory, Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    Word BasicCPU<Bus, Timing>::PopWordFromStack(Bus& memory, Clock& cycles) {
         // Pop low byte first
         Byte lowByte = PopByteFromStack(memory, cycles);
         // Then pop high byte
@@ -104,13 +143,15 @@ namespace M6502 {
     // MEMORY ACCESS HELPERS
     // ====================================================================
 
-    Byte CPU::FetchByte(Memory& memory, Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    Byte BasicCPU<Bus, Timing>::FetchByte(Bus& memory, Clock& cycles) {
         Byte value = memory.ReadByte(PC, cycles);
         PC++;
         return value;
     }
 
-    Word CPU::FetchWord(Memory& memory, Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    Word BasicCPU<Bus, Timing>::FetchWord(Bus& memory, Clock& cycles) {
         // 6502 is little-endian
         Word value = memory.ReadWord(PC, cycles);
         PC += 2;
@@ -120,8 +161,14 @@ namespace M6502 {
     // ====================================================================
     // ADDRESSING MODES
     // ====================================================================
-
-    Address CPU::AddrImmediate(Memory& /* memory */, Cycles& cycles) {
+    //
+    // Each mode fetches its operand bytes and hands them to a Resolve*
+    // helper that does the rest (indexing, pointer reads, page-cross
+    // cycles). The decode cache stores operands and calls the same
+    // Resolve* helpers, so both paths share one implementation.
+
+    template <typename Bus, typename Timing>
+    Address BasicCPU<Bus, Timing>::AddrImmediate(Bus& /* memory */, Clock& cycles) {
         // Immediate: operand is the next byte after opcode
         // Return PC and increment it
         Address address = PC;
@@ -130,63 +177,83 @@ namespace M6502 {
         return address;
     }
 
-    Address CPU::AddrZeroPage(Memory& memory, Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    Address BasicCPU<Bus, Timing>::AddrZeroPage(Bus& memory, Clock& cycles) {
         // Zero page: next byte is address in page 0 ($00XX)
         Byte zpAddress = FetchByte(memory, cycles);
         return static_cast<Address>(zpAddress);
     }
 
-    Address CPU::AddrZeroPageX(Memory& memory, Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    Address BasicCPU<Bus, Timing>::AddrZeroPageX(Bus& memory, Clock& cycles) {
         // Zero page indexed by X: wraps within page 0
         Byte zpAddress = FetchByte(memory, cycles);
-        
-        // Add X register (wraps around in zero page)
-        Byte finalAddress = zpAddress + X;
-        
-        // Extra cycle for adding index
-        cycles++;
-        
-        return static_cast<Address>(finalAddress);
+        return ResolveZeroPageIndexed(zpAddress, X, cycles);
     }
 
-    Address CPU::AddrZeroPageY(Memory& memory, Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    Address BasicCPU<Bus, Timing>::AddrZeroPageY(Bus& memory, Clock& cycles) {
         // Zero page indexed by Y: wraps within page 0
         Byte zpAddress = FetchByte(memory, cycles);
-        
-        // Add Y register (wraps around in zero page)
-        Byte finalAddress = zpAddress + Y;
-        
-        // Extra cycle for adding index
-        cycles++;
-        
-        return static_cast<Address>(finalAddress);
+        return ResolveZeroPageIndexed(zpAddress, Y, cycles);
     }
 
-    Address CPU::AddrAbsolute(Memory& memory, Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    Address BasicCPU<Bus, Timing>::AddrAbsolute(Bus& memory, Clock& cycles) {
         // Absolute: next two bytes form 16-bit address
         return FetchWord(memory, cycles);
     }
 
-    Address CPU::AddrAbsoluteX(Memory& memory, Cycles& cycles, bool addCycleOnPageCross) {
+    template <typename Bus, typename Timing>
+    Address BasicCPU<Bus, Timing>::AddrAbsoluteX(Bus& memory, Clock& cycles, bool addCycleOnPageCross) {
         // Absolute indexed by X
         Address baseAddress = FetchWord(memory, cycles);
-        Address finalAddress = baseAddress + X;
-        
-        // Check if page boundary was crossed
-        if (addCycleOnPageCross) {
-            // Page boundary crossed if high byte changed
-            if ((baseAddress & 0xFF00) != (finalAddress & 0xFF00)) {
-                cycles++;
-            }
-        }
-        
-        return finalAddress;
+        return ResolveAbsoluteIndexed(baseAddress, X, cycles, addCycleOnPageCross);
     }
 
-    Address CPU::AddrAbsoluteY(Memory& memory, Cycles& cycles, bool addCycleOnPageCross) {
+    template <typename Bus, typename Timing>
+    Address BasicCPU<Bus, Timing>::AddrAbsoluteY(Bus& memory, Clock& cycles, bool addCycleOnPageCross) {
         // Absolute indexed by Y
         Address baseAddress = FetchWord(memory, cycles);
-        Address finalAddress = baseAddress + Y;
+        return ResolveAbsoluteIndexed(baseAddress, Y, cycles, addCycleOnPageCross);
+    }
+
+    template <typename Bus, typename Timing>
+    Address BasicCPU<Bus, Timing>::AddrIndirect(Bus& memory, Clock& cycles) {
+        // Indirect: ($ABCD) - only used by JMP
+        Address indirectAddr = FetchWord(memory, cycles);
+        return ResolveIndirect(memory, cycles, indirectAddr);
+    }
+
+    template <typename Bus, typename Timing>
+    Address BasicCPU<Bus, Timing>::AddrIndexedIndirect(Bus& memory, Clock& cycles) {
+        // Indexed Indirect: ($ZP,X)
+        Byte zpAddress = FetchByte(memory, cycles);
+        return ResolveIndexedIndirect(memory, cycles, zpAddress);
+    }
+
+    template <typename Bus, typename Timing>
+    Address BasicCPU<Bus, Timing>::AddrIndirectIndexed(Bus& memory, Clock& cycles, bool addCycleOnPageCross) {
+        // Indirect Indexed: ($ZP),Y
+        Byte zpAddress = FetchByte(memory, cycles);
+        return ResolveIndirectIndexed(memory, cycles, zpAddress, addCycleOnPageCross);
+    }
+
+    template <typename Bus, typename Timing>
+    Address BasicCPU<Bus, Timing>::ResolveZeroPageIndexed(Byte zpAddress, Byte index, Clock& cycles) {
+        // Add index register (wraps around in zero page)
+        Byte finalAddress = zpAddress + index;
+        
+        // Extra cycle for adding index
+        cycles++;
+        
+        return static_cast<Address>(finalAddress);
+    }
+
+    template <typename Bus, typename Timing>
+    Address BasicCPU<Bus, Timing>::ResolveAbsoluteIndexed(Address baseAddress, Byte index, Clock& cycles,
+                                                  bool addCycleOnPageCross) {
+        Address finalAddress = baseAddress + index;
         
         // Check if page boundary was crossed
         if (addCycleOnPageCross) {
@@ -199,12 +266,23 @@ namespace M6502 {
         return finalAddress;
     }
 
-    Address CPU::AddrIndexedIndirect(Memory& memory, Cycles& cycles) {
-        // Indexed Indirect: ($ZP,X)
+    template <typename Bus, typename Timing>
+    Address BasicCPU<Bus, Timing>::ResolveIndirect(Bus& memory, Clock& cycles, Address indirectAddr) {
+        // Note: 6502 has a bug with indirect JMP across page boundaries
+        // If address is $xxFF, the high byte is read from $xx00
+        if ((indirectAddr & 0x00FF) == 0x00FF) {
+            Byte lowByte = memory.ReadByte(indirectAddr, cycles);
+            Byte highByte = memory.ReadByte(indirectAddr & 0xFF00, cycles);
+            return (static_cast<Address>(highByte) << 8) | lowByte;
+        }
+
+        return memory.ReadWord(indirectAddr, cycles);
+    }
+
+    template <typename Bus, typename Timing>
+    Address BasicCPU<Bus, Timing>::ResolveIndexedIndirect(Bus& memory, Clock& cycles, Byte zpAddress) {
         // Add X to zero page address, then read 16-bit address from there
         
-        Byte zpAddress = FetchByte(memory, cycles);
-        
         // Add X (wraps in zero page)
         Byte finalZpAddress = zpAddress + X;
         
@@ -218,62 +296,58 @@ namespace M6502 {
         return (static_cast<Address>(highByte) << 8) | lowByte;
     }
 
-    Address CPU::AddrIndirectIndexed(Memory& memory, Cycles& cycles, bool addCycleOnPageCross) {
-        // Indirect Indexed: ($ZP),Y
+    template <typename Bus, typename Timing>
+    Address BasicCPU<Bus, Timing>::ResolveIndirectIndexed(Bus& memory, Clock& cycles, Byte zpAddress,
+                                                  bool addCycleOnPageCross) {
         // Read 16-bit address from zero page, then add Y
         
-        Byte zpAddress = FetchByte(memory, cycles);
-        
         // Read 16-bit base address from zero page
         Byte lowByte = memory.ReadByte(zpAddress, cycles);
         Byte highByte = memory.ReadByte((zpAddress + 1) & 0xFF, cycles);
         
         Address baseAddress = (static_cast<Address>(highByte) << 8) | lowByte;
-        Address finalAddress = baseAddress + Y;
-        
-        // Check for page boundary crossing
-        if (addCycleOnPageCross) {
-            if ((baseAddress & 0xFF00) != (finalAddress & 0xFF00)) {
-                cycles++;
-            }
-        }
-        
-        return finalAddress;
+        return ResolveAbsoluteIndexed(baseAddress, Y, cycles, addCycleOnPageCross);
     }
 
     // ====================================================================
     // LOAD/STORE INSTRUCTIONS
     // ====================================================================
 
-    void CPU::LDA(Memory& memory, Cycles& cycles, Address address) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::LDA(Bus& memory, Clock& cycles, Address address) {
         // Load Accumulator from memory
         A = memory.ReadByte(address, cycles);
         UpdateZeroAndNegativeFlags(A);
     }
 
-    void CPU::LDX(Memory& memory, Cycles& cycles, Address address) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::LDX(Bus& memory, Clock& cycles, Address address) {
         // Load X register from memory
         X = memory.ReadByte(address, cycles);
         UpdateZeroAndNegativeFlags(X);
     }
 
-    void CPU::LDY(Memory& memory, Cycles& cycles, Address address) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::LDY(Bus& memory, Clock& cycles, Address address) {
         // Load Y register from memory
         Y = memory.ReadByte(address, cycles);
         UpdateZeroAndNegativeFlags(Y);
     }
 
-    void CPU::STA(Memory& memory, Cycles& cycles, Address address) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::STA(Bus& memory, Clock& cycles, Address address) {
         // Store Accumulator to memory
         memory.WriteByte(address, A, cycles);
     }
 
-    void CPU::STX(Memory& memory, Cycles& cycles, Address address) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::STX(Bus& memory, Clock& cycles, Address address) {
         // Store X register to memory
         memory.WriteByte(address, X, cycles);
     }
 
-    void CPU::STY(Memory& memory, Cycles& cycles, Address address) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::STY(Bus& memory, Clock& cycles, Address address) {
         // Store Y register to memory
         memory.WriteByte(address, Y, cycles);
     }
@@ -282,42 +356,48 @@ namespace M6502 {
     // REGISTER TRANSFER INSTRUCTIONS
     // ====================================================================
 
-    void CPU::TAX(Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::TAX(Clock& cycles) {
         // Transfer A to X
         X = A;
         cycles++;
         UpdateZeroAndNegativeFlags(X);
     }
 
-    void CPU::TAY(Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::TAY(Clock& cycles) {
         // Transfer A to Y
         Y = A;
         cycles++;
         UpdateZeroAndNegativeFlags(Y);
     }
 
-    void CPU::TXA(Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::TXA(Clock& cycles) {
         // Transfer X to A
         A = X;
         cycles++;
         UpdateZeroAndNegativeFlags(A);
     }
 
-    void CPU::TYA(Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::TYA(Clock& cycles) {
         // Transfer Y to A
         A = Y;
         cycles++;
         UpdateZeroAndNegativeFlags(A);
     }
 
-    void CPU::TSX(Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::TSX(Clock& cycles) {
         // Transfer Stack Pointer to X
         X = SP;
         cycles++;
         UpdateZeroAndNegativeFlags(X);
     }
 
-    void CPU::TXS(Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::TXS(Clock& cycles) {
         // Transfer X to Stack Pointer
         SP = X;
         cycles++;
@@ -328,13 +408,15 @@ namespace M6502 {
     // STACK INSTRUCTIONS
     // ====================================================================
 
-    void CPU::PHA(Memory& memory, Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::PHA(Bus& memory, Clock& cycles) {
         // Push Accumulator onto stack
         cycles++; // Internal operation
         PushByteToStack(memory, A, cycles);
     }
 
-    void CPU::PHP(Memory& memory, Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::PHP(Bus& memory, Clock& cycles) {
         // Push Processor Status onto stack
         // Note: B and U flags are set when pushed
         cycles++; // Internal operation
@@ -342,14 +424,16 @@ namespace M6502 {
         PushByteToStack(memory, statusToStore, cycles);
     }
 
-    void CPU::PLA(Memory& memory, Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::PLA(Bus& memory, Clock& cycles) {
         // Pull Accumulator from stack
         cycles += 2; // Internal operations
         A = PopByteFromStack(memory, cycles);
         UpdateZeroAndNegativeFlags(A);
     }
 
-    void CPU::PLP(Memory& memory, Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::PLP(Bus& memory, Clock& cycles) {
         // Pull Processor Status from stack
         cycles += 2; // Internal operations
         P = PopByteFromStack(memory, cycles);
@@ -361,28 +445,32 @@ namespace M6502 {
     // LOGICAL INSTRUCTIONS
     // ====================================================================
 
-    void CPU::AND(Memory& memory, Cycles& cycles, Address address) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::AND(Bus& memory, Clock& cycles, Address address) {
         // Logical AND with accumulator
         Byte value = memory.ReadByte(address, cycles);
         A &= value;
         UpdateZeroAndNegativeFlags(A);
     }
 
-    void CPU::ORA(Memory& memory, Cycles& cycles, Address address) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::ORA(Bus& memory, Clock& cycles, Address address) {
         // Logical OR with accumulator
         Byte value = memory.ReadByte(address, cycles);
         A |= value;
         UpdateZeroAndNegativeFlags(A);
     }
 
-    void CPU::EOR(Memory& memory, Cycles& cycles, Address address) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::EOR(Bus& memory, Clock& cycles, Address address) {
         // Exclusive OR with accumulator
         Byte value = memory.ReadByte(address, cycles);
         A ^= value;
         UpdateZeroAndNegativeFlags(A);
     }
 
-    void CPU::BIT(Memory& memory, Cycles& cycles, Address address) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::BIT(Bus& memory, Clock& cycles, Address address) {
         // Test bits in memory with accumulator
         Byte value = memory.ReadByte(address, cycles);
         
@@ -400,11 +488,24 @@ namespace M6502 {
     // ARITHMETIC INSTRUCTIONS
     // ====================================================================
 
-    void CPU::ADC(Memory& memory, Cycles& cycles, Address address) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::ADC(Bus& memory, Clock& cycles, Address address) {
         // Add with Carry
         Byte operand = memory.ReadByte(address, cycles);
         
         if (GetFlag(FLAG_DECIMAL)) {
+#if M6502_BCD_TABLES
+            // BCD (Binary Coded Decimal) mode: one load from the
+            // precomputed table (Decimal.h)
+            const DecimalResult sum = DecimalAdd(A, operand, GetFlag(FLAG_CARRY));
+
+            SetFlag(FLAG_NEGATIVE, (sum.flags & FLAG_NEGATIVE) != 0);
+            SetFlag(FLAG_ZERO, (sum.flags & FLAG_ZERO) != 0);
+            SetFlag(FLAG_OVERFLOW, (sum.flags & FLAG_OVERFLOW) != 0);
+            SetFlag(FLAG_CARRY, (sum.flags & FLAG_CARRY) != 0);
+
+            A = sum.result;
+#else
             // BCD (Binary Coded Decimal) mode
             // Each nibble represents 0-9
             
@@ -435,6 +536,7 @@ namespace M6502 {
             SetFlag(FLAG_CARRY, sum > 0x99);
             
             A = sum & 0xFF;
+#endif
             
         } else {
             // Binary mode
@@ -453,12 +555,22 @@ namespace M6502 {
         }
     }
 
-    void CPU::SBC(Memory& memory, Cycles& cycles, Address address) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::SBC(Bus& memory, Clock& cycles, Address address) {
         // Subtract with Carry (borrow)
         // SBC is equivalent to ADC with inverted operand
         Byte operand = memory.ReadByte(address, cycles);
         
         if (GetFlag(FLAG_DECIMAL)) {
+#if M6502_BCD_TABLES
+            // BCD mode subtraction by table (Decimal.h); V is left unchanged
+            const DecimalResult diff = DecimalSubtract(A, operand, GetFlag(FLAG_CARRY));
+
+            // Carry (borrow) flag: clear if borrow occurred
+            SetFlag(FLAG_CARRY, (diff.flags & FLAG_CARRY) != 0);
+
+            A = diff.result;
+#else
             // BCD mode subtraction
             Word diff = (A & 0x0F) - (operand & 0x0F) - (GetFlag(FLAG_CARRY) ? 0 : 1);
             
@@ -478,6 +590,7 @@ namespace M6502 {
             SetFlag(FLAG_CARRY, (diff & 0x100) == 0);
             
             A = diff & 0xFF;
+#endif
             UpdateZeroAndNegativeFlags(A);
             
         } else {
@@ -496,7 +609,8 @@ namespace M6502 {
         }
     }
 
-    void CPU::CompareRegister(Byte regValue, Byte memValue) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::CompareRegister(Byte regValue, Byte memValue) {
         // Compare helper function used by CMP, CPX, CPY
         Word result = regValue - memValue;
         
@@ -510,19 +624,22 @@ namespace M6502 {
         SetFlag(FLAG_NEGATIVE, (result & 0x80) != 0);
     }
 
-    void CPU::CMP(Memory& memory, Cycles& cycles, Address address) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::CMP(Bus& memory, Clock& cycles, Address address) {
         // Compare Accumulator
         Byte value = memory.ReadByte(address, cycles);
         CompareRegister(A, value);
     }
 
-    void CPU::CPX(Memory& memory, Cycles& cycles, Address address) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::CPX(Bus& memory, Clock& cycles, Address address) {
         // Compare X register
         Byte value = memory.ReadByte(address, cycles);
         CompareRegister(X, value);
     }
 
-    void CPU::CPY(Memory& memory, Cycles& cycles, Address address) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::CPY(Bus& memory, Clock& cycles, Address address) {
         // Compare Y register
         Byte value = memory.ReadByte(address, cycles);
         CompareRegister(Y, value);
@@ -532,7 +649,8 @@ namespace M6502 {
     // INCREMENT/DECREMENT INSTRUCTIONS
     // ====================================================================
 
-    void CPU::INC(Memory& memory, Cycles& cycles, Address address) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::INC(Bus& memory, Clock& cycles, Address address) {
         // Increment memory
         Byte value = memory.ReadByte(address, cycles);
         value++;
@@ -541,21 +659,24 @@ namespace M6502 {
         UpdateZeroAndNegativeFlags(value);
     }
 
-    void CPU::INX(Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::INX(Clock& cycles) {
         // Increment X
         X++;
         cycles++;
         UpdateZeroAndNegativeFlags(X);
     }
 
-    void CPU::INY(Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::INY(Clock& cycles) {
         // Increment Y
         Y++;
         cycles++;
         UpdateZeroAndNegativeFlags(Y);
     }
 
-    void CPU::DEC(Memory& memory, Cycles& cycles, Address address) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::DEC(Bus& memory, Clock& cycles, Address address) {
         // Decrement memory
         Byte value = memory.ReadByte(address, cycles);
         value--;
@@ -564,14 +685,16 @@ namespace M6502 {
         UpdateZeroAndNegativeFlags(value);
     }
 
-    void CPU::DEX(Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::DEX(Clock& cycles) {
         // Decrement X
         X--;
         cycles++;
         UpdateZeroAndNegativeFlags(X);
     }
 
-    void CPU::DEY(Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::DEY(Clock& cycles) {
         // Decrement Y
         Y--;
         cycles++;
@@ -580,4 +703,10 @@ namespace M6502 {
 
     // Continue in next part...
 
+    // Each translation unit instantiates the members it defines
+    template class BasicCPU<Memory>;
+    template class BasicCPU<MemoryBus>;
+    template class BasicCPU<Memory, Functional>;
+    template class BasicCPU<MemoryBus, Functional>;
+
 } // namespace M6502
@@ -0,0 +1,637 @@
+/**
+ * @file CPU.h
+ * @brief Declaration of the 6502 CPU emulator
+ */
+
+#ifndef M6502_CPU_H
+#define M6502_CPU_H
+
+#include "Constants.h"
+#include "Memory.h"
+#include "MemoryBus.h"
+#include "StatusRegister.h"
+#include "Timing.h"
+#include <array>
+
+// Computed-goto dispatch is a GCC/Clang extension. Define
+// M6502_COMPUTED_GOTO=1 at build time to make RunFor() (and therefore
+// Execute(Cycles, Memory&)) use it; ExecuteThreaded() is available
+// whenever the compiler supports it.
+#if defined(__GNUC__) || defined(__clang__)
+    #define M6502_HAS_COMPUTED_GOTO 1
+#else
+    #define M6502_HAS_COMPUTED_GOTO 0
+#endif
+
+#ifndef M6502_COMPUTED_GOTO
+    #define M6502_COMPUTED_GOTO 0
+#endif
+
+// Execution tracing (Trace.h). With M6502_TRACE=1 the core gains
+// SetTrace() and can record every instruction into a TraceBuffer; left
+// at 0 none of it is compiled in. It changes the class layout, so every
+// translation unit must see the same value.
+#ifndef M6502_TRACE
+    #define M6502_TRACE 0
+#endif
+
+namespace M6502 {
+
+    template <typename Bus, typename Timing>
+    class DecodeCache;
+
+    class SnapshotWriter;
+    class SnapshotReader;
+    class TraceBuffer;
+    class Profiler;
+    class Debugger;
+
+    template <typename Bus, typename Timing>
+    class BlockCache;
+
+    /**
+     * @brief The thirteen 6502 addressing modes
+     */
+    enum class AddressingMode : Byte {
+        Implied,
+        Accumulator,
+        Immediate,
+        ZeroPage,
+        ZeroPageX,
+        ZeroPageY,
+        Relative,
+        Absolute,
+        AbsoluteX,
+        AbsoluteY,
+        Indirect,
+        IndexedIndirect,   // ($ZP,X)
+        IndirectIndexed    // ($ZP),Y
+    };
+
+    /**
+     * @brief Rockwell R650X/R651X compatible CPU core
+     *
+     * Registers are public so the host can inspect and set up state
+     * directly. Instructions are decoded through a 256-entry handler
+     * table built at compile time from OpcodeTable.h.
+     *
+     * The core is a template on the bus it runs against. Any type with
+     * Memory's access functions (ReadByte, WriteByte, ReadWord, WriteWord)
+     * works; the calls are resolved at compile time.
+     *
+     * The second parameter picks the timing policy (Timing.h). The
+     * default counts every cycle; Functional swaps the counter for one
+     * that does nothing, so the same instruction code runs with no cycle
+     * bookkeeping and budgets count instructions instead.
+     *
+     * Both buses are instantiated in the library with both policies;
+     * CPU and FunctionalCPU are the Memory versions.
+     */
+    template <typename Bus, typename Timing = CycleAccurate>
+    class BasicCPU {
+    public:
+        /// Cycle counter threaded through every helper and bus access
+        using Clock = typename Timing::Counter;
+
+        // Registers
+        Byte A;             ///< Accumulator
+        Byte X;             ///< X index register
+        Byte Y;             ///< Y index register
+        Word PC;            ///< Program counter
+        Byte SP;            ///< Stack pointer (offset into page 1)
+        StatusRegister P;   ///< Processor status (reads and assigns as a Byte)
+
+        Cycles TotalCycles; ///< Cycles (functional: instructions) since construction
+
+        BasicCPU();
+
+        /**
+         * @brief Load PC from the reset vector and reset registers
+         */
+        void Reset(Bus& memory);
+
+        /**
+         * @brief Execute a single instruction, or enter a pending interrupt
+         * @return Cycles used by the instruction (7 for an interrupt entry),
+         *         0 if a debugger stopped before it
+         */
+        Cycles Execute(Bus& memory);
+
+        /**
+         * @brief Execute instructions until at least `cycles` have elapsed
+         * @return Cycles actually executed (the last instruction may overshoot)
+         */
+        Cycles Execute(Cycles cycles, Bus& memory);
+
+        /**
+         * @brief Batched execution: run until at least `budget` cycles elapsed
+         *
+         * Produces the same final state as calling Execute(Memory&) in a
+         * loop, but keeps the cycle counter local to the batch and adds it
+         * to TotalCycles once, when the batch returns.
+         *
+         * @return Cycles executed (the last instruction may overshoot)
+         */
+        Cycles RunFor(Cycles budget, Bus& memory);
+
+        /**
+         * @brief RunFor() using predecoded instructions from `cache`
+         *
+         * Each PC is decoded once; later visits skip the opcode and operand
+         * fetches and go straight to the handler. Cycle counts and final
+         * state match RunFor(). Code on I/O pages is never cached and runs
+         * through the normal fetch path.
+         *
+         * @return Cycles executed (the last instruction may overshoot)
+         */
+        Cycles RunFor(Cycles budget, Bus& memory, DecodeCache<Bus, Timing>& cache);
+
+        /**
+         * @brief RunFor() executing translated basic blocks from `blocks`
+         *
+         * One dispatch runs a whole block, charging its fetch cycles in
+         * one step. Near the end of the budget the block is walked one
+         * instruction at a time so the batch stops exactly where RunFor()
+         * would. Cycle counts and final state match RunFor().
+         *
+         * @return Cycles executed (the last instruction may overshoot)
+         */
+        Cycles RunFor(Cycles budget, Bus& memory, BlockCache<Bus, Timing>& blocks);
+
+        /**
+         * @brief Batched execution that also stops when `stop(cpu)` is true
+         *
+         * The predicate is checked before every instruction, so it acts as
+         * a breakpoint: on return PC is the first instruction not executed.
+         * TotalCycles is only brought up to date when the batch returns.
+         *
+         * @return Cycles executed
+         */
+        template <typename Predicate>
+        Cycles RunUntil(Bus& memory, Cycles budget, Predicate stop);
+
+#if M6502_HAS_COMPUTED_GOTO
+        /**
+         * @brief Same contract as RunFor() using threaded (computed-goto)
+         *        dispatch instead of the handler table
+         */
+        Cycles ExecuteThreaded(Cycles cycles, Bus& memory);
+#endif
+
+        /**
+         * @brief Drive the IRQ input (level-triggered)
+         *
+         * While asserted, an IRQ is taken at every instruction boundary
+         * where the I flag is clear. The device keeps the line asserted
+         * until the handler acknowledges it.
+         */
+        void SetIRQ(bool asserted);
+
+        /**
+         * @brief Drive the NMI input (edge-triggered)
+         *
+         * A transition from released to asserted latches one NMI, taken at
+         * the next instruction boundary regardless of the I flag. Holding
+         * the line asserted does not retrigger it.
+         */
+        void SetNMI(bool asserted);
+
+        /**
+         * @brief Make the running batch return at the next instruction boundary
+         *
+         * For callbacks that run inside a batch, such as a device register
+         * write, and that need the host back sooner than the batch's
+         * budget: typically because they scheduled an event (Scheduler.h)
+         * that is due before the batch would end. The batch returns
+         * normally with the cycles executed so far. Every batch starts
+         * with the request cleared, so calling this between batches does
+         * nothing.
+         */
+        void EndBatch() { pendingInterrupts |= BATCH_END_REQUESTED; }
+
+        void SetFlag(StatusFlags flag, bool condition);
+        bool GetFlag(StatusFlags flag) const;
+
+        /**
+         * @brief Write registers, TotalCycles and interrupt inputs (see Snapshot.h)
+         */
+        void SaveState(SnapshotWriter& writer) const;
+
+        /**
+         * @brief Read back what SaveState() wrote
+         * @return false if the data ran out
+         */
+        bool LoadState(SnapshotReader& reader);
+
+        /**
+         * @brief Count every instruction into `profiler` (nullptr detaches)
+         *
+         * Works on any build. While a profiler is attached, threaded
+         * dispatch and the cached RunFor() overloads step through the
+         * plain interpreter instead, so every instruction is counted.
+         * Results are unchanged.
+         */
+        void SetProfiler(Profiler* profiler);
+
+        /**
+         * @brief Stop at `debugger`'s breakpoints and watchpoints (nullptr detaches)
+         *
+         * Debugger::Attach() calls this, and again whenever points are
+         * added, removed, enabled or disabled. While the debugger has no
+         * point enabled the CPU runs exactly as without one. While it
+         * has, every instruction steps through the plain interpreter, as
+         * with a profiler, and a breakpoint makes the batch return before
+         * the instruction at it.
+         */
+        void SetDebugger(Debugger* debugger);
+
+#if M6502_TRACE
+        /**
+         * @brief Record every instruction into `buffer` (nullptr stops tracing)
+         *
+         * Threaded dispatch writes the records itself and stays threaded.
+         * The cached RunFor() overloads step through the plain
+         * interpreter instead, so every instruction reaches the trace.
+         * Results are unchanged.
+         */
+        void SetTrace(TraceBuffer* buffer) { trace = buffer; }
+#endif
+
+        /**
+         * @brief True while a profiler, trace or armed debugger sees every instruction
+         *
+         * Anything that would skip instructions rather than run them
+         * (Scheduler::SetIdleSkip()) must not while this is true.
+         */
+        bool Observed() const { return Instrumented(); }
+
+    private:
+        /**
+         * @brief How far a batch has got, in the policy's budget unit
+         *
+         * The accurate core measures cycles and the step count is dead code;
+         * the functional core has no cycles and measures steps.
+         */
+        static Cycles Progress(const Clock& cycles, Cycles steps) {
+            if constexpr (Timing::COUNTS_CYCLES) {
+                return cycles;
+            } else {
+                return steps;
+            }
+        }
+
+        // Bits of pendingInterrupts
+        static constexpr Byte IRQ_ASSERTED = 0x01;
+        static constexpr Byte NMI_LATCHED = 0x02;
+        static constexpr Byte PROFILER_ATTACHED = 0x04;  ///< Not an interrupt; shares the poll
+        static constexpr Byte BATCH_END_REQUESTED = 0x08; ///< Not an interrupt; shares the poll
+        static constexpr Byte DEBUGGER_ARMED = 0x10;      ///< Not an interrupt; shares the poll
+
+        /// Host-side attachments, not machine state; snapshots leave them alone
+        static constexpr Byte ATTACHMENTS = PROFILER_ATTACHED | DEBUGGER_ARMED;
+
+        // Zero unless a line needs attention, a profiler is attached, a
+        // debugger is armed or a batch end was requested, so the
+        // per-instruction poll is one load and one branch
+        Byte pendingInterrupts;
+        bool nmiLine;
+
+        Profiler* profiler;
+        Debugger* debugger;
+
+#if M6502_TRACE
+        TraceBuffer* trace;
+#endif
+
+        /**
+         * @brief True if a profiler, trace or armed debugger wants to see every instruction
+         */
+        bool Instrumented() const {
+#if M6502_TRACE
+            return profiler != nullptr || trace != nullptr || (pendingInterrupts & DEBUGGER_ARMED) != 0;
+#else
+            return profiler != nullptr || (pendingInterrupts & DEBUGGER_ARMED) != 0;
+#endif
+        }
+
+        /**
+         * @brief Tell the debugger an instruction is next; true if it stops before it
+         */
+        bool DebuggerStops(Bus& memory);
+
+        /**
+         * @brief Step() that also reports the instruction to the profiler and
+         *        trace, and stops at the debugger's breakpoints
+         * @return false if the debugger stopped before the instruction
+         */
+        bool InstrumentedStep(Bus& memory, Clock& cycles);
+
+#if M6502_HAS_COMPUTED_GOTO
+        /**
+         * @brief ExecuteThreaded()'s loop, writing a TraceRecord per step if `Traced`
+         */
+        template <bool Traced>
+        Cycles RunThreaded(Cycles cycles, Bus& memory);
+#endif
+
+        /// True if `opcode` is a branch the current flags would take
+        bool BranchTaken(Byte opcode) const;
+
+        /**
+         * @brief True if `opcode`, about to run, will pay the page-cross cycle
+         *
+         * Worked out from the operand and the current X and Y, so the
+         * addressing helpers the uninstrumented paths share need no hook.
+         */
+        bool PaysPageCross(const Bus& memory, Byte opcode) const;
+
+        /**
+         * @brief Report the reads the next instruction (or interrupt entry) makes
+         *
+         * For Memory, whose ReadByte() leaves watching to the instrumented
+         * path (see Memory::ReadsWatched()). Called before the instruction
+         * runs, so watchers see the values it will read and the registers
+         * as they are before it.
+         */
+        void ReportWatchedReads(Memory& memory);
+
+        /**
+         * @brief True if a latched NMI or an unmasked IRQ should be taken now
+         */
+        bool InterruptDue() const;
+
+        /**
+         * @brief InterruptDue(), or a batch end was requested
+         *
+         * The block cache stops walking a block at the next boundary if so.
+         */
+        bool BoundaryDue() const;
+
+        /**
+         * @brief Take a due interrupt at an instruction boundary
+         * @return false if nothing was due (IRQ masked by the I flag)
+         */
+        bool ServiceInterrupt(Bus& memory, Clock& cycles);
+
+        void EnterInterrupt(Bus& memory, Clock& cycles, Address vector);
+
+        // Handler signatures used by the dispatch table
+        using Handler = void (BasicCPU::*)(Bus&, Clock&);
+        using MemoryOperation = void (BasicCPU::*)(Bus&, Clock&, Address);
+        using ImpliedOperation = void (BasicCPU::*)(Clock&);
+
+        static const std::array<Handler, 256> DispatchTable;
+        static constexpr std::array<Handler, 256> BuildDispatchTable();
+
+        /**
+         * @brief Fetch and execute one instruction, adding to `cycles`
+         *
+         * The batch engine's step: no local counter, no TotalCycles update.
+         *
+         * @return false, with nothing executed, if EndBatch() was called
+         */
+        bool Step(Bus& memory, Clock& cycles);
+
+        // Table entries: an addressing mode bound to an operation
+        template <AddressingMode Mode, bool PageCrossPenalty>
+        Address ResolveAddress(Bus& memory, Clock& cycles);
+
+        template <MemoryOperation Operation, AddressingMode Mode, bool PageCrossPenalty>
+        void ExecuteMemory(Bus& memory, Clock& cycles);
+
+        template <ImpliedOperation Operation>
+        void ExecuteImplied(Bus& memory, Clock& cycles);
+
+        template <StatusFlags Flag, bool Expected>
+        void ExecuteBranch(Bus& memory, Clock& cycles);
+
+        void ExecuteIllegal(Bus& memory, Clock& cycles);
+
+        // Predecoded handlers: the opcode and operand bytes were fetched
+        // when the instruction was cached, and PC already points past them
+        using DecodedHandler = void (BasicCPU::*)(Bus&, Clock&, Word operand);
+
+        struct DecodedInstruction {
+            DecodedHandler handler;
+            Byte length;    ///< Bytes fetched, which is also the fetch cycle cost
+            bool endsBlock; ///< Branch, jump, call, return or break
+        };
+
+        static const std::array<DecodedInstruction, 256> DecodeTable;
+        static constexpr std::array<DecodedInstruction, 256> BuildDecodeTable();
+        static constexpr Byte InstructionLength(AddressingMode mode);
+        static constexpr bool EndsBasicBlock(Byte opcode);
+
+        // Bus reads an instruction makes beyond its opcode and operand
+        // fetches, for ReportWatchedReads()
+        struct ReadPlan {
+            Byte length;            ///< Bytes fetched
+            AddressingMode mode;    ///< Pointer reads that resolving the operand makes
+            bool readsOperand;      ///< Reads its resolved address (not stores, JMP, JSR)
+            Byte pulls;             ///< Bytes pulled from the stack
+            bool readsBRKVector;
+        };
+
+        static const std::array<ReadPlan, 256> ReadPlans;
+        static constexpr std::array<ReadPlan, 256> BuildReadPlans();
+
+        /// Longest instruction (BRK); bounds a block's cycles
+        static constexpr Cycles MAX_INSTRUCTION_CYCLES = 7;
+
+        /**
+         * @brief Fill the cache entry for `address`
+         * @return false if the instruction touches an I/O page and cannot be cached
+         */
+        bool Decode(Bus& memory, DecodeCache<Bus, Timing>& cache, Address address);
+
+        /**
+         * @brief Translate the basic block starting at `address` into its slot
+         * @return false if its first instruction touches an I/O page
+         */
+        bool Translate(Bus& memory, BlockCache<Bus, Timing>& blocks, Address address);
+
+        template <AddressingMode Mode, bool PageCrossPenalty>
+        Address ResolveOperand(Bus& memory, Clock& cycles, Word operand);
+
+        template <MemoryOperation Operation, AddressingMode Mode, bool PageCrossPenalty>
+        void ExecuteDecodedMemory(Bus& memory, Clock& cycles, Word operand);
+
+        template <ImpliedOperation Operation>
+        void ExecuteDecodedImplied(Bus& memory, Clock& cycles, Word operand);
+
+        template <Handler Operation>
+        void ExecuteDecodedStack(Bus& memory, Clock& cycles, Word operand);
+
+        template <StatusFlags Flag, bool Expected>
+        void ExecuteDecodedBranch(Bus& memory, Clock& cycles, Word operand);
+
+        void ExecuteDecodedIllegal(Bus& memory, Clock& cycles, Word operand);
+
+        // Flag helpers
+        void UpdateZeroAndNegativeFlags(Byte value);
+
+        // Stack helpers
+        void PushByteToStack(Bus& memory, Byte value, Clock& cycles);
+        void PushWordToStack(Bus& memory, Word value, Clock& cycles);
+        Byte PopByteFromStack(Bus& memory, Clock& cycles);
+        Word PopWordFromStack(Bus& memory, Clock& cycles);
+
+        // Fetch helpers
+        Byte FetchByte(Bus& memory, Clock& cycles);
+        Word FetchWord(Bus& memory, Clock& cycles);
+
+        // Addressing modes
+        Address AddrImmediate(Bus& memory, Clock& cycles);
+        Address AddrZeroPage(Bus& memory, Clock& cycles);
+        Address AddrZeroPageX(Bus& memory, Clock& cycles);
+        Address AddrZeroPageY(Bus& memory, Clock& cycles);
+        Address AddrAbsolute(Bus& memory, Clock& cycles);
+        Address AddrAbsoluteX(Bus& memory, Clock& cycles, bool addCycleOnPageCross = true);
+        Address AddrAbsoluteY(Bus& memory, Clock& cycles, bool addCycleOnPageCross = true);
+        Address AddrIndirect(Bus& memory, Clock& cycles);
+        Address AddrIndexedIndirect(Bus& memory, Clock& cycles);
+        Address AddrIndirectIndexed(Bus& memory, Clock& cycles, bool addCycleOnPageCross = true);
+
+        // Operand resolution shared by the Addr* helpers and the decode cache
+        Address ResolveZeroPageIndexed(Byte zpAddress, Byte index, Clock& cycles);
+        Address ResolveAbsoluteIndexed(Address baseAddress, Byte index, Clock& cycles,
+                                       bool addCycleOnPageCross);
+        Address ResolveIndirect(Bus& memory, Clock& cycles, Address indirectAddr);
+        Address ResolveIndexedIndirect(Bus& memory, Clock& cycles, Byte zpAddress);
+        Address ResolveIndirectIndexed(Bus& memory, Clock& cycles, Byte zpAddress,
+                                       bool addCycleOnPageCross);
+
+        // Load/Store
+        void LDA(Bus& memory, Clock& cycles, Address address);
+        void LDX(Bus& memory, Clock& cycles, Address address);
+        void LDY(Bus& memory, Clock& cycles, Address address);
+        void STA(Bus& memory, Clock& cycles, Address address);
+        void STX(Bus& memory, Clock& cycles, Address address);
+        void STY(Bus& memory, Clock& cycles, Address address);
+
+        // Register transfers
+        void TAX(Clock& cycles);
+        void TAY(Clock& cycles);
+        void TXA(Clock& cycles);
+        void TYA(Clock& cycles);
+        void TSX(Clock& cycles);
+        void TXS(Clock& cycles);
+
+        // Stack
+        void PHA(Bus& memory, Clock& cycles);
+        void PHP(Bus& memory, Clock& cycles);
+        void PLA(Bus& memory, Clock& cycles);
+        void PLP(Bus& memory, Clock& cycles);
+
+        // Logical
+        void AND(Bus& memory, Clock& cycles, Address address);
+        void ORA(Bus& memory, Clock& cycles, Address address);
+        void EOR(Bus& memory, Clock& cycles, Address address);
+        void BIT(Bus& memory, Clock& cycles, Address address);
+
+        // Arithmetic
+        void ADC(Bus& memory, Clock& cycles, Address address);
+        void SBC(Bus& memory, Clock& cycles, Address address);
+        void CompareRegister(Byte regValue, Byte memValue);
+        void CMP(Bus& memory, Clock& cycles, Address address);
+        void CPX(Bus& memory, Clock& cycles, Address address);
+        void CPY(Bus& memory, Clock& cycles, Address address);
+
+        // Increment/Decrement
+        void INC(Bus& memory, Clock& cycles, Address address);
+        void INX(Clock& cycles);
+        void INY(Clock& cycles);
+        void DEC(Bus& memory, Clock& cycles, Address address);
+        void DEX(Clock& cycles);
+        void DEY(Clock& cycles);
+
+        // Shifts/Rotates
+        void ASL_ACC(Clock& cycles);
+        void ASL_MEM(Bus& memory, Clock& cycles, Address address);
+        void LSR_ACC(Clock& cycles);
+        void LSR_MEM(Bus& memory, Clock& cycles, Address address);
+        void ROL_ACC(Clock& cycles);
+        void ROL_MEM(Bus& memory, Clock& cycles, Address address);
+        void ROR_ACC(Clock& cycles);
+        void ROR_MEM(Bus& memory, Clock& cycles, Address address);
+
+        // Jumps/Branches
+        void JMP(Bus& memory, Clock& cycles, Address address);
+        void JSR(Bus& memory, Clock& cycles, Address address);
+        void RTS(Bus& memory, Clock& cycles);
+        void RTI(Bus& memory, Clock& cycles);
+        void BranchIf(Bus& memory, Clock& cycles, bool condition);
+        void TakeBranch(SignedByte offset, Clock& cycles);
+
+        // Flag instructions
+        void CLC(Clock& cycles);
+        void CLD(Clock& cycles);
+        void CLI(Clock& cycles);
+        void CLV(Clock& cycles);
+        void SEC(Clock& cycles);
+        void SED(Clock& cycles);
+        void SEI(Clock& cycles);
+
+        // System
+        void BRK(Bus& memory, Clock& cycles);
+        void NOP(Clock& cycles);
+    };
+
+    // ====================================================================
+    // FLAG OPERATIONS
+    // ====================================================================
+
+    // Defined here so both translation units inline them; with a constant
+    // flag each one compiles to a single store or load.
+
+    template <typename Bus, typename Timing>
+    inline void BasicCPU<Bus, Timing>::SetFlag(StatusFlags flag, bool condition) {
+        P.Set(flag, condition);
+    }
+
+    template <typename Bus, typename Timing>
+    inline bool BasicCPU<Bus, Timing>::GetFlag(StatusFlags flag) const {
+        return P.Get(flag);
+    }
+
+    template <typename Bus, typename Timing>
+    inline void BasicCPU<Bus, Timing>::UpdateZeroAndNegativeFlags(Byte value) {
+        // Z and N are derived from the value when P is next read
+        P.SetZeroAndNegative(value);
+    }
+
+    template <typename Bus, typename Timing>
+    template <typename Predicate>
+    Cycles BasicCPU<Bus, Timing>::RunUntil(Bus& memory, Cycles budget, Predicate stop) {
+        Clock cycles{};
+        Cycles steps = 0;
+        pendingInterrupts &= ~BATCH_END_REQUESTED;
+
+        while (Progress(cycles, steps) < budget && !stop(static_cast<const BasicCPU&>(*this))) {
+            if (!Step(memory, cycles)) {
+                break;
+            }
+            steps++;
+        }
+
+        // One commit per batch
+        Cycles elapsed = Progress(cycles, steps);
+        TotalCycles += elapsed;
+
+        return elapsed;
+    }
+
+    /// The CPU on the flat 64 KiB Memory, as used by main.cpp
+    using CPU = BasicCPU<Memory>;
+
+    /// Same core with no cycle bookkeeping, for state-only regression runs
+    using FunctionalCPU = BasicCPU<Memory, Functional>;
+
+    extern template class BasicCPU<Memory>;
+    extern template class BasicCPU<MemoryBus>;
+    extern template class BasicCPU<Memory, Functional>;
+    extern template class BasicCPU<MemoryBus, Functional>;
+
+} // namespace M6502
+
+#endif // M6502_CPU_H
@@ -0,0 +1,157 @@
+/**
+ * @file Checkpoint.cpp
+ * @brief Implementation of CheckpointChain
+ */
+
+#include "Checkpoint.h"
+#include "Snapshot.h"
+#include <cstring>
+
+namespace M6502 {
+
+    namespace {
+
+        // Pages that may have changed since the last checkpoint. Memory
+        // tracks them; on a MemoryBus every page is a candidate, and the
+        // byte compare sorts out the ones that really changed.
+
+        template <typename Visit>
+        void ForEachDirtyPage(const Memory& memory, Visit visit) {
+            const Byte* dirty = memory.DirtyPageList();
+            for (std::size_t i = 0; i < memory.DirtyPageCount(); i++) {
+                visit(dirty[i]);
+            }
+        }
+
+        template <typename Visit>
+        void ForEachDirtyPage(const MemoryBus& /* bus */, Visit visit) {
+            for (std::size_t page = 0; page < MemoryBus::PAGE_COUNT; page++) {
+                visit(static_cast<Byte>(page));
+            }
+        }
+
+        void ClearDirtyPages(Memory& memory) { memory.ClearDirtyPages(); }
+        void ClearDirtyPages(MemoryBus& /* bus */) {}
+
+    } // namespace
+
+    template <typename Bus, typename Timing>
+    std::size_t CheckpointChain::Take(const BasicCPU<Bus, Timing>& cpu, Bus& memory) {
+        const std::size_t index = checkpoints.size();
+        checkpoints.push_back({ static_cast<std::uint32_t>(pages.size()) });
+
+        auto store = [this](Byte page, const Byte* contents) {
+            pages.emplace_back();
+            std::memcpy(pages.back().data(), contents, Memory::PAGE_SIZE);
+            pageNumbers.push_back(page);
+            versions[page].push_back(static_cast<std::uint32_t>(pages.size() - 1));
+        };
+
+        if (index == 0) {
+            // The first checkpoint is the base every later one builds on
+            for (std::size_t page = 0; page < Memory::PAGE_COUNT; page++) {
+                store(static_cast<Byte>(page), memory.PageData(static_cast<Byte>(page)));
+            }
+        } else {
+            ForEachDirtyPage(memory, [&](Byte page) {
+                const Byte* contents = memory.PageData(page);
+
+                // Pages often get written back with the same bytes (loop
+                // counters, stack traffic); keep sharing the old copy
+                if (std::memcmp(contents, pages[versions[page].back()].data(),
+                                Memory::PAGE_SIZE) != 0) {
+                    store(page, contents);
+                }
+            });
+        }
+        ClearDirtyPages(memory);
+
+        SnapshotWriter writer(cpuStates);
+        cpu.SaveState(writer);
+        return index;
+    }
+
+    template <typename Bus, typename Timing>
+    bool CheckpointChain::Restore(std::size_t index, BasicCPU<Bus, Timing>& cpu, Bus& memory) {
+        if (index >= checkpoints.size()) {
+            return false;
+        }
+
+        // Pages that may differ from checkpoint `index`, each listed once
+        std::array<bool, Memory::PAGE_COUNT> stale{};
+        std::array<Byte, Memory::PAGE_COUNT> staleList;
+        std::size_t staleCount = 0;
+        auto markStale = [&](Byte page) {
+            if (!stale[page]) {
+                stale[page] = true;
+                staleList[staleCount++] = page;
+            }
+        };
+
+        // Written since the latest checkpoint
+        ForEachDirtyPage(memory, markStale);
+
+        // Stored by the checkpoints being dropped. Their pages are the
+        // newest versions, so each one is at the back of its list.
+        const std::size_t cut = index + 1 < checkpoints.size()
+            ? checkpoints[index + 1].firstPage : pages.size();
+        for (std::size_t i = pages.size(); i-- > cut;) {
+            Byte page = pageNumbers[i];
+            versions[page].pop_back();
+            markStale(page);
+        }
+
+        pages.resize(cut);
+        pageNumbers.resize(cut);
+        checkpoints.resize(index + 1);
+        cpuStates.resize((index + 1) * SNAPSHOT_CPU_STATE_SIZE);
+
+        // Skip pages already right, so a bus (every page stale) and
+        // its code caches only see the ones that changed
+        for (std::size_t i = 0; i < staleCount; i++) {
+            Byte page = staleList[i];
+            const Byte* contents = pages[versions[page].back()].data();
+            if (std::memcmp(memory.PageData(page), contents, Memory::PAGE_SIZE) != 0) {
+                memory.RestorePage(page, contents);
+            }
+        }
+        ClearDirtyPages(memory);
+
+        SnapshotReader reader(cpuStates.data() + index * SNAPSHOT_CPU_STATE_SIZE,
+                              SNAPSHOT_CPU_STATE_SIZE);
+        return cpu.LoadState(reader);
+    }
+
+    void CheckpointChain::Clear() {
+        checkpoints.clear();
+        pages.clear();
+        pageNumbers.clear();
+        for (auto& list : versions) {
+            list.clear();
+        }
+        cpuStates.clear();
+    }
+
+    std::size_t CheckpointChain::FootprintBytes() const {
+        std::size_t bytes = checkpoints.capacity() * sizeof(Checkpoint)
+                          + pages.capacity() * sizeof(PageContents)
+                          + pageNumbers.capacity()
+                          + cpuStates.capacity();
+        for (const auto& list : versions) {
+            bytes += list.capacity() * sizeof(std::uint32_t);
+        }
+        return bytes;
+    }
+
+    // Explicit instantiations for both buses and both timing policies
+    template std::size_t CheckpointChain::Take(const BasicCPU<Memory>&, Memory&);
+    template std::size_t CheckpointChain::Take(const BasicCPU<Memory, Functional>&, Memory&);
+    template bool CheckpointChain::Restore(std::size_t, BasicCPU<Memory>&, Memory&);
+    template bool CheckpointChain::Restore(std::size_t, BasicCPU<Memory, Functional>&, Memory&);
+    template std::size_t CheckpointChain::Take(const BasicCPU<MemoryBus>&, MemoryBus&);
+    template std::size_t CheckpointChain::Take(const BasicCPU<MemoryBus, Functional>&, MemoryBus&);
+    template bool CheckpointChain::Restore(std::size_t, BasicCPU<MemoryBus>&, MemoryBus&);
+    template bool CheckpointChain::Restore(std::size_t, BasicCPU<MemoryBus, Functional>&,
+                                           MemoryBus&);
+
+} // namespace M6502
@@ -0,0 +1,116 @@
+/**
+ * @file Checkpoint.h
+ * @brief Incremental in-memory checkpoints built on dirty-page tracking
+ */
+
+#ifndef M6502_CHECKPOINT_H
+#define M6502_CHECKPOINT_H
+
+#include "Constants.h"
+#include "CPU.h"
+#include "Memory.h"
+#include "MemoryBus.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace M6502 {
+
+    /**
+     * @brief A chain of checkpoints of one CPU and Memory or MemoryBus
+     *
+     * The first checkpoint stores all 256 pages. Each later one stores
+     * only the pages Memory reports dirty since the previous checkpoint,
+     * and skips those whose bytes did not actually change. Stored pages
+     * are never modified, so a page that stays the same is shared by
+     * every checkpoint after the one that stored it.
+     *
+     * Restore(n) rolls back to checkpoint n and drops the checkpoints
+     * after it. Only pages written since checkpoint n are copied back:
+     * the pages stored by the dropped checkpoints plus the ones dirtied
+     * since the last checkpoint. The cost is proportional to those pages,
+     * not to the size of memory.
+     *
+     * The chain relies on Memory's dirty flags, so every change to the
+     * memory between checkpoints must go through Memory itself (no
+     * direct writes to other copies), and only one chain may follow a
+     * Memory at a time. Take() clears the dirty flags.
+     *
+     * MemoryBus keeps no dirty flags, so its write path stays as it is;
+     * every page is compared against its stored copy instead, 64 KiB of
+     * memcmp per Take() or Restore(). The pages are what operator[]
+     * sees: RAM and ROM backing, and the internal RAM under I/O pages.
+     * Devices are not captured (see IORecorder).
+     */
+    class CheckpointChain {
+    public:
+        /**
+         * @brief Record the current state as a new checkpoint
+         * @return The new checkpoint's index
+         */
+        template <typename Bus, typename Timing>
+        std::size_t Take(const BasicCPU<Bus, Timing>& cpu, Bus& memory);
+
+        /**
+         * @brief Roll `cpu` and `memory` back to checkpoint `index`
+         *
+         * Checkpoints after `index` are discarded; `index` itself stays,
+         * so a run can be restarted from it any number of times.
+         *
+         * @return false if there is no such checkpoint
+         */
+        template <typename Bus, typename Timing>
+        bool Restore(std::size_t index, BasicCPU<Bus, Timing>& cpu, Bus& memory);
+
+        /**
+         * @brief Drop every checkpoint
+         */
+        void Clear();
+
+        std::size_t Count() const { return checkpoints.size(); }
+
+        /// Pages held across all checkpoints (256 of them are the first one)
+        std::size_t StoredPages() const { return pages.size(); }
+
+        /**
+         * @brief Heap bytes used by the chain's own storage
+         */
+        std::size_t FootprintBytes() const;
+
+    private:
+        using PageContents = std::array<Byte, Memory::PAGE_SIZE>;
+
+        struct Checkpoint {
+            std::uint32_t firstPage;    ///< Index in `pages` of the first page it stored
+        };
+
+        std::vector<Checkpoint> checkpoints;
+
+        // Stored pages in checkpoint order, with their page numbers.
+        // A checkpoint's pages run from its firstPage to the next one's.
+        std::vector<PageContents> pages;
+        std::vector<Byte> pageNumbers;
+
+        // For each page, indices into `pages` of its stored versions;
+        // back() is the page's contents at the latest checkpoint
+        std::array<std::vector<std::uint32_t>, Memory::PAGE_COUNT> versions;
+
+        // SaveState() output for each checkpoint, SNAPSHOT_CPU_STATE_SIZE apart
+        std::vector<Byte> cpuStates;
+    };
+
+    extern template std::size_t CheckpointChain::Take(const BasicCPU<Memory>&, Memory&);
+    extern template std::size_t CheckpointChain::Take(const BasicCPU<Memory, Functional>&, Memory&);
+    extern template bool CheckpointChain::Restore(std::size_t, BasicCPU<Memory>&, Memory&);
+    extern template bool CheckpointChain::Restore(std::size_t, BasicCPU<Memory, Functional>&,
+                                                  Memory&);
+    extern template std::size_t CheckpointChain::Take(const BasicCPU<MemoryBus>&, MemoryBus&);
+    extern template std::size_t CheckpointChain::Take(const BasicCPU<MemoryBus, Functional>&,
+                                                      MemoryBus&);
+    extern template bool CheckpointChain::Restore(std::size_t, BasicCPU<MemoryBus>&, MemoryBus&);
+    extern template bool CheckpointChain::Restore(std::size_t, BasicCPU<MemoryBus, Functional>&,
+                                                  MemoryBus&);
+
+} // namespace M6502
+
+#endif // M6502_CHECKPOINT_H
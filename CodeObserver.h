@@ -0,0 +1,39 @@
+/**
+ * @file CodeObserver.h
+ * @brief Notification interface for writes to pages holding cached code
+ */
+
+#ifndef M6502_CODE_OBSERVER_H
+#define M6502_CODE_OBSERVER_H
+
+#include "Constants.h"
+
+namespace M6502 {
+
+    /**
+     * @brief Receives writes to pages a code cache has asked to watch
+     *
+     * Memory and MemoryBus keep one flag per 256-byte page. A write to an
+     * unwatched page costs a single flag test; only writes to watched
+     * pages reach the observer. This keeps translated or predecoded code
+     * correct when the guest modifies itself.
+     */
+    class CodeObserver {
+    public:
+        /**
+         * @brief A byte in a watched page was written
+         */
+        virtual void OnCodeWrite(Address address) = 0;
+
+        /**
+         * @brief A watched page was remapped or bulk-modified; drop all of it
+         */
+        virtual void OnCodePageChanged(Byte page) = 0;
+
+    protected:
+        ~CodeObserver() = default;
+    };
+
+} // namespace M6502
+
+#endif // M6502_CODE_OBSERVER_H
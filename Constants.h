@@ -0,0 +1,264 @@
+/**
+ * @file Constants.h
+ * @brief Basic types, status flags, vectors and opcodes for the 6502 emulator
+ */
+
+#ifndef M6502_CONSTANTS_H
+#define M6502_CONSTANTS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace M6502 {
+
+    // ====================================================================
+    // BASIC TYPES
+    // ====================================================================
+
+    using Byte = std::uint8_t;        ///< 8-bit value
+    using SignedByte = std::int8_t;   ///< Signed 8-bit value (branch offsets)
+    using Word = std::uint16_t;       ///< 16-bit value
+    using Address = std::uint16_t;    ///< 16-bit address
+    using Cycles = std::uint64_t;     ///< Clock cycle counter
+
+    // ====================================================================
+    // MEMORY MAP
+    // ====================================================================
+
+    constexpr std::size_t MEMORY_SIZE = 0x10000;   ///< 64 KiB address space
+
+    constexpr Address STACK_BASE = 0x0100;         ///< Stack lives in page 1
+    constexpr Byte STACK_POINTER_RESET = 0xFF;     ///< SP value after reset
+
+    constexpr Address VECTOR_NMI = 0xFFFA;         ///< Non-maskable interrupt vector
+    constexpr Address VECTOR_RESET = 0xFFFC;       ///< Reset vector
+    constexpr Address VECTOR_IRQ_BRK = 0xFFFE;     ///< IRQ / BRK vector
+
+    // ====================================================================
+    // STATUS FLAGS
+    // ====================================================================
+
+    /**
+     * @brief Bits of the processor status register (P)
+     */
+    enum StatusFlags : Byte {
+        FLAG_CARRY     = 1 << 0,   ///< C - Carry
+        FLAG_ZERO      = 1 << 1,   ///< Z - Zero
+        FLAG_INTERRUPT = 1 << 2,   ///< I - Interrupt disable
+        FLAG_DECIMAL   = 1 << 3,   ///< D - Decimal mode
+        FLAG_BREAK     = 1 << 4,   ///< B - Break (only exists on the stack)
+        FLAG_UNUSED    = 1 << 5,   ///< Always reads as 1
+        FLAG_OVERFLOW  = 1 << 6,   ///< V - Overflow
+        FLAG_NEGATIVE  = 1 << 7    ///< N - Negative
+    };
+
+    // ====================================================================
+    // OPCODES
+    // ====================================================================
+
+    // LDA - Load Accumulator
+    constexpr Byte INS_LDA_IM   = 0xA9;
+    constexpr Byte INS_LDA_ZP   = 0xA5;
+    constexpr Byte INS_LDA_ZPX  = 0xB5;
+    constexpr Byte INS_LDA_ABS  = 0xAD;
+    constexpr Byte INS_LDA_ABSX = 0xBD;
+    constexpr Byte INS_LDA_ABSY = 0xB9;
+    constexpr Byte INS_LDA_INDX = 0xA1;
+    constexpr Byte INS_LDA_INDY = 0xB1;
+
+    // LDX - Load X Register
+    constexpr Byte INS_LDX_IM   = 0xA2;
+    constexpr Byte INS_LDX_ZP   = 0xA6;
+    constexpr Byte INS_LDX_ZPY  = 0xB6;
+    constexpr Byte INS_LDX_ABS  = 0xAE;
+    constexpr Byte INS_LDX_ABSY = 0xBE;
+
+    // LDY - Load Y Register
+    constexpr Byte INS_LDY_IM   = 0xA0;
+    constexpr Byte INS_LDY_ZP   = 0xA4;
+    constexpr Byte INS_LDY_ZPX  = 0xB4;
+    constexpr Byte INS_LDY_ABS  = 0xAC;
+    constexpr Byte INS_LDY_ABSX = 0xBC;
+
+    // STA - Store Accumulator
+    constexpr Byte INS_STA_ZP   = 0x85;
+    constexpr Byte INS_STA_ZPX  = 0x95;
+    constexpr Byte INS_STA_ABS  = 0x8D;
+    constexpr Byte INS_STA_ABSX = 0x9D;
+    constexpr Byte INS_STA_ABSY = 0x99;
+    constexpr Byte INS_STA_INDX = 0x81;
+    constexpr Byte INS_STA_INDY = 0x91;
+
+    // STX - Store X Register
+    constexpr Byte INS_STX_ZP   = 0x86;
+    constexpr Byte INS_STX_ZPY  = 0x96;
+    constexpr Byte INS_STX_ABS  = 0x8E;
+
+    // STY - Store Y Register
+    constexpr Byte INS_STY_ZP   = 0x84;
+    constexpr Byte INS_STY_ZPX  = 0x94;
+    constexpr Byte INS_STY_ABS  = 0x8C;
+
+    // Register Transfers
+    constexpr Byte INS_TAX = 0xAA;
+    constexpr Byte INS_TAY = 0xA8;
+    constexpr Byte INS_TXA = 0x8A;
+    constexpr Byte INS_TYA = 0x98;
+    constexpr Byte INS_TSX = 0xBA;
+    constexpr Byte INS_TXS = 0x9A;
+
+    // Stack Operations
+    constexpr Byte INS_PHA = 0x48;
+    constexpr Byte INS_PHP = 0x08;
+    constexpr Byte INS_PLA = 0x68;
+    constexpr Byte INS_PLP = 0x28;
+
+    // AND - Logical AND
+    constexpr Byte INS_AND_IM   = 0x29;
+    constexpr Byte INS_AND_ZP   = 0x25;
+    constexpr Byte INS_AND_ZPX  = 0x35;
+    constexpr Byte INS_AND_ABS  = 0x2D;
+    constexpr Byte INS_AND_ABSX = 0x3D;
+    constexpr Byte INS_AND_ABSY = 0x39;
+    constexpr Byte INS_AND_INDX = 0x21;
+    constexpr Byte INS_AND_INDY = 0x31;
+
+    // ORA - Logical Inclusive OR
+    constexpr Byte INS_ORA_IM   = 0x09;
+    constexpr Byte INS_ORA_ZP   = 0x05;
+    constexpr Byte INS_ORA_ZPX  = 0x15;
+    constexpr Byte INS_ORA_ABS  = 0x0D;
+    constexpr Byte INS_ORA_ABSX = 0x1D;
+    constexpr Byte INS_ORA_ABSY = 0x19;
+    constexpr Byte INS_ORA_INDX = 0x01;
+    constexpr Byte INS_ORA_INDY = 0x11;
+
+    // EOR - Exclusive OR
+    constexpr Byte INS_EOR_IM   = 0x49;
+    constexpr Byte INS_EOR_ZP   = 0x45;
+    constexpr Byte INS_EOR_ZPX  = 0x55;
+    constexpr Byte INS_EOR_ABS  = 0x4D;
+    constexpr Byte INS_EOR_ABSX = 0x5D;
+    constexpr Byte INS_EOR_ABSY = 0x59;
+    constexpr Byte INS_EOR_INDX = 0x41;
+    constexpr Byte INS_EOR_INDY = 0x51;
+
+    // BIT - Bit Test
+    constexpr Byte INS_BIT_ZP   = 0x24;
+    constexpr Byte INS_BIT_ABS  = 0x2C;
+
+    // ADC - Add with Carry
+    constexpr Byte INS_ADC_IM   = 0x69;
+    constexpr Byte INS_ADC_ZP   = 0x65;
+    constexpr Byte INS_ADC_ZPX  = 0x75;
+    constexpr Byte INS_ADC_ABS  = 0x6D;
+    constexpr Byte INS_ADC_ABSX = 0x7D;
+    constexpr Byte INS_ADC_ABSY = 0x79;
+    constexpr Byte INS_ADC_INDX = 0x61;
+    constexpr Byte INS_ADC_INDY = 0x71;
+
+    // SBC - Subtract with Carry
+    constexpr Byte INS_SBC_IM   = 0xE9;
+    constexpr Byte INS_SBC_ZP   = 0xE5;
+    constexpr Byte INS_SBC_ZPX  = 0xF5;
+    constexpr Byte INS_SBC_ABS  = 0xED;
+    constexpr Byte INS_SBC_ABSX = 0xFD;
+    constexpr Byte INS_SBC_ABSY = 0xF9;
+    constexpr Byte INS_SBC_INDX = 0xE1;
+    constexpr Byte INS_SBC_INDY = 0xF1;
+
+    // CMP - Compare Accumulator
+    constexpr Byte INS_CMP_IM   = 0xC9;
+    constexpr Byte INS_CMP_ZP   = 0xC5;
+    constexpr Byte INS_CMP_ZPX  = 0xD5;
+    constexpr Byte INS_CMP_ABS  = 0xCD;
+    constexpr Byte INS_CMP_ABSX = 0xDD;
+    constexpr Byte INS_CMP_ABSY = 0xD9;
+    constexpr Byte INS_CMP_INDX = 0xC1;
+    constexpr Byte INS_CMP_INDY = 0xD1;
+
+    // CPX / CPY - Compare X / Y Register
+    constexpr Byte INS_CPX_IM   = 0xE0;
+    constexpr Byte INS_CPX_ZP   = 0xE4;
+    constexpr Byte INS_CPX_ABS  = 0xEC;
+    constexpr Byte INS_CPY_IM   = 0xC0;
+    constexpr Byte INS_CPY_ZP   = 0xC4;
+    constexpr Byte INS_CPY_ABS  = 0xCC;
+
+    // INC / DEC - Increment / Decrement Memory
+    constexpr Byte INS_INC_ZP   = 0xE6;
+    constexpr Byte INS_INC_ZPX  = 0xF6;
+    constexpr Byte INS_INC_ABS  = 0xEE;
+    constexpr Byte INS_INC_ABSX = 0xFE;
+    constexpr Byte INS_DEC_ZP   = 0xC6;
+    constexpr Byte INS_DEC_ZPX  = 0xD6;
+    constexpr Byte INS_DEC_ABS  = 0xCE;
+    constexpr Byte INS_DEC_ABSX = 0xDE;
+
+    // Register Increment / Decrement
+    constexpr Byte INS_INX = 0xE8;
+    constexpr Byte INS_INY = 0xC8;
+    constexpr Byte INS_DEX = 0xCA;
+    constexpr Byte INS_DEY = 0x88;
+
+    // ASL - Arithmetic Shift Left
+    constexpr Byte INS_ASL_ACC  = 0x0A;
+    constexpr Byte INS_ASL_ZP   = 0x06;
+    constexpr Byte INS_ASL_ZPX  = 0x16;
+    constexpr Byte INS_ASL_ABS  = 0x0E;
+    constexpr Byte INS_ASL_ABSX = 0x1E;
+
+    // LSR - Logical Shift Right
+    constexpr Byte INS_LSR_ACC  = 0x4A;
+    constexpr Byte INS_LSR_ZP   = 0x46;
+    constexpr Byte INS_LSR_ZPX  = 0x56;
+    constexpr Byte INS_LSR_ABS  = 0x4E;
+    constexpr Byte INS_LSR_ABSX = 0x5E;
+
+    // ROL - Rotate Left
+    constexpr Byte INS_ROL_ACC  = 0x2A;
+    constexpr Byte INS_ROL_ZP   = 0x26;
+    constexpr Byte INS_ROL_ZPX  = 0x36;
+    constexpr Byte INS_ROL_ABS  = 0x2E;
+    constexpr Byte INS_ROL_ABSX = 0x3E;
+
+    // ROR - Rotate Right
+    constexpr Byte INS_ROR_ACC  = 0x6A;
+    constexpr Byte INS_ROR_ZP   = 0x66;
+    constexpr Byte INS_ROR_ZPX  = 0x76;
+    constexpr Byte INS_ROR_ABS  = 0x6E;
+    constexpr Byte INS_ROR_ABSX = 0x7E;
+
+    // Jumps and Calls
+    constexpr Byte INS_JMP_ABS = 0x4C;
+    constexpr Byte INS_JMP_IND = 0x6C;
+    constexpr Byte INS_JSR     = 0x20;
+    constexpr Byte INS_RTS     = 0x60;
+    constexpr Byte INS_RTI     = 0x40;
+
+    // Branches
+    constexpr Byte INS_BCC = 0x90;
+    constexpr Byte INS_BCS = 0xB0;
+    constexpr Byte INS_BEQ = 0xF0;
+    constexpr Byte INS_BMI = 0x30;
+    constexpr Byte INS_BNE = 0xD0;
+    constexpr Byte INS_BPL = 0x10;
+    constexpr Byte INS_BVC = 0x50;
+    constexpr Byte INS_BVS = 0x70;
+
+    // Status Flag Changes
+    constexpr Byte INS_CLC = 0x18;
+    constexpr Byte INS_CLD = 0xD8;
+    constexpr Byte INS_CLI = 0x58;
+    constexpr Byte INS_CLV = 0xB8;
+    constexpr Byte INS_SEC = 0x38;
+    constexpr Byte INS_SED = 0xF8;
+    constexpr Byte INS_SEI = 0x78;
+
+    // System
+    constexpr Byte INS_BRK = 0x00;
+    constexpr Byte INS_NOP = 0xEA;
+
+} // namespace M6502
+
+#endif // M6502_CONSTANTS_H
@@ -0,0 +1,428 @@
+/**
+ * @file Debugger.cpp
+ * @brief Condition parsing and breakpoint/watchpoint bookkeeping
+ */
+
+#include "Debugger.h"
+#include <algorithm>
+#include <cctype>
+#include <utility>
+
+namespace M6502 {
+
+    // ====================================================================
+    // CONDITIONS
+    // ====================================================================
+
+    /**
+     * @brief Recursive-descent parser for Condition's grammar
+     *
+     *   condition := group ( "||" group )*
+     *   group     := clause ( "&&" clause )*
+     *   clause    := "!" flag | flag | operand op number
+     */
+    class ConditionParser {
+    public:
+        explicit ConditionParser(const std::string& text) : text(text), position(0) {}
+
+        bool Parse(Condition& condition) {
+            std::vector<std::vector<Condition::Clause>> alternatives;
+            do {
+                std::vector<Condition::Clause> group;
+                do {
+                    Condition::Clause clause;
+                    if (!ParseClause(clause)) {
+                        return false;
+                    }
+                    group.push_back(clause);
+                } while (Accept("&&"));
+                alternatives.push_back(std::move(group));
+            } while (Accept("||"));
+
+            SkipSpaces();
+            if (position != text.size()) {
+                return false;
+            }
+
+            condition.alternatives = std::move(alternatives);
+            condition.text = text;
+            return true;
+        }
+
+    private:
+        using Operand = Condition::Operand;
+        using Comparison = Condition::Comparison;
+
+        void SkipSpaces() {
+            while (position < text.size() && std::isspace(static_cast<unsigned char>(text[position]))) {
+                position++;
+            }
+        }
+
+        bool Accept(const char* token) {
+            SkipSpaces();
+            std::size_t length = std::char_traits<char>::length(token);
+            if (text.compare(position, length, token) == 0) {
+                position += length;
+                return true;
+            }
+            return false;
+        }
+
+        std::string Name() {
+            SkipSpaces();
+            std::size_t start = position;
+            while (position < text.size() && std::isalpha(static_cast<unsigned char>(text[position]))) {
+                position++;
+            }
+            std::string word = text.substr(start, position - start);
+            for (char& c : word) {
+                c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+            }
+            return word;
+        }
+
+        static Byte FlagMask(const std::string& name) {
+            if (name.size() != 1) {
+                return 0;
+            }
+            switch (name[0]) {
+                case 'N': return FLAG_NEGATIVE;
+                case 'V': return FLAG_OVERFLOW;
+                case 'B': return FLAG_BREAK;
+                case 'D': return FLAG_DECIMAL;
+                case 'I': return FLAG_INTERRUPT;
+                case 'Z': return FLAG_ZERO;
+                case 'C': return FLAG_CARRY;
+                default:  return 0;
+            }
+        }
+
+        bool ParseNumber(Word& value) {
+            SkipSpaces();
+            int base = 10;
+            if (Accept("$")) {
+                base = 16;
+            } else if (Accept("0x") || Accept("0X")) {
+                base = 16;
+            } else if (Accept("%")) {
+                base = 2;
+            }
+
+            std::size_t start = position;
+            unsigned long result = 0;
+            while (position < text.size()) {
+                int digit;
+                char c = static_cast<char>(std::tolower(static_cast<unsigned char>(text[position])));
+                if (c >= '0' && c <= '9') {
+                    digit = c - '0';
+                } else if (c >= 'a' && c <= 'f') {
+                    digit = c - 'a' + 10;
+                } else {
+                    break;
+                }
+                if (digit >= base) {
+                    break;
+                }
+                result = result * base + digit;
+                if (result > 0xFFFF) {
+                    return false;
+                }
+                position++;
+            }
+
+            value = static_cast<Word>(result);
+            return position != start;
+        }
+
+        bool ParseComparison(Comparison& comparison) {
+            // Two-character operators first, so "<=" is not read as "<"
+            if (Accept("==")) { comparison = Comparison::Equal; return true; }
+            if (Accept("!=")) { comparison = Comparison::NotEqual; return true; }
+            if (Accept("<=")) { comparison = Comparison::LessEqual; return true; }
+            if (Accept(">=")) { comparison = Comparison::GreaterEqual; return true; }
+            if (Accept("<"))  { comparison = Comparison::Less; return true; }
+            if (Accept(">"))  { comparison = Comparison::Greater; return true; }
+            return false;
+        }
+
+        bool ParseClause(Condition::Clause& clause) {
+            clause = Condition::Clause{ Operand::Flag, 0, Comparison::NotEqual, 0 };
+
+            // "!flag": the flag is clear
+            if (Accept("!")) {
+                clause.flag = FlagMask(Name());
+                clause.comparison = Comparison::Equal;
+                return clause.flag != 0;
+            }
+
+            const std::string name = Name();
+            if (name == "A") {
+                clause.operand = Operand::A;
+            } else if (name == "X") {
+                clause.operand = Operand::X;
+            } else if (name == "Y") {
+                clause.operand = Operand::Y;
+            } else if (name == "SP") {
+                clause.operand = Operand::SP;
+            } else if (name == "PC") {
+                clause.operand = Operand::PC;
+            } else if (name == "P") {
+                clause.operand = Operand::P;
+            } else if (name == "VALUE") {
+                clause.operand = Operand::Value;
+            } else {
+                clause.flag = FlagMask(name);
+                if (clause.flag == 0) {
+                    return false;
+                }
+            }
+
+            // A flag on its own: the flag is set
+            if (!ParseComparison(clause.comparison)) {
+                return clause.operand == Operand::Flag;
+            }
+            return ParseNumber(clause.value);
+        }
+
+        const std::string& text;
+        std::size_t position;
+    };
+
+    bool Condition::Parse(const std::string& text, Condition& condition) {
+        return ConditionParser(text).Parse(condition);
+    }
+
+    bool Condition::Evaluate(const Registers& registers, Byte value) const {
+        if (alternatives.empty()) {
+            return true;
+        }
+
+        for (const std::vector<Clause>& group : alternatives) {
+            bool all = true;
+            for (const Clause& clause : group) {
+                Word operand = 0;
+                switch (clause.operand) {
+                    case Operand::A:     operand = registers.A; break;
+                    case Operand::X:     operand = registers.X; break;
+                    case Operand::Y:     operand = registers.Y; break;
+                    case Operand::SP:    operand = registers.SP; break;
+                    case Operand::PC:    operand = registers.PC; break;
+                    case Operand::P:     operand = registers.P; break;
+                    case Operand::Value: operand = value; break;
+                    case Operand::Flag:  operand = (registers.P & clause.flag) != 0 ? 1 : 0; break;
+                }
+
+                bool holds = false;
+                switch (clause.comparison) {
+                    case Comparison::Equal:        holds = operand == clause.value; break;
+                    case Comparison::NotEqual:     holds = operand != clause.value; break;
+                    case Comparison::Less:         holds = operand < clause.value; break;
+                    case Comparison::LessEqual:    holds = operand <= clause.value; break;
+                    case Comparison::Greater:      holds = operand > clause.value; break;
+                    case Comparison::GreaterEqual: holds = operand >= clause.value; break;
+                }
+
+                if (!holds) {
+                    all = false;
+                    break;
+                }
+            }
+            if (all) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // ====================================================================
+    // POINTS
+    // ====================================================================
+
+    Debugger::Debugger()
+        : nextId(1), armed(false), target{}, current(0), resuming(false), resumeAt(0),
+          stopPending(false), lastStop{} {}
+
+    Debugger::~Debugger() {
+        Detach();
+    }
+
+    void Debugger::Detach() {
+        if (target.cpu != nullptr) {
+            target.setDebugger(target.cpu, nullptr);
+            target.setWatcher(target.bus, nullptr);
+        }
+        target = Target{};
+    }
+
+    Debugger::PointId Debugger::AddBreakpoint(Address address, const Condition& condition) {
+        return AddWatchpoint(address, address, WATCH_EXECUTE, condition);
+    }
+
+    Debugger::PointId Debugger::AddWatchpoint(Address first, Address last, Byte kinds,
+                                              const Condition& condition) {
+        kinds &= WATCH_READ | WATCH_WRITE | WATCH_EXECUTE;
+        if (first > last || kinds == 0) {
+            return NO_POINT;
+        }
+
+        points.push_back(Point{ nextId, first, last, kinds, true, condition, 0 });
+        Rearm();
+        return nextId++;
+    }
+
+    bool Debugger::Remove(PointId id) {
+        auto found = std::find_if(points.begin(), points.end(),
+                                  [id](const Point& point) { return point.id == id; });
+        if (found == points.end()) {
+            return false;
+        }
+        points.erase(found);
+        Rearm();
+        return true;
+    }
+
+    bool Debugger::Enable(PointId id, bool enabled) {
+        Point* point = FindPoint(id);
+        if (point == nullptr) {
+            return false;
+        }
+        point->enabled = enabled;
+        Rearm();
+        return true;
+    }
+
+    void Debugger::Clear() {
+        points.clear();
+        Rearm();
+    }
+
+    const Debugger::Point* Debugger::Find(PointId id) const {
+        for (const Point& point : points) {
+            if (point.id == id) {
+                return &point;
+            }
+        }
+        return nullptr;
+    }
+
+    Debugger::Point* Debugger::FindPoint(PointId id) {
+        return const_cast<Point*>(static_cast<const Debugger*>(this)->Find(id));
+    }
+
+    void Debugger::Rearm() {
+        executePages.reset();
+        readPages.reset();
+        writePages.reset();
+        armed = false;
+
+        for (const Point& point : points) {
+            if (!point.enabled) {
+                continue;
+            }
+            armed = true;
+            for (std::size_t page = point.first >> 8; page <= static_cast<std::size_t>(point.last >> 8); page++) {
+                executePages[page] = executePages[page] || (point.kinds & WATCH_EXECUTE) != 0;
+                readPages[page] = readPages[page] || (point.kinds & WATCH_READ) != 0;
+                writePages[page] = writePages[page] || (point.kinds & WATCH_WRITE) != 0;
+            }
+        }
+
+        if (target.cpu == nullptr) {
+            return;
+        }
+
+        for (std::size_t page = 0; page < 256; page++) {
+            const Byte kinds = static_cast<Byte>((readPages[page] ? WATCH_READ : 0) |
+                                                 (writePages[page] ? WATCH_WRITE : 0));
+            target.watchAccesses(target.bus, static_cast<Byte>(page), kinds);
+        }
+
+        // The CPU re-reads Armed()
+        target.setDebugger(target.cpu, this);
+    }
+
+    bool Debugger::TakeStop(Stop& stop) {
+        if (!stopPending) {
+            return false;
+        }
+        stop = lastStop;
+        stopPending = false;
+        return true;
+    }
+
+    // ====================================================================
+    // HITS
+    // ====================================================================
+
+    bool Debugger::OnExecute(const Registers& registers, Byte opcode) {
+        // Resuming from a stop here: run this instruction once
+        if (resuming && registers.PC == resumeAt) {
+            resuming = false;
+            return false;
+        }
+
+        bool stop = false;
+        for (Point& point : points) {
+            if (point.enabled && (point.kinds & WATCH_EXECUTE) &&
+                registers.PC >= point.first && registers.PC <= point.last &&
+                point.condition.Evaluate(registers, opcode)) {
+                point.hits++;
+                if (!stop) {
+                    RecordStop(StopReason::Execute, point, registers.PC, opcode, registers);
+                    stop = true;
+                }
+            }
+        }
+
+        if (stop) {
+            resuming = true;
+            resumeAt = registers.PC;
+        }
+        return stop;
+    }
+
+    void Debugger::RecordStop(StopReason reason, const Point& point, Address address, Byte value,
+                              const Registers& registers) {
+        lastStop = Stop{ reason, point.id, address, value, registers };
+        stopPending = true;
+    }
+
+    void Debugger::OnWatchedRead(Address address, Byte value) {
+        OnAccess(WATCH_READ, address, value);
+    }
+
+    void Debugger::OnWatchedWrite(Address address, Byte value) {
+        OnAccess(WATCH_WRITE, address, value);
+    }
+
+    void Debugger::OnAccess(Byte kind, Address address, Byte value) {
+        if (target.cpu == nullptr) {
+            return;
+        }
+
+        Registers registers = target.registers(target.cpu);
+        registers.PC = current;
+
+        bool stop = false;
+        for (Point& point : points) {
+            if (point.enabled && (point.kinds & kind) &&
+                address >= point.first && address <= point.last &&
+                point.condition.Evaluate(registers, value)) {
+                point.hits++;
+                if (!stop) {
+                    RecordStop(kind == WATCH_READ ? StopReason::Read : StopReason::Write,
+                               point, address, value, registers);
+                    stop = true;
+                }
+            }
+        }
+
+        // The access is part of an instruction already under way; the
+        // batch ends once it completes
+        if (stop) {
+            target.endBatch(target.cpu);
+        }
+    }
+
+} // namespace M6502
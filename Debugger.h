@@ -0,0 +1,307 @@
+/**
+ * @file Debugger.h
+ * @brief Breakpoints and watchpoints with conditions on registers and flags
+ */
+
+#ifndef M6502_DEBUGGER_H
+#define M6502_DEBUGGER_H
+
+#include "AccessWatcher.h"
+#include "Constants.h"
+#include <bitset>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace M6502 {
+
+    /**
+     * @brief Registers as a condition sees them
+     *
+     * PC is the address of the instruction being executed, also for a
+     * watchpoint hit in the middle of it.
+     */
+    struct Registers {
+        Word PC;
+        Byte A;
+        Byte X;
+        Byte Y;
+        Byte SP;
+        Byte P;
+    };
+
+    /**
+     * @brief A test on registers and flags, such as "A == $40 && !C"
+     *
+     * Clauses are joined by && and ||, && binding tighter. A clause is
+     * one of
+     *   - `operand op number`, op being == != < <= > >=
+     *   - `flag`, true if the flag is set
+     *   - `!flag`, true if it is clear
+     *
+     * Operands are A, X, Y, SP, PC and P, and VALUE: the byte read or
+     * written for a watchpoint, the opcode for a breakpoint. Flags are
+     * N, V, B, D, I, Z and C, and compare as 0 or 1. Numbers are decimal,
+     * $hex, 0xhex or %binary. Names are case-insensitive.
+     *
+     * A default-constructed condition is always true.
+     */
+    class Condition {
+    public:
+        Condition() = default;
+
+        /**
+         * @brief Parse `text` into `condition`
+         * @return false on a syntax error, with `condition` unchanged
+         */
+        static bool Parse(const std::string& text, Condition& condition);
+
+        bool Evaluate(const Registers& registers, Byte value) const;
+
+        /// True for the default (empty) condition
+        bool Always() const { return alternatives.empty(); }
+
+        /// The text it was parsed from; empty for Always()
+        const std::string& Text() const { return text; }
+
+    private:
+        enum class Operand : Byte { A, X, Y, SP, PC, P, Value, Flag };
+        enum class Comparison : Byte { Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual };
+
+        struct Clause {
+            Operand operand;
+            Byte flag;          ///< FLAG_* mask when operand is Flag
+            Comparison comparison;
+            Word value;
+        };
+
+        friend class ConditionParser;
+
+        // Any one group of clauses all true makes the condition true
+        std::vector<std::vector<Clause>> alternatives;
+        std::string text;
+    };
+
+    /**
+     * @brief Stops a running CPU at breakpoints and watchpoints
+     *
+     * A breakpoint stops the CPU before the instruction at its address
+     * executes. A watchpoint covers an address range and any of reads,
+     * writes and execution; a read or write hit stops the CPU after the
+     * accessing instruction, an execute hit before it, like a breakpoint.
+     * Either kind may carry a Condition, tested at the moment of the hit.
+     *
+     * Lookup is one bit test per page: the debugger keeps a 256-bit
+     * bitmap per access kind. The CPU tests the execute bitmap for PC's
+     * page before each instruction; the bus tests its own copy of the
+     * read and write bits on each access (see AccessWatcher.h). Only a
+     * set bit leads to the exact address and condition checks.
+     *
+     * With no point enabled the CPU is not told about the debugger at
+     * all, cached and threaded dispatch stay on, and no page is watched.
+     * While any point is enabled, the CPU steps through the plain
+     * interpreter, so every fetch is seen (as with the profiler).
+     *
+     * After a stop, the next batch resumes past the breakpoint it
+     * stopped at; if the host moves PC first, the breakpoint is armed
+     * again. Execute(Memory&) is a batch of one, so it returns 0, with
+     * nothing executed, when it stops at a breakpoint.
+     */
+    class Debugger : public AccessWatcher {
+    public:
+        /// Breakpoints and watchpoints share one id space; 0 is never used
+        using PointId = std::uint32_t;
+        static constexpr PointId NO_POINT = 0;
+
+        /// Watchpoint kind alongside AccessWatcher::WATCH_READ and WATCH_WRITE
+        static constexpr Byte WATCH_EXECUTE = 0x04;
+
+        enum class StopReason : Byte {
+            None,
+            Execute,    ///< Breakpoint or execute watchpoint; PC is the address
+            Read,
+            Write
+        };
+
+        struct Stop {
+            StopReason reason;
+            PointId point;
+            Address address;        ///< Address accessed (or executed)
+            Byte value;             ///< Byte read or written, or the opcode
+            Registers registers;    ///< At the moment of the hit; before the instruction for reads on Memory
+        };
+
+        struct Point {
+            PointId id;
+            Address first;
+            Address last;
+            Byte kinds;             ///< WATCH_READ | WATCH_WRITE | WATCH_EXECUTE
+            bool enabled;
+            Condition condition;
+            std::uint64_t hits;     ///< Times it matched with its condition true
+        };
+
+        Debugger();
+        ~Debugger();
+
+        Debugger(const Debugger&) = delete;
+        Debugger& operator=(const Debugger&) = delete;
+
+        /**
+         * @brief Start debugging `cpu` running on `bus`
+         *
+         * Detaches from any previous pair. Either bus type works; the
+         * CPU must run on that same bus.
+         */
+        template <typename CPUType, typename Bus>
+        void Attach(CPUType& cpu, Bus& bus);
+
+        /**
+         * @brief Release the CPU and bus; points are kept
+         */
+        void Detach();
+
+        /**
+         * @brief Stop before the instruction at `address` when `condition` holds
+         * @return The new point's id
+         */
+        PointId AddBreakpoint(Address address, const Condition& condition = Condition());
+
+        /**
+         * @brief Stop on `kinds` of access to [first, last] when `condition` holds
+         * @return The new point's id, or NO_POINT if the range or kinds are empty
+         */
+        PointId AddWatchpoint(Address first, Address last, Byte kinds,
+                              const Condition& condition = Condition());
+
+        /**
+         * @brief Delete a point
+         * @return false if there is no such point
+         */
+        bool Remove(PointId id);
+
+        /**
+         * @brief Arm or disarm a point without deleting it
+         * @return false if there is no such point
+         */
+        bool Enable(PointId id, bool enabled);
+
+        /// Delete every point
+        void Clear();
+
+        /// Null if there is no such point
+        const Point* Find(PointId id) const;
+
+        const std::vector<Point>& Points() const { return points; }
+
+        /// True if any point is enabled
+        bool Armed() const { return armed; }
+
+        /**
+         * @brief The latest stop since the last call, if any
+         * @return false if nothing stopped the CPU since then
+         */
+        bool TakeStop(Stop& stop);
+
+        // ================================================================
+        // HOOKS CALLED BY THE CORE
+        // ================================================================
+
+        /// Before every instruction (or interrupt entry) while Armed()
+        void BeginInstruction(Word pc) {
+            current = pc;
+            if (resuming && pc != resumeAt) {
+                resuming = false;
+            }
+        }
+
+        /// The one bit test the fetch path pays
+        bool ExecuteWatched(Word pc) const { return executePages[pc >> 8]; }
+
+        /**
+         * @brief The instruction `opcode` at registers.PC is about to run
+         * @return true to stop before it
+         *
+         * Virtual, like the access hooks, so the core reaches it through
+         * the object and links without Debugger.cpp.
+         */
+        virtual bool OnExecute(const Registers& registers, Byte opcode);
+
+        void OnWatchedRead(Address address, Byte value) override;
+        void OnWatchedWrite(Address address, Byte value) override;
+
+    private:
+        /// What Attach() bound, with the types erased
+        struct Target {
+            void* cpu;
+            void* bus;
+            void (*setDebugger)(void* cpu, Debugger* debugger);
+            void (*endBatch)(void* cpu);
+            Registers (*registers)(const void* cpu);
+            void (*setWatcher)(void* bus, AccessWatcher* watcher);
+            void (*watchAccesses)(void* bus, Byte page, Byte kinds);
+        };
+
+        Point* FindPoint(PointId id);
+
+        /// Rebuild the bitmaps and push them to the bus and CPU
+        void Rearm();
+
+        /// A read or write hit: test the points and stop after the instruction
+        void OnAccess(Byte kind, Address address, Byte value);
+
+        void RecordStop(StopReason reason, const Point& point, Address address, Byte value,
+                        const Registers& registers);
+
+        std::vector<Point> points;
+        PointId nextId;
+        bool armed;
+
+        // One bit per page with an enabled point of that kind
+        std::bitset<256> executePages;
+        std::bitset<256> readPages;
+        std::bitset<256> writePages;
+
+        Target target;
+
+        Word current;       ///< PC of the instruction running now
+        bool resuming;      ///< Let the instruction at resumeAt run once
+        Word resumeAt;
+
+        bool stopPending;
+        Stop lastStop;
+    };
+
+    // ====================================================================
+    // ATTACHING
+    // ====================================================================
+
+    template <typename CPUType, typename Bus>
+    void Debugger::Attach(CPUType& cpu, Bus& bus) {
+        Detach();
+
+        target.cpu = &cpu;
+        target.bus = &bus;
+        target.setDebugger = [](void* running, Debugger* debugger) {
+            static_cast<CPUType*>(running)->SetDebugger(debugger);
+        };
+        target.endBatch = [](void* running) { static_cast<CPUType*>(running)->EndBatch(); };
+        target.registers = [](const void* running) {
+            const CPUType& state = *static_cast<const CPUType*>(running);
+            return Registers{ state.PC, state.A, state.X, state.Y, state.SP, static_cast<Byte>(state.P) };
+        };
+        target.setWatcher = [](void* watched, AccessWatcher* watcher) {
+            static_cast<Bus*>(watched)->SetAccessWatcher(watcher);
+        };
+        target.watchAccesses = [](void* watched, Byte page, Byte kinds) {
+            static_cast<Bus*>(watched)->WatchAccesses(page, kinds);
+        };
+
+        bus.SetAccessWatcher(this);
+        resuming = false;
+        Rearm();
+    }
+
+} // namespace M6502
+
+#endif // M6502_DEBUGGER_H
@@ -0,0 +1,36 @@
+/**
+ * @file Decimal.cpp
+ * @brief Compile-time decimal ADC/SBC tables
+ */
+
+#include "Decimal.h"
+
+namespace M6502 {
+
+    namespace {
+
+        template <DecimalResult (*Operation)(Byte, Byte, bool)>
+        constexpr DecimalTable BuildDecimalTable() {
+            DecimalTable table{};
+
+            // Nested so no single loop runs into the compiler's constexpr
+            // iteration limit
+            for (int carry = 0; carry < 2; carry++) {
+                for (int a = 0; a < 256; a++) {
+                    for (int operand = 0; operand < 256; operand++) {
+                        table[DecimalIndex(a, operand, carry != 0)] =
+                            Operation(static_cast<Byte>(a), static_cast<Byte>(operand), carry != 0);
+                    }
+                }
+            }
+            return table;
+        }
+
+    } // namespace
+
+    // constexpr: built by the compiler and placed in read-only data, with
+    // no start-up cost
+    constexpr DecimalTable DecimalAddTable = BuildDecimalTable<ComputeDecimalAdd>();
+    constexpr DecimalTable DecimalSubtractTable = BuildDecimalTable<ComputeDecimalSubtract>();
+
+} // namespace M6502
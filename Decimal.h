@@ -0,0 +1,149 @@
+/**
+ * @file Decimal.h
+ * @brief Decimal-mode ADC/SBC arithmetic and its precomputed result tables
+ */
+
+#ifndef M6502_DECIMAL_H
+#define M6502_DECIMAL_H
+
+#include "Constants.h"
+#include <array>
+#include <cstddef>
+
+// Decimal-mode ADC/SBC by table lookup. With M6502_BCD_TABLES=1 each
+// decimal ADC or SBC is one load from a 256 KiB table built at compile
+// time (Decimal.cpp) instead of the nibble adjustment chain. Off by
+// default: the tables only win while they stay in cache. Results are
+// identical either way; benchmarks/DecimalBenchmark.cpp checks every
+// input. Binary-mode ADC/SBC are unaffected.
+#ifndef M6502_BCD_TABLES
+    #define M6502_BCD_TABLES 0
+#endif
+
+namespace M6502 {
+
+    /**
+     * @brief Result byte and flags of one decimal-mode ADC or SBC
+     *
+     * `flags` holds the FLAG_* bits the operation defines; the others
+     * are zero and must be left alone by the caller.
+     */
+    struct DecimalResult {
+        Byte result;
+        Byte flags;
+    };
+
+    /// Flags a decimal ADC defines. N, Z and V come from the sum before
+    /// the high nibble is adjusted, as on the NMOS 6502.
+    constexpr Byte DECIMAL_ADD_FLAGS = FLAG_NEGATIVE | FLAG_OVERFLOW | FLAG_ZERO | FLAG_CARRY;
+
+    /// Flags a decimal SBC defines. V is left unchanged.
+    constexpr Byte DECIMAL_SUBTRACT_FLAGS = FLAG_NEGATIVE | FLAG_ZERO | FLAG_CARRY;
+
+    // ========================================================================
+    // ARITHMETIC
+    // ========================================================================
+
+    // The same nibble adjustment CPU.cpp does inline when the tables are
+    // off. The tables are built from these, and DecimalBenchmark checks
+    // the core against them for every input.
+
+    /**
+     * @brief Decimal ADC by nibble adjustment; each nibble holds 0-9
+     */
+    constexpr DecimalResult ComputeDecimalAdd(Byte a, Byte operand, bool carry) {
+        Word sum = (a & 0x0F) + (operand & 0x0F) + (carry ? 1 : 0);
+
+        // Adjust low nibble if > 9
+        if (sum > 0x09) {
+            sum += 0x06;
+        }
+
+        // Add high nibbles
+        sum = (a & 0xF0) + (operand & 0xF0) + (sum > 0x0F ? 0x10 : 0) + (sum & 0x0F);
+
+        // N, Z and V before the high nibble is adjusted
+        Byte flags = (sum & FLAG_NEGATIVE)
+                   | ((sum & 0xFF) == 0 ? FLAG_ZERO : 0)
+                   | (((a ^ sum) & (operand ^ sum) & 0x80) >> 1);   // bit 7 -> V
+
+        // Adjust high nibble if > 9
+        if ((sum & 0xF0) > 0x90) {
+            sum += 0x60;
+        }
+
+        // Set carry if result > 99
+        flags |= sum > 0x99 ? FLAG_CARRY : 0;
+
+        return { static_cast<Byte>(sum & 0xFF), flags };
+    }
+
+    /**
+     * @brief Decimal SBC by nibble adjustment; carry clear means borrow
+     */
+    constexpr DecimalResult ComputeDecimalSubtract(Byte a, Byte operand, bool carry) {
+        Word diff = (a & 0x0F) - (operand & 0x0F) - (carry ? 0 : 1);
+
+        // Adjust low nibble if negative
+        if (diff & 0x10) {
+            diff = ((diff - 0x06) & 0x0F) | ((a & 0xF0) - (operand & 0xF0) - 0x10);
+        } else {
+            diff = (diff & 0x0F) | ((a & 0xF0) - (operand & 0xF0));
+        }
+
+        // Adjust high nibble if negative
+        if (diff & 0x100) {
+            diff -= 0x60;
+        }
+
+        const Byte result = diff & 0xFF;
+
+        // Carry (borrow) clear if a borrow occurred; N and Z from the result
+        const Byte flags = ((diff & 0x100) == 0 ? FLAG_CARRY : 0)
+                         | (result == 0 ? FLAG_ZERO : 0)
+                         | (result & FLAG_NEGATIVE);
+
+        return { result, flags };
+    }
+
+    // ========================================================================
+    // TABLES
+    // ========================================================================
+
+    /// One entry per (carry, A, operand)
+    constexpr std::size_t DECIMAL_TABLE_SIZE = 2 * 256 * 256;
+
+    using DecimalTable = std::array<DecimalResult, DECIMAL_TABLE_SIZE>;
+
+    constexpr std::size_t DecimalIndex(Byte a, Byte operand, bool carry) {
+        return (carry ? 0x10000 : 0) | (static_cast<std::size_t>(a) << 8) | operand;
+    }
+
+    /// ComputeDecimalAdd() and ComputeDecimalSubtract() for every input,
+    /// evaluated at compile time (Decimal.cpp)
+    extern const DecimalTable DecimalAddTable;
+    extern const DecimalTable DecimalSubtractTable;
+
+    // ========================================================================
+    // WHAT THE CORE CALLS (M6502_BCD_TABLES=1)
+    // ========================================================================
+
+    inline DecimalResult DecimalAdd(Byte a, Byte operand, bool carry) {
+#if M6502_BCD_TABLES
+        return DecimalAddTable[DecimalIndex(a, operand, carry)];
+#else
+        return ComputeDecimalAdd(a, operand, carry);
+#endif
+    }
+
+    inline DecimalResult DecimalSubtract(Byte a, Byte operand, bool carry) {
+#if M6502_BCD_TABLES
+        return DecimalSubtractTable[DecimalIndex(a, operand, carry)];
+#else
+        return ComputeDecimalSubtract(a, operand, carry);
+#endif
+    }
+
+} // namespace M6502
+
+#endif // M6502_DECIMAL_H
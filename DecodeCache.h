@@ -0,0 +1,127 @@
+/**
+ * @file DecodeCache.h
+ * @brief Per-PC cache of predecoded instructions
+ */
+
+#ifndef M6502_DECODE_CACHE_H
+#define M6502_DECODE_CACHE_H
+
+#include "Constants.h"
+#include "CodeObserver.h"
+#include "Timing.h"
+#include <cstdint>
+#include <vector>
+
+namespace M6502 {
+
+    template <typename Bus, typename Timing>
+    class BasicCPU;
+
+    /**
+     * @brief Decoded opcode and operand for every address in the bus
+     *
+     * Used with BasicCPU::RunFor(budget, bus, cache). An entry holds the
+     * instruction's handler, its fetch cycle cost and the raw operand
+     * bytes, so a cached instruction dispatches straight from the entry
+     * without fetching anything from the bus or consulting the decode
+     * table. As with BlockCache, the handlers belong to one core, so the
+     * cache takes the same timing policy as the CPU that runs it.
+     *
+     * The cache registers itself as the bus's code observer and watches
+     * every page it decodes from. A CPU write to a watched page drops the
+     * entries that cover the written byte; remapping a watched page or
+     * re-initialising the bus drops the whole page. Only one cache can be
+     * attached to a bus at a time.
+     *
+     * Writes that bypass the bus (for example straight into a buffer
+     * passed to MemoryBus::MapRAM) are not seen; call Flush() after them.
+     */
+    template <typename Bus, typename Timing = CycleAccurate>
+    class DecodeCache : public CodeObserver {
+    public:
+        explicit DecodeCache(Bus& memory)
+            : memory(memory), entries(MEMORY_SIZE) {
+            memory.SetCodeObserver(this);
+            ResetStatistics();
+        }
+
+        ~DecodeCache() {
+            memory.SetCodeObserver(nullptr);
+        }
+
+        DecodeCache(const DecodeCache&) = delete;
+        DecodeCache& operator=(const DecodeCache&) = delete;
+
+        /**
+         * @brief Drop every cached instruction
+         */
+        void Flush() {
+            for (Entry& entry : entries) {
+                entry.handler = nullptr;
+            }
+        }
+
+        /// Instructions executed from the cache
+        std::uint64_t Hits() const { return hits; }
+
+        /// Instructions that had to be decoded (or could not be cached)
+        std::uint64_t Misses() const { return misses; }
+
+        /// Entries dropped because their bytes were written or remapped
+        std::uint64_t Invalidations() const { return invalidations; }
+
+        void ResetStatistics() {
+            hits = 0;
+            misses = 0;
+            invalidations = 0;
+        }
+
+        void OnCodeWrite(Address address) override {
+            // Instructions are at most 3 bytes, so only entries starting at
+            // the written byte or up to two bytes before it can contain it
+            Invalidate(address);
+            Invalidate(static_cast<Address>(address - 1));
+            Invalidate(static_cast<Address>(address - 2));
+        }
+
+        void OnCodePageChanged(Byte page) override {
+            Address first = static_cast<Address>(page << 8);
+
+            // Include the two entries before the page that may run into it
+            Invalidate(static_cast<Address>(first - 2));
+            Invalidate(static_cast<Address>(first - 1));
+            for (std::size_t offset = 0; offset < 0x100; offset++) {
+                Invalidate(static_cast<Address>(first + offset));
+            }
+        }
+
+    private:
+        friend class BasicCPU<Bus, Timing>;
+
+        using Handler = void (BasicCPU<Bus, Timing>::*)(Bus&, typename Timing::Counter&, Word);
+
+        struct Entry {
+            Handler handler = nullptr;  ///< nullptr: not decoded
+            Word operand = 0;           ///< Operand bytes, little-endian (unused bytes are 0)
+            Byte length = 0;            ///< Bytes fetched, which is also the fetch cycle cost
+        };
+
+        void Invalidate(Address address) {
+            Entry& entry = entries[address];
+            if (entry.handler != nullptr) {
+                entry.handler = nullptr;
+                invalidations++;
+            }
+        }
+
+        Bus& memory;
+        std::vector<Entry> entries;
+
+        std::uint64_t hits;
+        std::uint64_t misses;
+        std::uint64_t invalidations;
+    };
+
+} // namespace M6502
+
+#endif // M6502_DECODE_CACHE_H
@@ -0,0 +1,125 @@
+/**
+ * @file Device.h
+ * @brief Chips that run lazily, synchronized to the CPU by cycle stamps
+ */
+
+#ifndef M6502_DEVICE_H
+#define M6502_DEVICE_H
+
+#include "Constants.h"
+#include <vector>
+
+namespace M6502 {
+
+    /**
+     * @brief A memory-mapped chip that only runs when someone needs to see it
+     *
+     * Instead of being stepped every cycle, a device is caught up to a
+     * given cycle in one Advance() call. That happens in two cases:
+     *   - The CPU reads or writes one of its registers. MemoryBus::MapDevice()
+     *     pages pass the exact cycle of the access, so the device is
+     *     brought up to that cycle before it answers.
+     *   - Its NextDeadline() passes. RunWithDevices() stops the CPU at
+     *     the first instruction boundary at or after the deadline, so
+     *     the device can raise an interrupt or finish a frame.
+     *
+     * Cycles are absolute: the driving CPU's TotalCycles, plus the
+     * cycles already counted in the instruction batch that is running.
+     * On the functional core they count instructions.
+     */
+    class Device {
+    public:
+        static constexpr Cycles NO_DEADLINE = ~Cycles{0};
+
+        virtual ~Device() = default;
+
+        /**
+         * @brief Run the device forward to `cycle`; earlier cycles are ignored
+         */
+        void CatchUp(Cycles cycle) {
+            if (cycle > synced) {
+                Advance(synced, cycle);
+                synced = cycle;
+            }
+        }
+
+        /// The cycle the device's state is up to date with
+        Cycles SyncedTo() const { return synced; }
+
+        /**
+         * @brief First cycle at which the device acts without being accessed
+         *
+         * For example, a timer underflow that raises IRQ. NO_DEADLINE if
+         * nothing is scheduled.
+         *
+         * RunWithDevices() reads this once per batch. A register access
+         * that moves it earlier must also call the CPU's EndBatch(), or
+         * the deadline is only seen when the batch ends. A Scheduler
+         * (Scheduler.h) event does that by itself.
+         */
+        virtual Cycles NextDeadline() const { return NO_DEADLINE; }
+
+        /**
+         * @brief Register read; the device has been caught up to the access
+         */
+        virtual Byte Read(Address address) = 0;
+
+        /**
+         * @brief Register write; the device has been caught up to the access
+         */
+        virtual void Write(Address address, Byte value) = 0;
+
+    protected:
+        /**
+         * @brief Simulate cycles `from` to `to`
+         *
+         * Raise or release interrupt lines from here.
+         */
+        virtual void Advance(Cycles from, Cycles to) = 0;
+
+    private:
+        Cycles synced = 0;
+    };
+
+    /**
+     * @brief Run `budget` cycles, stopping at every device deadline
+     *
+     * The CPU runs through RunFor() straight to the nearest deadline. Each
+     * device whose deadline has passed is then caught up to the CPU.
+     * Devices nobody accesses and with no deadline due are never touched.
+     * Call CatchUp() before reading a device's state from the host.
+     *
+     * The bus must stamp accesses with `cpu`'s clock (MemoryBus::SetClock()).
+     * As with RunFor(), the last instruction may end past the budget.
+     *
+     * @return Cycles (functional core: instructions) executed
+     */
+    template <typename CPUType, typename Bus>
+    Cycles RunWithDevices(CPUType& cpu, Bus& bus, Cycles budget, const std::vector<Device*>& devices) {
+        const Cycles start = cpu.TotalCycles;
+        const Cycles end = start + budget;
+
+        while (cpu.TotalCycles < end) {
+            Cycles stop = end;
+            for (const Device* device : devices) {
+                const Cycles deadline = device->NextDeadline();
+                stop = deadline < stop ? deadline : stop;
+            }
+
+            // A deadline that CatchUp() did not move still lets one
+            // instruction through, so a misbehaving device cannot hang us
+            cpu.RunFor(stop > cpu.TotalCycles ? stop - cpu.TotalCycles : 1, bus);
+
+            for (Device* device : devices) {
+                if (device->NextDeadline() <= cpu.TotalCycles) {
+                    device->CatchUp(cpu.TotalCycles);
+                }
+            }
+        }
+
+        return cpu.TotalCycles - start;
+    }
+
+} // namespace M6502
+
+#endif // M6502_DEVICE_H
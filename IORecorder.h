@@ -0,0 +1,50 @@
+/**
+ * @file IORecorder.h
+ * @brief Interface for logging device reads and answering them again on replay
+ */
+
+#ifndef M6502_IO_RECORDER_H
+#define M6502_IO_RECORDER_H
+
+#include "Constants.h"
+
+namespace M6502 {
+
+    /**
+     * @brief Sees every CPU access to a MemoryBus I/O page
+     *
+     * Devices are outside what a checkpoint captures, so a replay that
+     * called them again would get different answers (a timer has moved
+     * on, a keyboard buffer has been drained) and push them into a
+     * second round of writes. While recording, each read from an I/O
+     * page (MemoryBus::IsIOPage()) is reported with the value the device
+     * returned. While Replaying(), the recorder answers the read itself
+     * and writes to I/O pages are dropped: the device already saw them.
+     *
+     * Only I/O pages go through here; RAM and ROM, watched or not, are
+     * checkpointed with the rest of memory.
+     */
+    class IORecorder {
+    public:
+        /**
+         * @brief True while the CPU is re-running cycles the devices have already seen
+         */
+        virtual bool Replaying() const = 0;
+
+        /**
+         * @brief A device answered `value` to a read of `address`, stamped `cycle`
+         */
+        virtual void OnIORead(Address address, Cycles cycle, Byte value) = 0;
+
+        /**
+         * @brief While Replaying(): the value the device gave this read the first time
+         */
+        virtual Byte ReplayIORead(Address address, Cycles cycle) = 0;
+
+    protected:
+        ~IORecorder() = default;
+    };
+
+} // namespace M6502
+
+#endif // M6502_IO_RECORDER_H
@@ -0,0 +1,76 @@
+/**
+ * @file IdleLoop.cpp
+ * @brief Table of the opcodes an idle loop may contain, built from OpcodeTable.h
+ */
+
+#include "IdleLoop.h"
+#include "OpcodeTable.h"
+#include <array>
+
+namespace M6502 {
+
+    namespace {
+
+        struct IdleOpcode {
+            bool safe;
+            AddressingMode mode;
+        };
+
+        constexpr bool SameName(const char* a, const char* b) {
+            while (*a != '\0' && *a == *b) {
+                a++;
+                b++;
+            }
+            return *a == *b;
+        }
+
+        /// Memory operations that write their operand or push a return address
+        constexpr bool WritesMemory(const char* operation) {
+            const char* const WRITERS[] = {
+                "STA", "STX", "STY", "INC", "DEC", "JSR",
+                "ASL_MEM", "LSR_MEM", "ROL_MEM", "ROR_MEM"
+            };
+            for (const char* writer : WRITERS) {
+                if (SameName(operation, writer)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        constexpr std::array<IdleOpcode, 256> BuildIdleOpcodes() {
+            std::array<IdleOpcode, 256> opcodes{};
+            for (IdleOpcode& opcode : opcodes) {
+                opcode = { false, AddressingMode::Implied };
+            }
+
+            // Every stack row (pushes, pulls, returns, BRK) is left unsafe,
+            // and TXS with them: a loop that moves SP is not idle
+            #define M6502_IDLE_MEM(opcode, operation, mode, pageCross) \
+                opcodes[opcode] = { !WritesMemory(#operation), AddressingMode::mode };
+            #define M6502_IDLE_IMP(opcode, operation, mode) \
+                opcodes[opcode] = { !SameName(#operation, "TXS"), AddressingMode::mode };
+            #define M6502_IDLE_STK(opcode, operation)
+            #define M6502_IDLE_BRANCH(opcode, flag, expected) \
+                opcodes[opcode] = { true, AddressingMode::Relative };
+
+            M6502_OPCODE_TABLE(M6502_IDLE_MEM, M6502_IDLE_IMP, M6502_IDLE_STK, M6502_IDLE_BRANCH)
+
+            #undef M6502_IDLE_MEM
+            #undef M6502_IDLE_IMP
+            #undef M6502_IDLE_STK
+            #undef M6502_IDLE_BRANCH
+
+            return opcodes;
+        }
+
+        constexpr std::array<IdleOpcode, 256> IDLE_OPCODES = BuildIdleOpcodes();
+
+    } // namespace
+
+    bool IdleSafeOpcode(Byte opcode, AddressingMode& mode) {
+        mode = IDLE_OPCODES[opcode].mode;
+        return IDLE_OPCODES[opcode].safe;
+    }
+
+} // namespace M6502
@@ -0,0 +1,128 @@
+/**
+ * @file IdleLoop.h
+ * @brief Recognizing loops that only wait, so they can be skipped
+ */
+
+#ifndef M6502_IDLE_LOOP_H
+#define M6502_IDLE_LOOP_H
+
+#include "Constants.h"
+#include "CPU.h"
+
+namespace M6502 {
+
+    /// Longest loop body IdleLoopPeriod() follows, in instructions
+    constexpr int IDLE_LOOP_MAX_INSTRUCTIONS = 8;
+
+    /**
+     * @brief Whether `opcode` can be part of an idle loop, and its addressing mode
+     *
+     * Loads, compares, ALU and register operations, branches and JMP are;
+     * anything that writes memory or touches the stack (stores, INC/DEC,
+     * JSR, pushes, pulls, returns, BRK, TXS) is not.
+     */
+    bool IdleSafeOpcode(Byte opcode, AddressingMode& mode);
+
+    /**
+     * @brief True if the instruction at `pc` reads only non-I/O pages
+     *
+     * Covers the opcode and operand fetches, pointers and the operand,
+     * computed from the current X and Y as the instruction will see them.
+     */
+    template <typename Bus>
+    bool ReadsOnlyMemory(const Bus& bus, Word pc, AddressingMode mode, Byte x, Byte y) {
+        auto plain = [&bus](Word address) { return !bus.IsIOPage(static_cast<Byte>(address >> 8)); };
+        auto word = [&bus](Word low, Word high) {
+            return static_cast<Word>(bus.ReadByteNoCycles(low) | (bus.ReadByteNoCycles(high) << 8));
+        };
+
+        const Word operand = static_cast<Word>(pc + 1);
+        if (!plain(pc) || !plain(operand) || !plain(static_cast<Word>(pc + 2))) {
+            return false;
+        }
+        const Byte zp = bus.ReadByteNoCycles(operand);
+        const Word absolute = word(operand, static_cast<Word>(pc + 2));
+
+        switch (mode) {
+            case AddressingMode::ZeroPage:
+            case AddressingMode::ZeroPageX:
+            case AddressingMode::ZeroPageY:
+                return plain(0x0000);
+            case AddressingMode::Absolute:
+                // JMP abs reads nothing there, but checking is harmless
+                return plain(absolute);
+            case AddressingMode::AbsoluteX:
+                return plain(absolute) && plain(static_cast<Word>(absolute + x));
+            case AddressingMode::AbsoluteY:
+                return plain(absolute) && plain(static_cast<Word>(absolute + y));
+            case AddressingMode::Indirect: {
+                // JMP ($xxFF) takes its high byte from $xx00
+                const Word high = (absolute & 0xFF00) | ((absolute + 1) & 0x00FF);
+                return plain(absolute) && plain(high);
+            }
+            case AddressingMode::IndexedIndirect: {
+                if (!plain(0x0000)) {
+                    return false;
+                }
+                const Byte pointer = static_cast<Byte>(zp + x);
+                return plain(word(pointer, static_cast<Byte>(pointer + 1)));
+            }
+            case AddressingMode::IndirectIndexed: {
+                if (!plain(0x0000)) {
+                    return false;
+                }
+                const Word base = word(zp, static_cast<Byte>(zp + 1));
+                return plain(base) && plain(static_cast<Word>(base + y));
+            }
+            default:
+                return true;    // Nothing beyond the instruction bytes
+        }
+    }
+
+    /**
+     * @brief Run one pass of the loop at PC; its length if it is idle, else 0
+     *
+     * Executes instructions (really: they are not undone) until PC and
+     * every register are back where they started, which makes PC the
+     * head of a loop that will repeat identically. Gives up, returning
+     * 0, at anything unsafe (IdleSafeOpcode(), ReadsOnlyMemory()), an
+     * interrupt entry, a debugger stop, after IDLE_LOOP_MAX_INSTRUCTIONS
+     * or before running past `limit`.
+     *
+     * Such a loop writes nothing and reads only memory it does not
+     * change, so every later pass takes the same cycles and leaves the
+     * same state until something outside the CPU changes that memory,
+     * an interrupt line or the registers: an event, a device or the host.
+     *
+     * @return Cycles (functional core: instructions) per pass
+     */
+    template <typename CPUType, typename Bus>
+    Cycles IdleLoopPeriod(CPUType& cpu, Bus& bus, Cycles limit) {
+        const Word pc = cpu.PC;
+        const Byte a = cpu.A, x = cpu.X, y = cpu.Y, sp = cpu.SP;
+        const Byte p = cpu.P;
+        const Cycles start = cpu.TotalCycles;
+
+        for (int i = 0; i < IDLE_LOOP_MAX_INSTRUCTIONS && cpu.TotalCycles < limit; i++) {
+            AddressingMode mode;
+            if (!IdleSafeOpcode(bus.ReadByteNoCycles(cpu.PC), mode) ||
+                !ReadsOnlyMemory(bus, cpu.PC, mode, cpu.X, cpu.Y)) {
+                return 0;
+            }
+
+            // Nothing here moves SP, so a change means an interrupt entry
+            if (cpu.Execute(bus) == 0 || cpu.SP != sp) {
+                return 0;
+            }
+
+            if (cpu.PC == pc && cpu.A == a && cpu.X == x && cpu.Y == y &&
+                static_cast<Byte>(cpu.P) == p) {
+                return cpu.TotalCycles - start;
+            }
+        }
+        return 0;
+    }
+
+} // namespace M6502
+
+#endif // M6502_IDLE_LOOP_H
@@ -4,6 +4,13 @@
  */
 
 #include "CPU.h"
+#include "BlockCache.h"
+#include "Debugger.h"
+#include "DecodeCache.h"
+#include "OpcodeTable.h"
+#include "Profiler.h"
+#include "Trace.h"
+#include <type_traits>
 
 namespace M6502 {
 
@@ -11,7 +18,8 @@ namespace M6502 {
     // SHIFT/ROTATE INSTRUCTIONS
     // ====================================================================
 
-    void CPU::ASL_ACC(Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::ASL_ACC(Clock& cycles) {
         // Arithmetic Shift Left - Accumulator
         // Shift all bits left, bit 0 becomes 0, bit 7 goes to carry
         
@@ -21,7 +29,8 @@ namespace M6502 {
         UpdateZeroAndNegativeFlags(A);
     }
 
-    void CPU::ASL_MEM(Memory& memory, Cycles& cycles, Address address) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::ASL_MEM(Bus& memory, Clock& cycles, Address address) {
         // Arithmetic Shift Left - Memory
         Byte value = memory.ReadByte(address, cycles);
         SetFlag(FLAG_CARRY, (value & 0x80) != 0);
@@ -31,7 +40,8 @@ namespace M6502 {
         UpdateZeroAndNegativeFlags(value);
     }
 
-    void CPU::LSR_ACC(Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::LSR_ACC(Clock& cycles) {
         // Logical Shift Right - Accumulator
         // Shift all bits right, bit 7 becomes 0, bit 0 goes to carry
         
@@ -41,7 +51,8 @@ namespace M6502 {
         UpdateZeroAndNegativeFlags(A);
     }
 
-    void CPU::LSR_MEM(Memory& memory, Cycles& cycles, Address address) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::LSR_MEM(Bus& memory, Clock& cycles, Address address) {
         // Logical Shift Right - Memory
         Byte value = memory.ReadByte(address, cycles);
         SetFlag(FLAG_CARRY, (value & 0x01) != 0);
@@ -51,7 +62,8 @@ namespace M6502 {
         UpdateZeroAndNegativeFlags(value);
     }
 
-    void CPU::ROL_ACC(Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::ROL_ACC(Clock& cycles) {
         // Rotate Left - Accumulator
         // Rotate all bits left through carry
         // Old bit 7 -> Carry, Carry -> bit 0
@@ -63,7 +75,8 @@ namespace M6502 {
         UpdateZeroAndNegativeFlags(A);
     }
 
-    void CPU::ROL_MEM(Memory& memory, Cycles& cycles, Address address) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::ROL_MEM(Bus& memory, Clock& cycles, Address address) {
         // Rotate Left - Memory
         Byte value = memory.ReadByte(address, cycles);
         bool oldCarry = GetFlag(FLAG_CARRY);
@@ -74,7 +87,8 @@ namespace M6502 {
         UpdateZeroAndNegativeFlags(value);
     }
 
-    void CPU::ROR_ACC(Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::ROR_ACC(Clock& cycles) {
         // Rotate Right - Accumulator
         // Rotate all bits right through carry
         // Old bit 0 -> Carry, Carry -> bit 7
@@ -86,7 +100,8 @@ namespace M6502 {
         UpdateZeroAndNegativeFlags(A);
     }
 
-    void CPU::ROR_MEM(Memory& memory, Cycles& cycles, Address address) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::ROR_MEM(Bus& memory, Clock& cycles, Address address) {
         // Rotate Right - Memory
         Byte value = memory.ReadByte(address, cycles);
         bool oldCarry = GetFlag(FLAG_CARRY);
@@ -101,12 +116,14 @@ namespace M6502 {
     // JUMP/BRANCH INSTRUCTIONS
     // ====================================================================
 
-    void CPU::JMP(Word address) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::JMP(Bus& /* memory */, Clock& /* cycles */, Address address) {
         // Jump to address
         PC = address;
     }
 
-    void CPU::JSR(Memory& memory, Cycles& cycles, Address address) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::JSR(Bus& memory, Clock& cycles, Address address) {
         // Jump to Subroutine
         // Push return address (PC - 1) onto stack
         
@@ -120,7 +137,8 @@ namespace M6502 {
         PC = address;
     }
 
-    void CPU::RTS(Memory& memory, Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::RTS(Bus& memory, Clock& cycles) {
         // Return from Subroutine
         // Pull return address from stack and increment it
         
@@ -135,7 +153,8 @@ namespace M6502 {
         cycles++; // Extra cycle
     }
 
-    void CPU::RTI(Memory& memory, Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::RTI(Bus& memory, Clock& cycles) {
         // Return from Interrupt
         // Pull processor status, then PC from stack
         
@@ -149,23 +168,29 @@ namespace M6502 {
         PC = PopWordFromStack(memory, cycles);
     }
 
-    void CPU::BranchIf(Memory& memory, Cycles& cycles, bool condition) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::BranchIf(Bus& memory, Clock& cycles, bool condition) {
         // Branch helper function
         // Reads signed offset and branches if condition is true
         
         SignedByte offset = static_cast<SignedByte>(FetchByte(memory, cycles));
         
         if (condition) {
-            // Branch taken
-            cycles++; // Extra cycle for taken branch
-            
-            Address oldPC = PC;
-            PC += offset;
-            
-            // Extra cycle if page boundary crossed
-            if ((oldPC & 0xFF00) != (PC & 0xFF00)) {
-                cycles++;
-            }
+            TakeBranch(offset, cycles);
+        }
+    }
+
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::TakeBranch(SignedByte offset, Clock& cycles) {
+        // Branch taken
+        cycles++; // Extra cycle for taken branch
+        
+        Address oldPC = PC;
+        PC += offset;
+        
+        // Extra cycle if page boundary crossed
+        if ((oldPC & 0xFF00) != (PC & 0xFF00)) {
+            cycles++;
         }
     }
 
@@ -173,43 +198,50 @@ namespace M6502 {
     // FLAG INSTRUCTIONS
     // ====================================================================
 
-    void CPU::CLC(Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::CLC(Clock& cycles) {
         // Clear Carry
         SetFlag(FLAG_CARRY, false);
         cycles++;
     }
 
-    void CPU::CLD(Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::CLD(Clock& cycles) {
         // Clear Decimal
         SetFlag(FLAG_DECIMAL, false);
         cycles++;
     }
 
-    void CPU::CLI(Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::CLI(Clock& cycles) {
         // Clear Interrupt Disable
         SetFlag(FLAG_INTERRUPT, false);
         cycles++;
     }
 
-    void CPU::CLV(Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::CLV(Clock& cycles) {
         // Clear Overflow
         SetFlag(FLAG_OVERFLOW, false);
         cycles++;
     }
 
-    void CPU::SEC(Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::SEC(Clock& cycles) {
         // Set Carry
         SetFlag(FLAG_CARRY, true);
         cycles++;
     }
 
-    void CPU::SED(Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::SED(Clock& cycles) {
         // Set Decimal
         SetFlag(FLAG_DECIMAL, true);
         cycles++;
     }
 
-    void CPU::SEI(Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::SEI(Clock& cycles) {
         // Set Interrupt Disable
         SetFlag(FLAG_INTERRUPT, true);
         cycles++;
@@ -219,7 +251,8 @@ namespace M6502 {
     // SYSTEM INSTRUCTIONS
     // ====================================================================
 
-    void CPU::BRK(Memory& memory, Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::BRK(Bus& memory, Clock& cycles) {
         // Break - Software Interrupt
         
         // Increment PC (BRK is 2 bytes, but we only increment once here)
@@ -241,324 +274,1051 @@ namespace M6502 {
         PC = memory.ReadWord(VECTOR_IRQ_BRK, cycles);
     }
 
-    void CPU::NOP(Cycles& cycles) {
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::NOP(Clock& cycles) {
         // No Operation
         cycles++;
     }
 
     // ====================================================================
-    // MAIN EXECUTION LOOP
+    // INTERRUPTS
     // ====================================================================
 
-    Cycles CPU::Execute(Memory& memory) {
-        // Execute a single instruction
-        Cycles cyclesUsed = 0;
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::SetIRQ(bool asserted) {
+        if (asserted) {
+            pendingInterrupts |= IRQ_ASSERTED;
+        } else {
+            pendingInterrupts &= ~IRQ_ASSERTED;
+        }
+    }
+
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::SetNMI(bool asserted) {
+        // Only the released -> asserted edge latches an NMI
+        if (asserted && !nmiLine) {
+            pendingInterrupts |= NMI_LATCHED;
+        }
+        nmiLine = asserted;
+    }
+
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::SetProfiler(Profiler* attached) {
+        profiler = attached;
+        if (attached != nullptr) {
+            pendingInterrupts |= PROFILER_ATTACHED;
+        } else {
+            pendingInterrupts &= ~PROFILER_ATTACHED;
+        }
+    }
+
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::SetDebugger(Debugger* attached) {
+        debugger = attached;
+        if (attached != nullptr && attached->Armed()) {
+            pendingInterrupts |= DEBUGGER_ARMED;
+        } else {
+            pendingInterrupts &= ~DEBUGGER_ARMED;
+        }
+    }
+
+    template <typename Bus, typename Timing>
+    bool BasicCPU<Bus, Timing>::InterruptDue() const {
+        return (pendingInterrupts & NMI_LATCHED) != 0 ||
+               ((pendingInterrupts & IRQ_ASSERTED) != 0 && !GetFlag(FLAG_INTERRUPT));
+    }
+
+    template <typename Bus, typename Timing>
+    bool BasicCPU<Bus, Timing>::BoundaryDue() const {
+        return (pendingInterrupts & BATCH_END_REQUESTED) != 0 || InterruptDue();
+    }
+
+    template <typename Bus, typename Timing>
+    bool BasicCPU<Bus, Timing>::ServiceInterrupt(Bus& memory, Clock& cycles) {
+        // NMI has priority over IRQ
+        if (pendingInterrupts & NMI_LATCHED) {
+            pendingInterrupts &= ~NMI_LATCHED;
+            EnterInterrupt(memory, cycles, VECTOR_NMI);
+            return true;
+        }
+
+        if ((pendingInterrupts & IRQ_ASSERTED) && !GetFlag(FLAG_INTERRUPT)) {
+            EnterInterrupt(memory, cycles, VECTOR_IRQ_BRK);
+            return true;
+        }
+
+        return false;
+    }
+
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::EnterInterrupt(Bus& memory, Clock& cycles, Address vector) {
+        // Same sequence as BRK, 7 cycles in total, except that PC is not
+        // advanced and B is clear in the pushed status
+        cycles += 2; // Two internal cycles in place of the opcode fetch
         
-        // Fetch opcode
-        Byte opcode = FetchByte(memory, cyclesUsed);
+        // Push PC onto stack
+        PushWordToStack(memory, PC, cycles);
         
-        // Decode and execute instruction
+        // Push status register with B clear
+        Byte statusToStore = (P & ~FLAG_BREAK) | FLAG_UNUSED;
+        PushByteToStack(memory, statusToStore, cycles);
+        
+        // Mask further IRQs until the handler returns
+        SetFlag(FLAG_INTERRUPT, true);
+        
+        // Load PC from the vector
+        PC = memory.ReadWord(vector, cycles);
+    }
+
+    // ====================================================================
+    // DISPATCH TABLE
+    // ====================================================================
+
+    template <typename Bus, typename Timing>
+    template <AddressingMode Mode, bool PageCrossPenalty>
+    Address BasicCPU<Bus, Timing>::ResolveAddress(Bus& memory, Clock& cycles) {
+        // Resolved at compile time - each table entry calls exactly one helper
+        if constexpr (Mode == AddressingMode::Immediate) {
+            return AddrImmediate(memory, cycles);
+        } else if constexpr (Mode == AddressingMode::ZeroPage) {
+            return AddrZeroPage(memory, cycles);
+        } else if constexpr (Mode == AddressingMode::ZeroPageX) {
+            return AddrZeroPageX(memory, cycles);
+        } else if constexpr (Mode == AddressingMode::ZeroPageY) {
+            return AddrZeroPageY(memory, cycles);
+        } else if constexpr (Mode == AddressingMode::Absolute) {
+            return AddrAbsolute(memory, cycles);
+        } else if constexpr (Mode == AddressingMode::AbsoluteX) {
+            return AddrAbsoluteX(memory, cycles, PageCrossPenalty);
+        } else if constexpr (Mode == AddressingMode::AbsoluteY) {
+            return AddrAbsoluteY(memory, cycles, PageCrossPenalty);
+        } else if constexpr (Mode == AddressingMode::Indirect) {
+            return AddrIndirect(memory, cycles);
+        } else if constexpr (Mode == AddressingMode::IndexedIndirect) {
+            return AddrIndexedIndirect(memory, cycles);
+        } else {
+            static_assert(Mode == AddressingMode::IndirectIndexed,
+                          "Addressing mode does not resolve to a memory operand");
+            return AddrIndirectIndexed(memory, cycles, PageCrossPenalty);
+        }
+    }
+
+    template <typename Bus, typename Timing>
+    template <typename BasicCPU<Bus, Timing>::MemoryOperation Operation, AddressingMode Mode, bool PageCrossPenalty>
+    void BasicCPU<Bus, Timing>::ExecuteMemory(Bus& memory, Clock& cycles) {
+        Address address = ResolveAddress<Mode, PageCrossPenalty>(memory, cycles);
+        (this->*Operation)(memory, cycles, address);
+    }
+
+    template <typename Bus, typename Timing>
+    template <typename BasicCPU<Bus, Timing>::ImpliedOperation Operation>
+    void BasicCPU<Bus, Timing>::ExecuteImplied(Bus& /* memory */, Clock& cycles) {
+        (this->*Operation)(cycles);
+    }
+
+    template <typename Bus, typename Timing>
+    template <StatusFlags Flag, bool Expected>
+    void BasicCPU<Bus, Timing>::ExecuteBranch(Bus& memory, Clock& cycles) {
+        BranchIf(memory, cycles, GetFlag(Flag) == Expected);
+    }
+
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::ExecuteIllegal(Bus& /* memory */, Clock& cycles) {
+        // Unknown instruction - could throw exception or halt
+        // For now, treat as NOP and increment cycles
+        cycles++;
+    }
+
+    template <typename Bus, typename Timing>
+    constexpr std::array<typename BasicCPU<Bus, Timing>::Handler, 256> BasicCPU<Bus, Timing>::BuildDispatchTable() {
+        std::array<Handler, 256> table{};
+
+        for (auto& entry : table) {
+            entry = &BasicCPU::ExecuteIllegal;
+        }
+
+        #define M6502_TABLE_MEM(opcode, operation, mode, pageCross) \
+            table[opcode] = &BasicCPU::ExecuteMemory<&BasicCPU::operation, AddressingMode::mode, pageCross>;
+        #define M6502_TABLE_IMP(opcode, operation, mode) \
+            table[opcode] = &BasicCPU::ExecuteImplied<&BasicCPU::operation>;
+        #define M6502_TABLE_STK(opcode, operation) \
+            table[opcode] = &BasicCPU::operation;
+        #define M6502_TABLE_BRANCH(opcode, flag, expected) \
+            table[opcode] = &BasicCPU::ExecuteBranch<flag, expected>;
+
+        M6502_OPCODE_TABLE(M6502_TABLE_MEM, M6502_TABLE_IMP, M6502_TABLE_STK, M6502_TABLE_BRANCH)
+
+        #undef M6502_TABLE_MEM
+        #undef M6502_TABLE_IMP
+        #undef M6502_TABLE_STK
+        #undef M6502_TABLE_BRANCH
+
+        return table;
+    }
+
+    template <typename Bus, typename Timing>
+    const std::array<typename BasicCPU<Bus, Timing>::Handler, 256> BasicCPU<Bus, Timing>::DispatchTable =
+        BasicCPU<Bus, Timing>::BuildDispatchTable();
+
+    // ====================================================================
+    // MAIN EXECUTION LOOP
+    // ====================================================================
+
+    template <typename Bus, typename Timing>
+    Cycles BasicCPU<Bus, Timing>::Execute(Bus& memory) {
+        // Execute a single instruction, or an interrupt entry in its place.
+        // A batch of one: a pending batch end request is already satisfied.
+        Clock cyclesUsed{};
+        pendingInterrupts &= ~BATCH_END_REQUESTED;
+        if (!Step(memory, cyclesUsed)) {
+            // Stopped at a breakpoint; nothing ran
+            return 0;
+        }
+
+        // Update total cycle count
+        Cycles elapsed = Progress(cyclesUsed, 1);
+        TotalCycles += elapsed;
+        
+        return elapsed;
+    }
+
+    template <typename Bus, typename Timing>
+    Cycles BasicCPU<Bus, Timing>::Execute(Cycles cycles, Bus& memory) {
+        // Execute multiple instructions for specified number of cycles
+        return RunFor(cycles, memory);
+    }
+
+    // ====================================================================
+    // BATCH EXECUTION
+    // ====================================================================
+
+    template <typename Bus, typename Timing>
+    bool BasicCPU<Bus, Timing>::Step(Bus& memory, Clock& cycles) {
+#if M6502_TRACE
+        if (trace != nullptr) {
+            if (pendingInterrupts & BATCH_END_REQUESTED) {
+                return false;
+            }
+            return InstrumentedStep(memory, cycles);
+        }
+#endif
+
+        if (pendingInterrupts != 0) {
+            if (pendingInterrupts & BATCH_END_REQUESTED) {
+                return false;
+            }
+            if (pendingInterrupts & ATTACHMENTS) {
+                return InstrumentedStep(memory, cycles);
+            }
+            if (ServiceInterrupt(memory, cycles)) {
+                return true;
+            }
+        }
+
+        Byte opcode = FetchByte(memory, cycles);
+        (this->*DispatchTable[opcode])(memory, cycles);
+        return true;
+    }
+
+    template <typename Bus, typename Timing>
+    bool BasicCPU<Bus, Timing>::DebuggerStops(Bus& memory) {
+        debugger->BeginInstruction(PC);
+
+        // One bit test unless PC's page has an execute point. A due
+        // interrupt is entered first; the instruction is checked when the
+        // handler returns to it.
+        if (!debugger->ExecuteWatched(PC) || InterruptDue()) {
+            return false;
+        }
+
+        const Registers registers{ PC, A, X, Y, SP, static_cast<Byte>(P) };
+        if (!debugger->OnExecute(registers, memory.ReadByteNoCycles(PC))) {
+            return false;
+        }
+
+        // Keep the rest of the batch from running past the stop
+        pendingInterrupts |= BATCH_END_REQUESTED;
+        return true;
+    }
+
+    template <typename Bus, typename Timing>
+    bool BasicCPU<Bus, Timing>::BranchTaken(Byte opcode) const {
+        // A taken branch to the next instruction leaves PC where a branch
+        // not taken would, so test the condition rather than PC
         switch (opcode) {
-            // ============================================================
-            // LDA - Load Accumulator
-            // ============================================================
-            case INS_LDA_IM:   LDA(memory, cyclesUsed, AddrImmediate(memory, cyclesUsed)); break;
-            case INS_LDA_ZP:   LDA(memory, cyclesUsed, AddrZeroPage(memory, cyclesUsed)); break;
-            case INS_LDA_ZPX:  LDA(memory, cyclesUsed, AddrZeroPageX(memory, cyclesUsed)); break;
-            case INS_LDA_ABS:  LDA(memory, cyclesUsed, AddrAbsolute(memory, cyclesUsed)); break;
-            case INS_LDA_ABSX: LDA(memory, cyclesUsed, AddrAbsoluteX(memory, cyclesUsed)); break;
-            case INS_LDA_ABSY: LDA(memory, cyclesUsed, AddrAbsoluteY(memory, cyclesUsed)); break;
-            case INS_LDA_INDX: LDA(memory, cyclesUsed, AddrIndexedIndirect(memory, cyclesUsed)); break;
-            case INS_LDA_INDY: LDA(memory, cyclesUsed, AddrIndirectIndexed(memory, cyclesUsed)); break;
-            
-            // ============================================================
-            // LDX - Load X Register
-            // ============================================================
-            case INS_LDX_IM:   LDX(memory, cyclesUsed, AddrImmediate(memory, cyclesUsed)); break;
-            case INS_LDX_ZP:   LDX(memory, cyclesUsed, AddrZeroPage(memory, cyclesUsed)); break;
-            case INS_LDX_ZPY:  LDX(memory, cyclesUsed, AddrZeroPageY(memory, cyclesUsed)); break;
-            case INS_LDX_ABS:  LDX(memory, cyclesUsed, AddrAbsolute(memory, cyclesUsed)); break;
-            case INS_LDX_ABSY: LDX(memory, cyclesUsed, AddrAbsoluteY(memory, cyclesUsed)); break;
-            
-            // ============================================================
-            // LDY - Load Y Register
-            // ============================================================
-            case INS_LDY_IM:   LDY(memory, cyclesUsed, AddrImmediate(memory, cyclesUsed)); break;
-            case INS_LDY_ZP:   LDY(memory, cyclesUsed, AddrZeroPage(memory, cyclesUsed)); break;
-            case INS_LDY_ZPX:  LDY(memory, cyclesUsed, AddrZeroPageX(memory, cyclesUsed)); break;
-            case INS_LDY_ABS:  LDY(memory, cyclesUsed, AddrAbsolute(memory, cyclesUsed)); break;
-            case INS_LDY_ABSX: LDY(memory, cyclesUsed, AddrAbsoluteX(memory, cyclesUsed)); break;
-            
-            // ============================================================
-            // STA - Store Accumulator
-            // ============================================================
-            case INS_STA_ZP:   STA(memory, cyclesUsed, AddrZeroPage(memory, cyclesUsed)); break;
-            case INS_STA_ZPX:  STA(memory, cyclesUsed, AddrZeroPageX(memory, cyclesUsed)); break;
-            case INS_STA_ABS:  STA(memory, cyclesUsed, AddrAbsolute(memory, cyclesUsed)); break;
-            case INS_STA_ABSX: STA(memory, cyclesUsed, AddrAbsoluteX(memory, cyclesUsed, false)); break;
-            case INS_STA_ABSY: STA(memory, cyclesUsed, AddrAbsoluteY(memory, cyclesUsed, false)); break;
-            case INS_STA_INDX: STA(memory, cyclesUsed, AddrIndexedIndirect(memory, cyclesUsed)); break;
-            case INS_STA_INDY: STA(memory, cyclesUsed, AddrIndirectIndexed(memory, cyclesUsed, false)); break;
-            
-            // ============================================================
-            // STX - Store X Register
-            // ============================================================
-            case INS_STX_ZP:   STX(memory, cyclesUsed, AddrZeroPage(memory, cyclesUsed)); break;
-            case INS_STX_ZPY:  STX(memory, cyclesUsed, AddrZeroPageY(memory, cyclesUsed)); break;
-            case INS_STX_ABS:  STX(memory, cyclesUsed, AddrAbsolute(memory, cyclesUsed)); break;
-            
-            // ============================================================
-            // STY - Store Y Register
-            // ============================================================
-            case INS_STY_ZP:   STY(memory, cyclesUsed, AddrZeroPage(memory, cyclesUsed)); break;
-            case INS_STY_ZPX:  STY(memory, cyclesUsed, AddrZeroPageX(memory, cyclesUsed)); break;
-            case INS_STY_ABS:  STY(memory, cyclesUsed, AddrAbsolute(memory, cyclesUsed)); break;
-            
-            // ============================================================
-            // Register Transfers
-            // ============================================================
-            case INS_TAX: TAX(cyclesUsed); break;
-            case INS_TAY: TAY(cyclesUsed); break;
-            case INS_TXA: TXA(cyclesUsed); break;
-            case INS_TYA: TYA(cyclesUsed); break;
-            case INS_TSX: TSX(cyclesUsed); break;
-            case INS_TXS: TXS(cyclesUsed); break;
-            
-            // ============================================================
-            // Stack Operations
-            // ============================================================
-            case INS_PHA: PHA(memory, cyclesUsed); break;
-            case INS_PHP: PHP(memory, cyclesUsed); break;
-            case INS_PLA: PLA(memory, cyclesUsed); break;
-            case INS_PLP: PLP(memory, cyclesUsed); break;
-            
-            // ============================================================
-            // Logical Operations - AND
-            // ============================================================
-            case INS_AND_IM:   AND(memory, cyclesUsed, AddrImmediate(memory, cyclesUsed)); break;
-            case INS_AND_ZP:   AND(memory, cyclesUsed, AddrZeroPage(memory, cyclesUsed)); break;
-            case INS_AND_ZPX:  AND(memory, cyclesUsed, AddrZeroPageX(memory, cyclesUsed)); break;
-            case INS_AND_ABS:  AND(memory, cyclesUsed, AddrAbsolute(memory, cyclesUsed)); break;
-            case INS_AND_ABSX: AND(memory, cyclesUsed, AddrAbsoluteX(memory, cyclesUsed)); break;
-            case INS_AND_ABSY: AND(memory, cyclesUsed, AddrAbsoluteY(memory, cyclesUsed)); break;
-            case INS_AND_INDX: AND(memory, cyclesUsed, AddrIndexedIndirect(memory, cyclesUsed)); break;
-            case INS_AND_INDY: AND(memory, cyclesUsed, AddrIndirectIndexed(memory, cyclesUsed)); break;
-            
-            // ============================================================
-            // Logical Operations - ORA
-            // ============================================================
-            case INS_ORA_IM:   ORA(memory, cyclesUsed, AddrImmediate(memory, cyclesUsed)); break;
-            case INS_ORA_ZP:   ORA(memory, cyclesUsed, AddrZeroPage(memory, cyclesUsed)); break;
-            case INS_ORA_ZPX:  ORA(memory, cyclesUsed, AddrZeroPageX(memory, cyclesUsed)); break;
-            case INS_ORA_ABS:  ORA(memory, cyclesUsed, AddrAbsolute(memory, cyclesUsed)); break;
-            case INS_ORA_ABSX: ORA(memory, cyclesUsed, AddrAbsoluteX(memory, cyclesUsed)); break;
-            case INS_ORA_ABSY: ORA(memory, cyclesUsed, AddrAbsoluteY(memory, cyclesUsed)); break;
-            case INS_ORA_INDX: ORA(memory, cyclesUsed, AddrIndexedIndirect(memory, cyclesUsed)); break;
-            case INS_ORA_INDY: ORA(memory, cyclesUsed, AddrIndirectIndexed(memory, cyclesUsed)); break;
-            
-            // ============================================================
-            // Logical Operations - EOR
-            // ============================================================
-            case INS_EOR_IM:   EOR(memory, cyclesUsed, AddrImmediate(memory, cyclesUsed)); break;
-            case INS_EOR_ZP:   EOR(memory, cyclesUsed, AddrZeroPage(memory, cyclesUsed)); break;
-            case INS_EOR_ZPX:  EOR(memory, cyclesUsed, AddrZeroPageX(memory, cyclesUsed)); break;
-            case INS_EOR_ABS:  EOR(memory, cyclesUsed, AddrAbsolute(memory, cyclesUsed)); break;
-            case INS_EOR_ABSX: EOR(memory, cyclesUsed, AddrAbsoluteX(memory, cyclesUsed)); break;
-            case INS_EOR_ABSY: EOR(memory, cyclesUsed, AddrAbsoluteY(memory, cyclesUsed)); break;
-            case INS_EOR_INDX: EOR(memory, cyclesUsed, AddrIndexedIndirect(memory, cyclesUsed)); break;
-            case INS_EOR_INDY: EOR(memory, cyclesUsed, AddrIndirectIndexed(memory, cyclesUsed)); break;
-            
-            // ============================================================
-            // BIT Test
-            // ============================================================
-            case INS_BIT_ZP:  BIT(memory, cyclesUsed, AddrZeroPage(memory, cyclesUsed)); break;
-            case INS_BIT_ABS: BIT(memory, cyclesUsed, AddrAbsolute(memory, cyclesUsed)); break;
-            
-            // ============================================================
-            // Arithmetic - ADC
-            // ============================================================
-            case INS_ADC_IM:   ADC(memory, cyclesUsed, AddrImmediate(memory, cyclesUsed)); break;
-            case INS_ADC_ZP:   ADC(memory, cyclesUsed, AddrZeroPage(memory, cyclesUsed)); break;
-            case INS_ADC_ZPX:  ADC(memory, cyclesUsed, AddrZeroPageX(memory, cyclesUsed)); break;
-            case INS_ADC_ABS:  ADC(memory, cyclesUsed, AddrAbsolute(memory, cyclesUsed)); break;
-            case INS_ADC_ABSX: ADC(memory, cyclesUsed, AddrAbsoluteX(memory, cyclesUsed)); break;
-            case INS_ADC_ABSY: ADC(memory, cyclesUsed, AddrAbsoluteY(memory, cyclesUsed)); break;
-            case INS_ADC_INDX: ADC(memory, cyclesUsed, AddrIndexedIndirect(memory, cyclesUsed)); break;
-            case INS_ADC_INDY: ADC(memory, cyclesUsed, AddrIndirectIndexed(memory, cyclesUsed)); break;
-            
-            // ============================================================
-            // Arithmetic - SBC
-            // ============================================================
-            case INS_SBC_IM:   SBC(memory, cyclesUsed, AddrImmediate(memory, cyclesUsed)); break;
-            case INS_SBC_ZP:   SBC(memory, cyclesUsed, AddrZeroPage(memory, cyclesUsed)); break;
-            case INS_SBC_ZPX:  SBC(memory, cyclesUsed, AddrZeroPageX(memory, cyclesUsed)); break;
-            case INS_SBC_ABS:  SBC(memory, cyclesUsed, AddrAbsolute(memory, cyclesUsed)); break;
-            case INS_SBC_ABSX: SBC(memory, cyclesUsed, AddrAbsoluteX(memory, cyclesUsed)); break;
-            case INS_SBC_ABSY: SBC(memory, cyclesUsed, AddrAbsoluteY(memory, cyclesUsed)); break;
-            case INS_SBC_INDX: SBC(memory, cyclesUsed, AddrIndexedIndirect(memory, cyclesUsed)); break;
-            case INS_SBC_INDY: SBC(memory, cyclesUsed, AddrIndirectIndexed(memory, cyclesUsed)); break;
-            
-            // ============================================================
-            // Compare - CMP
-            // ============================================================
-            case INS_CMP_IM:   CMP(memory, cyclesUsed, AddrImmediate(memory, cyclesUsed)); break;
-            case INS_CMP_ZP:   CMP(memory, cyclesUsed, AddrZeroPage(memory, cyclesUsed)); break;
-            case INS_CMP_ZPX:  CMP(memory, cyclesUsed, AddrZeroPageX(memory, cyclesUsed)); break;
-            case INS_CMP_ABS:  CMP(memory, cyclesUsed, AddrAbsolute(memory, cyclesUsed)); break;
-            case INS_CMP_ABSX: CMP(memory, cyclesUsed, AddrAbsoluteX(memory, cyclesUsed)); break;
-            case INS_CMP_ABSY: CMP(memory, cyclesUsed, AddrAbsoluteY(memory, cyclesUsed)); break;
-            case INS_CMP_INDX: CMP(memory, cyclesUsed, AddrIndexedIndirect(memory, cyclesUsed)); break;
-            case INS_CMP_INDY: CMP(memory, cyclesUsed, AddrIndirectIndexed(memory, cyclesUsed)); break;
-            
-            // ============================================================
-            // Compare - CPX, CPY
-            // ============================================================
-            case INS_CPX_IM:  CPX(memory, cyclesUsed, AddrImmediate(memory, cyclesUsed)); break;
-            case INS_CPX_ZP:  CPX(memory, cyclesUsed, AddrZeroPage(memory, cyclesUsed)); break;
-            case INS_CPX_ABS: CPX(memory, cyclesUsed, AddrAbsolute(memory, cyclesUsed)); break;
-            
-            case INS_CPY_IM:  CPY(memory, cyclesUsed, AddrImmediate(memory, cyclesUsed)); break;
-            case INS_CPY_ZP:  CPY(memory, cyclesUsed, AddrZeroPage(memory, cyclesUsed)); break;
-            case INS_CPY_ABS: CPY(memory, cyclesUsed, AddrAbsolute(memory, cyclesUsed)); break;
-            
-            // ============================================================
-            // Increment/Decrement
-            // ============================================================
-            case INS_INC_ZP:   INC(memory, cyclesUsed, AddrZeroPage(memory, cyclesUsed)); break;
-            case INS_INC_ZPX:  INC(memory, cyclesUsed, AddrZeroPageX(memory, cyclesUsed)); break;
-            case INS_INC_ABS:  INC(memory, cyclesUsed, AddrAbsolute(memory, cyclesUsed)); break;
-            case INS_INC_ABSX: INC(memory, cyclesUsed, AddrAbsoluteX(memory, cyclesUsed, false)); break;
-            
-            case INS_INX: INX(cyclesUsed); break;
-            case INS_INY: INY(cyclesUsed); break;
-            
-            case INS_DEC_ZP:   DEC(memory, cyclesUsed, AddrZeroPage(memory, cyclesUsed)); break;
-            case INS_DEC_ZPX:  DEC(memory, cyclesUsed, AddrZeroPageX(memory, cyclesUsed)); break;
-            case INS_DEC_ABS:  DEC(memory, cyclesUsed, AddrAbsolute(memory, cyclesUsed)); break;
-            case INS_DEC_ABSX: DEC(memory, cyclesUsed, AddrAbsoluteX(memory, cyclesUsed, false)); break;
-            
-            case INS_DEX: DEX(cyclesUsed); break;
-            case INS_DEY: DEY(cyclesUsed); break;
-            
-            // ============================================================
-            // Shifts and Rotates
-            // ============================================================
-            case INS_ASL_ACC:  ASL_ACC(cyclesUsed); break;
-            case INS_ASL_ZP:   ASL_MEM(memory, cyclesUsed, AddrZeroPage(memory, cyclesUsed)); break;
-            case INS_ASL_ZPX:  ASL_MEM(memory, cyclesUsed, AddrZeroPageX(memory, cyclesUsed)); break;
-            case INS_ASL_ABS:  ASL_MEM(memory, cyclesUsed, AddrAbsolute(memory, cyclesUsed)); break;
-            case INS_ASL_ABSX: ASL_MEM(memory, cyclesUsed, AddrAbsoluteX(memory, cyclesUsed, false)); break;
-            
-            case INS_LSR_ACC:  LSR_ACC(cyclesUsed); break;
-            case INS_LSR_ZP:   LSR_MEM(memory, cyclesUsed, AddrZeroPage(memory, cyclesUsed)); break;
-            case INS_LSR_ZPX:  LSR_MEM(memory, cyclesUsed, AddrZeroPageX(memory, cyclesUsed)); break;
-            case INS_LSR_ABS:  LSR_MEM(memory, cyclesUsed, AddrAbsolute(memory, cyclesUsed)); break;
-            case INS_LSR_ABSX: LSR_MEM(memory, cyclesUsed, AddrAbsoluteX(memory, cyclesUsed, false)); break;
-            
-            case INS_ROL_ACC:  ROL_ACC(cyclesUsed); break;
-            case INS_ROL_ZP:   ROL_MEM(memory, cyclesUsed, AddrZeroPage(memory, cyclesUsed)); break;
-            case INS_ROL_ZPX:  ROL_MEM(memory, cyclesUsed, AddrZeroPageX(memory, cyclesUsed)); break;
-            case INS_ROL_ABS:  ROL_MEM(memory, cyclesUsed, AddrAbsolute(memory, cyclesUsed)); break;
-            case INS_ROL_ABSX: ROL_MEM(memory, cyclesUsed, AddrAbsoluteX(memory, cyclesUsed, false)); break;
-            
-            case INS_ROR_ACC:  ROR_ACC(cyclesUsed); break;
-            case INS_ROR_ZP:   ROR_MEM(memory, cyclesUsed, AddrZeroPage(memory, cyclesUsed)); break;
-            case INS_ROR_ZPX:  ROR_MEM(memory, cyclesUsed, AddrZeroPageX(memory, cyclesUsed)); break;
-            case INS_ROR_ABS:  ROR_MEM(memory, cyclesUsed, AddrAbsolute(memory, cyclesUsed)); break;
-            case INS_ROR_ABSX: ROR_MEM(memory, cyclesUsed, AddrAbsoluteX(memory, cyclesUsed, false)); break;
-            
-            // ============================================================
-            // Jumps and Calls
-            // ============================================================
-            case INS_JMP_ABS: {
-                Address addr = AddrAbsolute(memory, cyclesUsed);
-                JMP(addr);
-                break;
+            #define M6502_TAKEN_MEM(opcode, operation, mode, pageCross)
+            #define M6502_TAKEN_IMP(opcode, operation, mode)
+            #define M6502_TAKEN_STK(opcode, operation)
+            #define M6502_TAKEN_BRANCH(opcode, flag, expected) \
+                case opcode: return GetFlag(flag) == expected;
+
+            M6502_OPCODE_TABLE(M6502_TAKEN_MEM, M6502_TAKEN_IMP, M6502_TAKEN_STK, M6502_TAKEN_BRANCH)
+
+            #undef M6502_TAKEN_MEM
+            #undef M6502_TAKEN_IMP
+            #undef M6502_TAKEN_STK
+            #undef M6502_TAKEN_BRANCH
+
+            default:
+                return false;
+        }
+    }
+
+    template <typename Bus, typename Timing>
+    bool BasicCPU<Bus, Timing>::PaysPageCross(const Bus& memory, Byte opcode) const {
+        // Base and index as ResolveAbsoluteIndexed() will get them; the
+        // operand follows the opcode at PC
+        auto crosses = [this, &memory](AddressingMode mode) {
+            const Byte low = memory.ReadByteNoCycles(static_cast<Address>(PC + 1));
+            Address base;
+            Byte index;
+            switch (mode) {
+                case AddressingMode::AbsoluteX:
+                case AddressingMode::AbsoluteY:
+                    base = static_cast<Address>(
+                        low | (memory.ReadByteNoCycles(static_cast<Address>(PC + 2)) << 8));
+                    index = mode == AddressingMode::AbsoluteX ? X : Y;
+                    break;
+                case AddressingMode::IndirectIndexed:
+                    base = static_cast<Address>(memory.ReadByteNoCycles(low) |
+                        (memory.ReadByteNoCycles(static_cast<Byte>(low + 1)) << 8));
+                    index = Y;
+                    break;
+                default:
+                    return false;
             }
-            case INS_JMP_IND: {
-                // Indirect addressing for JMP
-                Address indirectAddr = FetchWord(memory, cyclesUsed);
-                
-                // Note: 6502 has a bug with indirect JMP across page boundaries
-                // If address is $xxFF, it wraps within the page
-                if ((indirectAddr & 0x00FF) == 0x00FF) {
-                    // Page boundary bug
-                    Byte lowByte = memory.ReadByte(indirectAddr, cyclesUsed);
-                    Byte highByte = memory.ReadByte(indirectAddr & 0xFF00, cyclesUsed);
-                    Address targetAddr = (static_cast<Address>(highByte) << 8) | lowByte;
-                    JMP(targetAddr);
-                } else {
-                    // Normal case
-                    Address targetAddr = memory.ReadWord(indirectAddr, cyclesUsed);
-                    JMP(targetAddr);
-                }
+            return (base & 0xFF00) != (static_cast<Address>(base + index) & 0xFF00);
+        };
+
+        switch (opcode) {
+            #define M6502_CROSS_MEM(opcode, operation, mode, pageCross) \
+                case opcode: return pageCross && crosses(AddressingMode::mode);
+            #define M6502_CROSS_IMP(opcode, operation, mode)
+            #define M6502_CROSS_STK(opcode, operation)
+            #define M6502_CROSS_BRANCH(opcode, flag, expected)
+
+            M6502_OPCODE_TABLE(M6502_CROSS_MEM, M6502_CROSS_IMP, M6502_CROSS_STK, M6502_CROSS_BRANCH)
+
+            #undef M6502_CROSS_MEM
+            #undef M6502_CROSS_IMP
+            #undef M6502_CROSS_STK
+            #undef M6502_CROSS_BRANCH
+
+            default:
+                return false;
+        }
+    }
+
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::ReportWatchedReads(Memory& memory) {
+        // The same decision InstrumentedStep() is about to make: an
+        // interrupt entry reads only its vector (the pushes are writes)
+        if (InterruptDue()) {
+            const Address vector = (pendingInterrupts & NMI_LATCHED) ? VECTOR_NMI : VECTOR_IRQ_BRK;
+            memory.ReportRead(vector);
+            memory.ReportRead(static_cast<Address>(vector + 1));
+            return;
+        }
+
+        const ReadPlan& plan = ReadPlans[memory.ReadByteNoCycles(PC)];
+        for (Byte i = 0; i < plan.length; i++) {
+            memory.ReportRead(static_cast<Address>(PC + i));
+        }
+
+        // Resolve the operand as the addressing helpers will, reporting
+        // the pointer bytes they read on the way
+        auto pointer = [&memory](Address low, Address high) {
+            memory.ReportRead(low);
+            memory.ReportRead(high);
+            return static_cast<Address>(memory.ReadByteNoCycles(low) |
+                                        (memory.ReadByteNoCycles(high) << 8));
+        };
+        const Byte zp = memory.ReadByteNoCycles(static_cast<Address>(PC + 1));
+        const Address absolute = static_cast<Address>(
+            zp | (memory.ReadByteNoCycles(static_cast<Address>(PC + 2)) << 8));
+        Address address = 0;
+        switch (plan.mode) {
+            case AddressingMode::ZeroPage:  address = zp; break;
+            case AddressingMode::ZeroPageX: address = static_cast<Byte>(zp + X); break;
+            case AddressingMode::ZeroPageY: address = static_cast<Byte>(zp + Y); break;
+            case AddressingMode::Absolute:  address = absolute; break;
+            case AddressingMode::AbsoluteX: address = static_cast<Address>(absolute + X); break;
+            case AddressingMode::AbsoluteY: address = static_cast<Address>(absolute + Y); break;
+            case AddressingMode::Indirect:
+                // JMP ($xxFF) takes its high byte from $xx00
+                address = pointer(absolute, static_cast<Address>((absolute & 0xFF00) | ((absolute + 1) & 0x00FF)));
+                break;
+            case AddressingMode::IndexedIndirect: {
+                const Byte at = static_cast<Byte>(zp + X);
+                address = pointer(at, static_cast<Byte>(at + 1));
                 break;
             }
-            
-            case INS_JSR: {
-                Address addr = AddrAbsolute(memory, cyclesUsed);
-                JSR(memory, cyclesUsed, addr);
+            case AddressingMode::IndirectIndexed:
+                address = static_cast<Address>(pointer(zp, static_cast<Byte>(zp + 1)) + Y);
+                break;
+            default:
                 break;
+        }
+        if (plan.readsOperand) {
+            memory.ReportRead(address);
+        }
+
+        for (Byte i = 1; i <= plan.pulls; i++) {
+            memory.ReportRead(static_cast<Address>(STACK_BASE + static_cast<Byte>(SP + i)));
+        }
+        if (plan.readsBRKVector) {
+            memory.ReportRead(VECTOR_IRQ_BRK);
+            memory.ReportRead(static_cast<Address>(VECTOR_IRQ_BRK + 1));
+        }
+    }
+
+    template <typename Bus, typename Timing>
+    bool BasicCPU<Bus, Timing>::InstrumentedStep(Bus& memory, Clock& cycles) {
+        if ((pendingInterrupts & DEBUGGER_ARMED) && DebuggerStops(memory)) {
+            return false;
+        }
+
+        const Word pc = PC;
+        const Clock start = cycles;
+
+#if M6502_TRACE
+        // Registers before the instruction, as a reference log shows them
+        TraceRecord record;
+        record.PC = PC;
+        record.opcode = 0;
+        record.A = A;
+        record.X = X;
+        record.Y = Y;
+        record.SP = SP;
+        record.P = P;
+        record.kind = TRACE_INSTRUCTION;
+#endif
+
+        if constexpr (std::is_same_v<Bus, Memory>) {
+            if (memory.ReadsWatched()) {
+                ReportWatchedReads(memory);
             }
-            
-            case INS_RTS: RTS(memory, cyclesUsed); break;
-            case INS_RTI: RTI(memory, cyclesUsed); break;
-            
-            // ============================================================
-            // Branches
-            // ============================================================
-            case INS_BCC: BranchIf(memory, cyclesUsed, !GetFlag(FLAG_CARRY)); break;
-            case INS_BCS: BranchIf(memory, cyclesUsed, GetFlag(FLAG_CARRY)); break;
-            case INS_BEQ: BranchIf(memory, cyclesUsed, GetFlag(FLAG_ZERO)); break;
-            case INS_BMI: BranchIf(memory, cyclesUsed, GetFlag(FLAG_NEGATIVE)); break;
-            case INS_BNE: BranchIf(memory, cyclesUsed, !GetFlag(FLAG_ZERO)); break;
-            case INS_BPL: BranchIf(memory, cyclesUsed, !GetFlag(FLAG_NEGATIVE)); break;
-            case INS_BVC: BranchIf(memory, cyclesUsed, !GetFlag(FLAG_OVERFLOW)); break;
-            case INS_BVS: BranchIf(memory, cyclesUsed, GetFlag(FLAG_OVERFLOW)); break;
-            
-            // ============================================================
-            // Status Flag Changes
-            // ============================================================
-            case INS_CLC: CLC(cyclesUsed); break;
-            case INS_CLD: CLD(cyclesUsed); break;
-            case INS_CLI: CLI(cyclesUsed); break;
-            case INS_CLV: CLV(cyclesUsed); break;
-            case INS_SEC: SEC(cyclesUsed); break;
-            case INS_SED: SED(cyclesUsed); break;
-            case INS_SEI: SEI(cyclesUsed); break;
-            
-            // ============================================================
-            // System
-            // ============================================================
-            case INS_BRK: BRK(memory, cyclesUsed); break;
-            case INS_NOP: NOP(cyclesUsed); break;
-            
-            // ============================================================
-            // Unknown Opcode
-            // ============================================================
+        }
+
+        bool interrupt = false;
+        Byte opcode = 0;
+        if ((pendingInterrupts & ~ATTACHMENTS) != 0 && ServiceInterrupt(memory, cycles)) {
+            interrupt = true;
+        } else {
+            // Like taken branches below, page crosses are found here so
+            // the addressing helpers every path shares carry no hook
+            if (profiler != nullptr && PaysPageCross(memory, memory.ReadByteNoCycles(PC))) {
+                profiler->OnPageCross();
+            }
+            opcode = FetchByte(memory, cycles);
+            (this->*DispatchTable[opcode])(memory, cycles);
+        }
+
+        // The functional core has no cycles; an instruction costs one
+        Cycles cost = 1;
+        if constexpr (Timing::COUNTS_CYCLES) {
+            cost = cycles - start;
+        }
+
+        if (profiler != nullptr) {
+            if (interrupt) {
+                profiler->OnInterrupt(cost, PC);
+            } else {
+                // Counted here rather than in TakeBranch(), which the
+                // uninstrumented paths share. Branches leave the flags
+                // alone, so the condition still reads as it did.
+                if (BranchTaken(opcode)) {
+                    profiler->OnBranchTaken();
+                }
+                profiler->OnInstruction(pc, opcode, cost, PC);
+            }
+        }
+
+#if M6502_TRACE
+        if (trace != nullptr) {
+            record.opcode = opcode;
+            record.kind = interrupt ? TRACE_INTERRUPT : TRACE_INSTRUCTION;
+            record.cycles = Timing::COUNTS_CYCLES ? static_cast<Byte>(cost) : 0;
+            trace->Write(record);
+        }
+#endif
+        return true;
+    }
+
+    template <typename Bus, typename Timing>
+    Cycles BasicCPU<Bus, Timing>::RunFor(Cycles budget, Bus& memory) {
+#if M6502_COMPUTED_GOTO && M6502_HAS_COMPUTED_GOTO
+        return ExecuteThreaded(budget, memory);
+#else
+        // The counter lives in this frame for the whole batch instead of
+        // being zeroed, returned and added to TotalCycles per instruction
+        Clock cycles{};
+        Cycles steps = 0;
+        pendingInterrupts &= ~BATCH_END_REQUESTED;
+
+        while (Progress(cycles, steps) < budget && Step(memory, cycles)) {
+            steps++;
+        }
+
+        // One commit per batch
+        Cycles elapsed = Progress(cycles, steps);
+        TotalCycles += elapsed;
+
+        return elapsed;
+#endif
+    }
+
+#if M6502_HAS_COMPUTED_GOTO
+    template <typename Bus, typename Timing>
+    Cycles BasicCPU<Bus, Timing>::ExecuteThreaded(Cycles cycles, Bus& memory) {
+        // The handlers have no profiler or debugger hooks; step through Step()
+        if ((pendingInterrupts & ATTACHMENTS) != 0) {
+            return RunUntil(memory, cycles, [](const BasicCPU&) { return false; });
+        }
+
+#if M6502_TRACE
+        // A trace alone is written from the dispatch itself
+        if (trace != nullptr) {
+            return RunThreaded<true>(cycles, memory);
+        }
+#endif
+        return RunThreaded<false>(cycles, memory);
+    }
+
+    template <typename Bus, typename Timing>
+    template <bool Traced>
+    Cycles BasicCPU<Bus, Timing>::RunThreaded(Cycles cycles, Bus& memory) {
+        // Threaded interpreter: every handler ends with its own indirect
+        // jump to the next one, so the branch predictor sees one jump site
+        // per opcode instead of a single shared one. Handlers come from the
+        // same constexpr table, indexed by constants, so each call is direct.
+        static constexpr std::array<Handler, 256> handlers = BuildDispatchTable();
+
+        #define M6502_LABEL_ADDRESS(opcode) &&op_##opcode,
+        static void* const labels[256] = { M6502_ALL_OPCODES(M6502_LABEL_ADDRESS) };
+        #undef M6502_LABEL_ADDRESS
+
+        Clock cyclesExecuted{};
+        Cycles steps = 0;
+        Byte opcode;
+        pendingInterrupts &= ~BATCH_END_REQUESTED;
+
+#if M6502_TRACE
+        // The same records InstrumentedStep() writes: registers before
+        // the step, then its opcode, kind and cost once it has run. They
+        // collect here and reach the ring TRACE_BATCH at a time, so the
+        // loop does not touch the ring's indices on every step.
+        constexpr std::size_t TRACE_BATCH = 64;
+        TraceBuffer* const buffer = trace;
+        TraceRecord pending[Traced ? TRACE_BATCH : 1];
+        std::size_t pendingCount = 0;
+        Clock traceStart{};
+
+        #define M6502_TRACE_BEGIN()                                 \
+            if constexpr (Traced) {                                 \
+                TraceRecord& record = pending[pendingCount];        \
+                record.PC = PC;                                     \
+                record.A = A;                                       \
+                record.X = X;                                       \
+                record.Y = Y;                                       \
+                record.SP = SP;                                     \
+                record.P = P;                                       \
+                traceStart = cyclesExecuted;                        \
+            }
+
+        #define M6502_TRACE_END(traceOpcode, traceKind)             \
+            if constexpr (Traced) {                                 \
+                TraceRecord& record = pending[pendingCount];        \
+                record.opcode = traceOpcode;                        \
+                record.kind = traceKind;                            \
+                record.cycles = 0;                                  \
+                if constexpr (Timing::COUNTS_CYCLES) {              \
+                    record.cycles = static_cast<Byte>(cyclesExecuted - traceStart); \
+                }                                                   \
+                if (++pendingCount == TRACE_BATCH) {                \
+                    buffer->Write(pending, pendingCount);           \
+                    pendingCount = 0;                               \
+                }                                                   \
+            }
+
+        #define M6502_TRACE_FLUSH()                                 \
+            if constexpr (Traced) {                                 \
+                buffer->Write(pending, pendingCount);               \
+            }
+#else
+        #define M6502_TRACE_BEGIN()
+        #define M6502_TRACE_END(traceOpcode, traceKind)
+        #define M6502_TRACE_FLUSH()
+#endif
+
+        #define M6502_DISPATCH_NEXT()                               \
+            if (Progress(cyclesExecuted, steps) >= cycles) {        \
+                goto batch_done;                                    \
+            }                                                       \
+            M6502_TRACE_BEGIN()                                     \
+            if (pendingInterrupts != 0) {                           \
+                if (pendingInterrupts & BATCH_END_REQUESTED) {      \
+                    goto batch_done;                                \
+                }                                                   \
+                if (ServiceInterrupt(memory, cyclesExecuted)) {     \
+                    goto interrupt_taken;                           \
+                }                                                   \
+            }                                                       \
+            opcode = FetchByte(memory, cyclesExecuted);             \
+            goto *labels[opcode];
+
+        #define M6502_THREADED_HANDLER(opcode)                      \
+            op_##opcode: {                                          \
+                constexpr Handler handler = handlers[opcode];       \
+                (this->*handler)(memory, cyclesExecuted);           \
+            }                                                       \
+            M6502_TRACE_END(opcode, TRACE_INSTRUCTION)              \
+            steps++;                                                \
+            M6502_DISPATCH_NEXT()
+
+        M6502_DISPATCH_NEXT()
+
+        // An interrupt entry counts as one step, like an instruction
+        interrupt_taken:
+        M6502_TRACE_END(0, TRACE_INTERRUPT)
+        steps++;
+        M6502_DISPATCH_NEXT()
+
+        M6502_ALL_OPCODES(M6502_THREADED_HANDLER)
+
+        batch_done:
+        M6502_TRACE_FLUSH()
+        TotalCycles += Progress(cyclesExecuted, steps);
+        return Progress(cyclesExecuted, steps);
+
+        #undef M6502_THREADED_HANDLER
+        #undef M6502_DISPATCH_NEXT
+        #undef M6502_TRACE_BEGIN
+        #undef M6502_TRACE_END
+        #undef M6502_TRACE_FLUSH
+    }
+#endif
+
+    // ====================================================================
+    // DECODE CACHE
+    // ====================================================================
+
+    template <typename Bus, typename Timing>
+    template <AddressingMode Mode, bool PageCrossPenalty>
+    Address BasicCPU<Bus, Timing>::ResolveOperand(Bus& memory, Clock& cycles, Word operand) {
+        // Same work as ResolveAddress() minus the operand fetches, which
+        // were done at decode time and are charged by the caller
+        if constexpr (Mode == AddressingMode::Immediate) {
+            // PC is already past the operand byte
+            return static_cast<Address>(PC - 1);
+        } else if constexpr (Mode == AddressingMode::ZeroPage ||
+                             Mode == AddressingMode::Absolute) {
+            return operand;
+        } else if constexpr (Mode == AddressingMode::ZeroPageX) {
+            return ResolveZeroPageIndexed(static_cast<Byte>(operand), X, cycles);
+        } else if constexpr (Mode == AddressingMode::ZeroPageY) {
+            return ResolveZeroPageIndexed(static_cast<Byte>(operand), Y, cycles);
+        } else if constexpr (Mode == AddressingMode::AbsoluteX) {
+            return ResolveAbsoluteIndexed(operand, X, cycles, PageCrossPenalty);
+        } else if constexpr (Mode == AddressingMode::AbsoluteY) {
+            return ResolveAbsoluteIndexed(operand, Y, cycles, PageCrossPenalty);
+        } else if constexpr (Mode == AddressingMode::Indirect) {
+            return ResolveIndirect(memory, cycles, operand);
+        } else if constexpr (Mode == AddressingMode::IndexedIndirect) {
+            return ResolveIndexedIndirect(memory, cycles, static_cast<Byte>(operand));
+        } else {
+            static_assert(Mode == AddressingMode::IndirectIndexed,
+                          "Addressing mode does not resolve to a memory operand");
+            return ResolveIndirectIndexed(memory, cycles, static_cast<Byte>(operand),
+                                          PageCrossPenalty);
+        }
+    }
+
+    template <typename Bus, typename Timing>
+    template <typename BasicCPU<Bus, Timing>::MemoryOperation Operation, AddressingMode Mode, bool PageCrossPenalty>
+    void BasicCPU<Bus, Timing>::ExecuteDecodedMemory(Bus& memory, Clock& cycles, Word operand) {
+        Address address = ResolveOperand<Mode, PageCrossPenalty>(memory, cycles, operand);
+        (this->*Operation)(memory, cycles, address);
+    }
+
+    template <typename Bus, typename Timing>
+    template <typename BasicCPU<Bus, Timing>::ImpliedOperation Operation>
+    void BasicCPU<Bus, Timing>::ExecuteDecodedImplied(Bus& /* memory */, Clock& cycles, Word /* operand */) {
+        (this->*Operation)(cycles);
+    }
+
+    template <typename Bus, typename Timing>
+    template <typename BasicCPU<Bus, Timing>::Handler Operation>
+    void BasicCPU<Bus, Timing>::ExecuteDecodedStack(Bus& memory, Clock& cycles, Word /* operand */) {
+        (this->*Operation)(memory, cycles);
+    }
+
+    template <typename Bus, typename Timing>
+    template <StatusFlags Flag, bool Expected>
+    void BasicCPU<Bus, Timing>::ExecuteDecodedBranch(Bus& /* memory */, Clock& cycles, Word operand) {
+        if (GetFlag(Flag) == Expected) {
+            TakeBranch(static_cast<SignedByte>(operand), cycles);
+        }
+    }
+
+    template <typename Bus, typename Timing>
+    void BasicCPU<Bus, Timing>::ExecuteDecodedIllegal(Bus& /* memory */, Clock& cycles, Word /* operand */) {
+        // Same as ExecuteIllegal: one byte, one extra cycle
+        cycles++;
+    }
+
+    template <typename Bus, typename Timing>
+    constexpr Byte BasicCPU<Bus, Timing>::InstructionLength(AddressingMode mode) {
+        switch (mode) {
+            case AddressingMode::Implied:
+            case AddressingMode::Accumulator:
+                return 1;
+            case AddressingMode::Absolute:
+            case AddressingMode::AbsoluteX:
+            case AddressingMode::AbsoluteY:
+            case AddressingMode::Indirect:
+                return 3;
             default:
-                // Unknown instruction - could throw exception or halt
-                // For now, treat as NOP and increment cycles
-                cyclesUsed++;
+                return 2;
+        }
+    }
+
+    template <typename Bus, typename Timing>
+    constexpr bool BasicCPU<Bus, Timing>::EndsBasicBlock(Byte opcode) {
+        // Branches are marked by their table row; these are the rest
+        return opcode == INS_JMP_ABS || opcode == INS_JMP_IND || opcode == INS_JSR ||
+               opcode == INS_RTS || opcode == INS_RTI || opcode == INS_BRK;
+    }
+
+    template <typename Bus, typename Timing>
+    constexpr std::array<typename BasicCPU<Bus, Timing>::DecodedInstruction, 256> BasicCPU<Bus, Timing>::BuildDecodeTable() {
+        std::array<DecodedInstruction, 256> table{};
+
+        for (auto& entry : table) {
+            entry = { &BasicCPU::ExecuteDecodedIllegal, 1, false };
+        }
+
+        #define M6502_DECODE_MEM(opcode, operation, mode, pageCross)                          \
+            table[opcode] = { &BasicCPU::ExecuteDecodedMemory<&BasicCPU::operation,           \
+                                                              AddressingMode::mode, pageCross>, \
+                              InstructionLength(AddressingMode::mode), EndsBasicBlock(opcode) };
+        #define M6502_DECODE_IMP(opcode, operation, mode) \
+            table[opcode] = { &BasicCPU::ExecuteDecodedImplied<&BasicCPU::operation>, 1, false };
+        #define M6502_DECODE_STK(opcode, operation) \
+            table[opcode] = { &BasicCPU::ExecuteDecodedStack<&BasicCPU::operation>, 1, EndsBasicBlock(opcode) };
+        #define M6502_DECODE_BRANCH(opcode, flag, expected) \
+            table[opcode] = { &BasicCPU::ExecuteDecodedBranch<flag, expected>, 2, true };
+
+        M6502_OPCODE_TABLE(M6502_DECODE_MEM, M6502_DECODE_IMP, M6502_DECODE_STK, M6502_DECODE_BRANCH)
+
+        #undef M6502_DECODE_MEM
+        #undef M6502_DECODE_IMP
+        #undef M6502_DECODE_STK
+        #undef M6502_DECODE_BRANCH
+
+        return table;
+    }
+
+    template <typename Bus, typename Timing>
+    const std::array<typename BasicCPU<Bus, Timing>::DecodedInstruction, 256> BasicCPU<Bus, Timing>::DecodeTable =
+        BasicCPU<Bus, Timing>::BuildDecodeTable();
+
+    namespace {
+
+        constexpr bool SameName(const char* a, const char* b) {
+            while (*a != '\0' && *a == *b) {
+                a++;
+                b++;
+            }
+            return *a == *b;
+        }
+
+        /// Memory operations that never read their resolved address
+        constexpr bool IgnoresOperand(const char* operation) {
+            const char* const NAMES[] = { "STA", "STX", "STY", "JMP", "JSR" };
+            for (const char* name : NAMES) {
+                if (SameName(operation, name)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        constexpr Byte StackPulls(const char* operation) {
+            return SameName(operation, "PLA") || SameName(operation, "PLP") ? 1
+                 : SameName(operation, "RTS") ? 2
+                 : SameName(operation, "RTI") ? 3 : 0;
+        }
+
+    } // namespace
+
+    template <typename Bus, typename Timing>
+    constexpr std::array<typename BasicCPU<Bus, Timing>::ReadPlan, 256> BasicCPU<Bus, Timing>::BuildReadPlans() {
+        std::array<ReadPlan, 256> plans{};
+
+        // Illegal opcodes read only themselves
+        for (auto& plan : plans) {
+            plan = { 1, AddressingMode::Implied, false, 0, false };
+        }
+
+        // An immediate operand is read by its fetch; there is no address
+        // to read after it
+        #define M6502_PLAN_MEM(opcode, operation, mode, pageCross)                              \
+            plans[opcode] = { InstructionLength(AddressingMode::mode), AddressingMode::mode,    \
+                              AddressingMode::mode != AddressingMode::Immediate &&             \
+                                  !IgnoresOperand(#operation), 0, false };
+        #define M6502_PLAN_IMP(opcode, operation, mode) \
+            plans[opcode] = { 1, AddressingMode::mode, false, 0, false };
+        #define M6502_PLAN_STK(opcode, operation) \
+            plans[opcode] = { 1, AddressingMode::Implied, false, StackPulls(#operation), SameName(#operation, "BRK") };
+        #define M6502_PLAN_BRANCH(opcode, flag, expected) \
+            plans[opcode] = { 2, AddressingMode::Relative, false, 0, false };
+
+        M6502_OPCODE_TABLE(M6502_PLAN_MEM, M6502_PLAN_IMP, M6502_PLAN_STK, M6502_PLAN_BRANCH)
+
+        #undef M6502_PLAN_MEM
+        #undef M6502_PLAN_IMP
+        #undef M6502_PLAN_STK
+        #undef M6502_PLAN_BRANCH
+
+        return plans;
+    }
+
+    template <typename Bus, typename Timing>
+    const std::array<typename BasicCPU<Bus, Timing>::ReadPlan, 256> BasicCPU<Bus, Timing>::ReadPlans =
+        BasicCPU<Bus, Timing>::BuildReadPlans();
+
+    template <typename Bus, typename Timing>
+    bool BasicCPU<Bus, Timing>::Decode(Bus& memory, DecodeCache<Bus, Timing>& cache, Address address) {
+        Byte opcode = memory.ReadByteNoCycles(address);
+        Byte length = DecodeTable[opcode].length;
+
+        // Fetches from devices have side effects and must happen every time
+        Byte firstPage = address >> 8;
+        Byte lastPage = static_cast<Address>(address + length - 1) >> 8;
+        if (memory.IsIOPage(firstPage) || memory.IsIOPage(lastPage)) {
+            return false;
+        }
+
+        Word operand = 0;
+        if (length >= 2) {
+            operand = memory.ReadByteNoCycles(static_cast<Address>(address + 1));
+        }
+        if (length == 3) {
+            operand |= static_cast<Word>(memory.ReadByteNoCycles(static_cast<Address>(address + 2))) << 8;
+        }
+
+        // From now on, writes to these pages reach the cache
+        memory.WatchCodePage(firstPage);
+        memory.WatchCodePage(lastPage);
+
+        cache.entries[address] = { DecodeTable[opcode].handler, operand, length };
+        return true;
+    }
+
+    template <typename Bus, typename Timing>
+    Cycles BasicCPU<Bus, Timing>::RunFor(Cycles budget, Bus& memory, DecodeCache<Bus, Timing>& cache) {
+        // Predecoded entries skip the fetch the profiler and trace hook into
+        if (Instrumented()) {
+            return RunFor(budget, memory);
+        }
+
+        Clock cycles{};
+        Cycles steps = 0;
+        pendingInterrupts &= ~BATCH_END_REQUESTED;
+
+        while (Progress(cycles, steps) < budget) {
+            if (pendingInterrupts != 0) {
+                if (pendingInterrupts & BATCH_END_REQUESTED) {
+                    break;
+                }
+                if (ServiceInterrupt(memory, cycles)) {
+                    steps++;
+                    continue;
+                }
+            }
+
+            steps++;
+
+            const typename DecodeCache<Bus, Timing>::Entry& entry = cache.entries[PC];
+
+            if (entry.handler != nullptr) {
+                cache.hits++;
+            } else {
+                cache.misses++;
+                if (!Decode(memory, cache, PC)) {
+                    // Uncacheable: fetch through the bus as usual
+                    Step(memory, cycles);
+                    continue;
+                }
+            }
+
+            // Copy out before executing: the instruction may overwrite
+            // itself and invalidate its own entry
+            const auto handler = entry.handler;
+            const Word operand = entry.operand;
+
+            // Charge the opcode and operand fetches the cache saved
+            PC += entry.length;
+            cycles += entry.length;
+
+            (this->*handler)(memory, cycles, operand);
+        }
+
+        // One commit per batch
+        Cycles elapsed = Progress(cycles, steps);
+        TotalCycles += elapsed;
+
+        return elapsed;
+    }
+
+    // ====================================================================
+    // BLOCK TRANSLATION
+    // ====================================================================
+
+    template <typename Bus, typename Timing>
+    bool BasicCPU<Bus, Timing>::Translate(Bus& memory, BlockCache<Bus, Timing>& blocks, Address address) {
+        typename BlockCache<Bus, Timing>::Block& block = blocks.Slot(address);
+        block.ops.clear();
+        block.start = address;
+        block.staticCycles = 0;
+        block.worstCaseCycles = 0;
+
+        while (block.ops.size() < BlockCache<Bus, Timing>::MAX_BLOCK_INSTRUCTIONS) {
+            Byte opcode = memory.ReadByteNoCycles(address);
+            const DecodedInstruction& instruction = DecodeTable[opcode];
+
+            // Fetches from devices have side effects and must happen every
+            // time, so the block ends before any instruction touching one
+            Address last = static_cast<Address>(address + instruction.length - 1);
+            if (memory.IsIOPage(address >> 8) || memory.IsIOPage(last >> 8)) {
+                break;
+            }
+
+            Word operand = 0;
+            if (instruction.length >= 2) {
+                operand = memory.ReadByteNoCycles(static_cast<Address>(address + 1));
+            }
+            if (instruction.length == 3) {
+                operand |= static_cast<Word>(memory.ReadByteNoCycles(static_cast<Address>(address + 2))) << 8;
+            }
+
+            block.ops.push_back({ instruction.handler, operand, instruction.length });
+            block.staticCycles += instruction.length;
+            block.worstCaseCycles += MAX_INSTRUCTION_CYCLES;
+            address += instruction.length;
+
+            if (instruction.endsBlock) {
                 break;
+            }
         }
-        
-        // Update total cycle count
-        TotalCycles += cyclesUsed;
-        
-        return cyclesUsed;
+
+        if (block.ops.empty()) {
+            return false;
+        }
+
+        block.size = static_cast<Address>(address - block.start);
+        blocks.Register(block);
+        return true;
     }
 
-    Cycles CPU::Execute(Cycles cycles, Memory& memory) {
-        // Execute multiple instructions for specified number of cycles
-        Cycles cyclesExecuted = 0;
-        
-        while (cyclesExecuted < cycles) {
-            Cycles instructionCycles = Execute(memory);
-            cyclesExecuted += instructionCycles;
+    template <typename Bus, typename Timing>
+    Cycles BasicCPU<Bus, Timing>::RunFor(Cycles budget, Bus& memory, BlockCache<Bus, Timing>& blocks) {
+        using Block = typename BlockCache<Bus, Timing>::Block;
+
+        // Blocks run several instructions per dispatch; instrument one at a time
+        if (Instrumented()) {
+            return RunFor(budget, memory);
         }
-        
-        return cyclesExecuted;
+
+        Clock cycles{};
+        Cycles steps = 0;
+
+        // Charging a whole block's fetches up front would stamp device
+        // accesses inside the block too late; charge them one by one
+        const bool exactTiming = memory.HasDevices();
+        pendingInterrupts &= ~BATCH_END_REQUESTED;
+
+        while (Progress(cycles, steps) < budget) {
+            if (pendingInterrupts != 0) {
+                if (pendingInterrupts & BATCH_END_REQUESTED) {
+                    break;
+                }
+                if (ServiceInterrupt(memory, cycles)) {
+                    steps++;
+                    continue;
+                }
+            }
+
+            Block* block = blocks.slots[PC].get();
+
+            if (block != nullptr && block->valid) {
+                blocks.hits++;
+            } else {
+                blocks.misses++;
+                if (!Translate(memory, blocks, PC)) {
+                    // Code on an I/O page: fetch through the bus as usual
+                    Step(memory, cycles);
+                    steps++;
+                    continue;
+                }
+                block = blocks.slots[PC].get();
+            }
+
+            const std::size_t count = block->ops.size();
+
+            // Most the block can add to Progress(), in the budget's unit
+            const Cycles bound = Timing::COUNTS_CYCLES ? block->worstCaseCycles : count;
+
+            if (budget - Progress(cycles, steps) > bound && !exactTiming) {
+                // The whole block fits: charge every fetch up front
+                cycles += block->staticCycles;
+
+                std::size_t i = 0;
+                while (i < count) {
+                    const auto& op = block->ops[i++];
+                    PC += op.length;
+                    (this->*op.handler)(memory, cycles, op.operand);
+
+                    if (!block->valid || (pendingInterrupts != 0 && BoundaryDue())) {
+                        // The block wrote to itself or a device raised an
+                        // interrupt or ended the batch: refund the fetches of the instructions
+                        // that will not run from it
+                        for (std::size_t j = i; j < count; j++) {
+                            cycles -= block->ops[j].length;
+                        }
+                        break;
+                    }
+                }
+                steps += i;
+            } else {
+                // Near the end of the budget: stop where RunFor() would.
+                // Buses with devices always come here, for exact stamps.
+                for (std::size_t i = 0; i < count && Progress(cycles, steps) < budget; i++) {
+                    const auto& op = block->ops[i];
+                    PC += op.length;
+                    cycles += op.length;
+                    (this->*op.handler)(memory, cycles, op.operand);
+                    steps++;
+
+                    if (!block->valid || (pendingInterrupts != 0 && BoundaryDue())) {
+                        break;
+                    }
+                }
+            }
+        }
+
+        // One commit per batch
+        Cycles elapsed = Progress(cycles, steps);
+        TotalCycles += elapsed;
+
+        return elapsed;
     }
 
+    // Each translation unit instantiates the members it defines
+    template class BasicCPU<Memory>;
+    template class BasicCPU<MemoryBus>;
+    template class BasicCPU<Memory, Functional>;
+    template class BasicCPU<MemoryBus, Functional>;
+
 } // namespace M6502
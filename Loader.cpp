@@ -0,0 +1,519 @@
+/**
+ * @file Loader.cpp
+ * @brief Image parsers and the memory-mapped file path
+ */
+
+#include "Loader.h"
+#include "Snapshot.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #define M6502_HAS_MMAP 1
+#else
+    #define M6502_HAS_MMAP 0
+#endif
+
+namespace M6502 {
+
+    namespace {
+
+        const Byte SEGMENT_MAGIC[6] = { 'M', '6', '5', 'S', 'E', 'G' };
+        constexpr Byte SEGMENT_VERSION = 1;
+
+        constexpr std::uint32_t ADDRESS_LIMIT = MEMORY_SIZE;
+
+        /// Value of each ASCII hex digit, 0xFF for any other byte
+        constexpr std::array<Byte, 256> HEX_DIGITS = [] {
+            std::array<Byte, 256> digits{};
+            for (auto& digit : digits) {
+                digit = 0xFF;
+            }
+            for (int i = 0; i < 10; i++) {
+                digits['0' + i] = static_cast<Byte>(i);
+            }
+            for (int i = 0; i < 6; i++) {
+                digits['A' + i] = static_cast<Byte>(10 + i);
+                digits['a' + i] = static_cast<Byte>(10 + i);
+            }
+            return digits;
+        }();
+
+        bool IsSpace(Byte c) {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+        }
+
+        // ================================================================
+        // TEXT RECORDS
+        // ================================================================
+
+        /**
+         * @brief Walks the hex pairs of a text record, summing them for the checksum
+         */
+        class HexCursor {
+        public:
+            HexCursor(const Byte* position, const Byte* end) : position(position), end(end) {}
+
+            bool ReadByte(Byte& value) {
+                if (end - position < 2) {
+                    return false;
+                }
+                const Byte high = HEX_DIGITS[position[0]];
+                const Byte low = HEX_DIGITS[position[1]];
+                if ((high | low) & 0xF0) {
+                    return false;
+                }
+                value = static_cast<Byte>((high << 4) | low);
+                sum += value;
+                position += 2;
+                return true;
+            }
+
+            /// Big-endian field of `count` bytes, as both formats store addresses
+            bool ReadField(int count, std::uint32_t& value) {
+                value = 0;
+                for (int i = 0; i < count; i++) {
+                    Byte byte;
+                    if (!ReadByte(byte)) {
+                        return false;
+                    }
+                    value = (value << 8) | byte;
+                }
+                return true;
+            }
+
+            /// A record's data: one bounds check, and one digit check at the end
+            bool ReadBytes(Byte* out, std::size_t count) {
+                if (static_cast<std::size_t>(end - position) < 2 * count) {
+                    return false;
+                }
+                // Locals, since stores through a Byte* may alias the members
+                const Byte* text = position;
+                Byte invalid = 0;
+                Byte total = 0;
+                for (std::size_t i = 0; i < count; i++) {
+                    const Byte high = HEX_DIGITS[text[2 * i]];
+                    const Byte low = HEX_DIGITS[text[2 * i + 1]];
+                    const Byte value = static_cast<Byte>((high << 4) | low);
+                    invalid |= high | low;
+                    total += value;
+                    out[i] = value;
+                }
+                position = text + 2 * count;
+                sum += total;
+                return (invalid & 0xF0) == 0;
+            }
+
+            /// Skip whitespace between records; false at the end of the data
+            bool NextRecord() {
+                while (position < end && IsSpace(*position)) {
+                    position++;
+                }
+                return position < end;
+            }
+
+            bool Expect(Byte c) {
+                if (position == end || *position != c) {
+                    return false;
+                }
+                position++;
+                return true;
+            }
+
+            Byte Peek() const { return position < end ? *position : 0; }
+            void Skip() { position++; }
+
+            Byte sum = 0;
+
+        private:
+            const Byte* position;
+            const Byte* end;
+        };
+
+        /**
+         * @brief Collects decoded record data into contiguous runs
+         *
+         * Records usually follow one another in memory, so each run
+         * reaches Memory as a single LoadProgram() copy rather than one
+         * per record.
+         */
+        class RunWriter {
+        public:
+            RunWriter(Memory& memory, ImageInfo& info) : memory(memory), info(info), start(0) {
+                run.reserve(MEMORY_SIZE);
+            }
+
+            /// Space for `count` bytes at `address`, or nullptr past $FFFF
+            Byte* Reserve(std::uint32_t address, std::size_t count) {
+                if (address + count > ADDRESS_LIMIT) {
+                    return nullptr;
+                }
+                if (!run.empty() && address != start + run.size()) {
+                    Flush();
+                }
+                if (run.empty()) {
+                    start = address;
+                }
+                const std::size_t used = run.size();
+                run.resize(used + count);
+                return run.data() + used;
+            }
+
+            void Flush();
+
+        private:
+            Memory& memory;
+            ImageInfo& info;
+            std::vector<Byte> run;
+            std::uint32_t start;
+        };
+
+        void NoteWritten(ImageInfo& info, Address address, std::size_t size) {
+            if (size == 0) {
+                return;
+            }
+            const Address last = static_cast<Address>(address + size - 1);
+            if (info.bytes == 0 || address < info.lowest) {
+                info.lowest = address;
+            }
+            if (info.bytes == 0 || last > info.highest) {
+                info.highest = last;
+            }
+            info.bytes += size;
+        }
+
+        void RunWriter::Flush() {
+            // Reserve() kept the run below $10000, so this cannot fail
+            memory.LoadProgram(static_cast<Address>(start), run.data(), run.size());
+            NoteWritten(info, static_cast<Address>(start), run.size());
+            run.clear();
+        }
+
+        bool SetEntry(ImageInfo& info, std::uint32_t entry) {
+            if (entry >= ADDRESS_LIMIT) {
+                return false;
+            }
+            info.hasEntry = true;
+            info.entry = static_cast<Address>(entry);
+            return true;
+        }
+
+        bool LoadIntelHex(Memory& memory, const Byte* data, std::size_t size, ImageInfo& info) {
+            HexCursor cursor(data, data + size);
+            RunWriter runs(memory, info);
+            std::uint32_t upper = 0;    // From extended address records
+            Byte field[255] = {};
+
+            while (cursor.NextRecord()) {
+                // :LLAAAATT<data>CC, where all the bytes sum to zero
+                cursor.sum = 0;
+                Byte count, type;
+                std::uint32_t offset;
+                if (!cursor.Expect(':') || !cursor.ReadByte(count) ||
+                    !cursor.ReadField(2, offset) || !cursor.ReadByte(type)) {
+                    return false;
+                }
+
+                Byte* out = field;
+                if (type == 0x00) {
+                    out = runs.Reserve(upper + offset, count);
+                    if (out == nullptr) {
+                        return false;
+                    }
+                }
+                Byte checksum;
+                if (!cursor.ReadBytes(out, count) || !cursor.ReadByte(checksum) || cursor.sum != 0) {
+                    return false;
+                }
+
+                const std::uint32_t word = (static_cast<std::uint32_t>(field[0]) << 8) | field[1];
+                switch (type) {
+                    case 0x00:
+                        break;
+                    case 0x01:
+                        runs.Flush();
+                        return true;
+                    case 0x02:  // Extended segment address
+                        if (count != 2) {
+                            return false;
+                        }
+                        upper = word << 4;
+                        break;
+                    case 0x03:  // Start segment address, CS:IP
+                        if (count != 4 || !SetEntry(info, (word << 4) +
+                                ((static_cast<std::uint32_t>(field[2]) << 8) | field[3]))) {
+                            return false;
+                        }
+                        break;
+                    case 0x04:  // Extended linear address
+                        if (count != 2) {
+                            return false;
+                        }
+                        upper = word << 16;
+                        break;
+                    case 0x05:  // Start linear address
+                        if (count != 4 || !SetEntry(info, (word << 16) |
+                                (static_cast<std::uint32_t>(field[2]) << 8) | field[3])) {
+                            return false;
+                        }
+                        break;
+                    default:
+                        return false;
+                }
+            }
+
+            // No end-of-file record: accept what was there, as most tools do
+            runs.Flush();
+            return true;
+        }
+
+        bool LoadSRecord(Memory& memory, const Byte* data, std::size_t size, ImageInfo& info) {
+            HexCursor cursor(data, data + size);
+            RunWriter runs(memory, info);
+            Byte field[255];
+
+            while (cursor.NextRecord()) {
+                // S<type><count><address><data><checksum>; the count covers
+                // address, data and checksum, which sum to $FF
+                if (!cursor.Expect('S')) {
+                    return false;
+                }
+                const Byte type = HEX_DIGITS[cursor.Peek()];
+                cursor.Skip();
+
+                static constexpr int ADDRESS_BYTES[10] = { 2, 2, 3, 4, 0, 2, 3, 4, 3, 2 };
+                const int addressBytes = type < 10 ? ADDRESS_BYTES[type] : 0;
+                if (addressBytes == 0) {
+                    return false;
+                }
+
+                cursor.sum = 0;
+                Byte count;
+                std::uint32_t address;
+                if (!cursor.ReadByte(count) || count < addressBytes + 1 ||
+                    !cursor.ReadField(addressBytes, address)) {
+                    return false;
+                }
+
+                const std::size_t length = count - addressBytes - 1;
+                Byte* out = field;
+                if (type >= 1 && type <= 3) {
+                    out = runs.Reserve(address, length);
+                    if (out == nullptr) {
+                        return false;
+                    }
+                }
+                Byte checksum;
+                if (!cursor.ReadBytes(out, length) || !cursor.ReadByte(checksum) || cursor.sum != 0xFF) {
+                    return false;
+                }
+
+                // S7-S9 end the data with the start address
+                if (type >= 7 && !SetEntry(info, address)) {
+                    return false;
+                }
+            }
+
+            runs.Flush();
+            return true;
+        }
+
+        // ================================================================
+        // BINARY IMAGES
+        // ================================================================
+
+        bool LoadRaw(Memory& memory, const Byte* data, std::size_t size, Address base,
+                     ImageInfo& info) {
+            if (!memory.LoadProgram(base, data, size)) {
+                return false;
+            }
+            NoteWritten(info, base, size);
+            return true;
+        }
+
+        bool LoadSegments(Memory& memory, const Byte* data, std::size_t size, ImageInfo& info) {
+            SnapshotReader reader(data, size);
+            const Byte* magic = reader.ReadBytes(sizeof(SEGMENT_MAGIC));
+            if (magic == nullptr || !std::equal(magic, magic + sizeof(SEGMENT_MAGIC), SEGMENT_MAGIC)) {
+                return false;
+            }
+
+            Byte version, present;
+            if (!reader.ReadByte(version) || version != SEGMENT_VERSION || !reader.ReadByte(present)) {
+                return false;
+            }
+
+            // Vectors come first in the file but are written last, so a
+            // segment covering $FFFA-$FFFF cannot override them
+            Word vectors[3] = {};
+            const Byte bits[3] = { ImageVectors::NMI, ImageVectors::RESET, ImageVectors::IRQ };
+            for (int i = 0; i < 3; i++) {
+                if ((present & bits[i]) && !reader.ReadWord(vectors[i])) {
+                    return false;
+                }
+            }
+
+            Word count;
+            if (!reader.ReadWord(count)) {
+                return false;
+            }
+            for (Word i = 0; i < count; i++) {
+                Word address, length;
+                const Byte* bytes;
+                if (!reader.ReadWord(address) || !reader.ReadWord(length) ||
+                    (bytes = reader.ReadBytes(length)) == nullptr ||
+                    !LoadRaw(memory, bytes, length, address, info)) {
+                    return false;
+                }
+            }
+
+            for (int i = 0; i < 3; i++) {
+                if (present & bits[i]) {
+                    const Address vector = VECTOR_NMI + 2 * i;
+                    const Byte word[2] = { static_cast<Byte>(vectors[i] & 0xFF),
+                                           static_cast<Byte>(vectors[i] >> 8) };
+                    LoadRaw(memory, word, 2, vector, info);
+                }
+            }
+            if (present & ImageVectors::RESET) {
+                SetEntry(info, vectors[1]);
+            }
+            return true;
+        }
+
+    } // namespace
+
+    // ====================================================================
+    // LOADING
+    // ====================================================================
+
+    ImageFormat DetectImageFormat(const Byte* data, std::size_t size) {
+        if (size >= sizeof(SEGMENT_MAGIC) &&
+            std::equal(data, data + sizeof(SEGMENT_MAGIC), SEGMENT_MAGIC)) {
+            return ImageFormat::Segments;
+        }
+
+        std::size_t i = 0;
+        while (i < size && IsSpace(data[i])) {
+            i++;
+        }
+        if (i + 1 < size) {
+            if (data[i] == ':' && HEX_DIGITS[data[i + 1]] != 0xFF) {
+                return ImageFormat::IntelHex;
+            }
+            if (data[i] == 'S' && data[i + 1] >= '0' && data[i + 1] <= '9') {
+                return ImageFormat::SRecord;
+            }
+        }
+        return ImageFormat::Raw;
+    }
+
+    bool LoadProgramImage(Memory& memory, const Byte* data, std::size_t size,
+                          const LoadOptions& options, ImageInfo& info) {
+        info = ImageInfo();
+        info.format = options.format == ImageFormat::Detect
+                    ? DetectImageFormat(data, size) : options.format;
+
+        bool loaded = false;
+        switch (info.format) {
+            case ImageFormat::Raw:      loaded = LoadRaw(memory, data, size, options.base, info); break;
+            case ImageFormat::IntelHex: loaded = LoadIntelHex(memory, data, size, info); break;
+            case ImageFormat::SRecord:  loaded = LoadSRecord(memory, data, size, info); break;
+            case ImageFormat::Segments: loaded = LoadSegments(memory, data, size, info); break;
+            case ImageFormat::Detect:   break;
+        }
+
+        if (loaded && options.setResetVector && info.hasEntry) {
+            const Byte word[2] = { static_cast<Byte>(info.entry & 0xFF),
+                                   static_cast<Byte>(info.entry >> 8) };
+            memory.LoadProgram(VECTOR_RESET, word, 2);
+        }
+        return loaded;
+    }
+
+    bool LoadProgramFile(const std::string& path, Memory& memory,
+                         const LoadOptions& options, ImageInfo& info) {
+#if M6502_HAS_MMAP
+        // Map instead of read: binary images are copied straight from
+        // the page cache into Memory, and text is parsed in place
+        int file = open(path.c_str(), O_RDONLY);
+        if (file < 0) {
+            return false;
+        }
+
+        struct stat status;
+        if (fstat(file, &status) != 0 || status.st_size <= 0) {
+            close(file);
+            return false;
+        }
+
+        std::size_t size = static_cast<std::size_t>(status.st_size);
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+        close(file);
+        if (mapping == MAP_FAILED) {
+            return false;
+        }
+
+        bool loaded = LoadProgramImage(memory, static_cast<const Byte*>(mapping), size, options, info);
+        munmap(mapping, size);
+        return loaded;
+#else
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        if (file == nullptr) {
+            return false;
+        }
+
+        std::vector<Byte> buffer;
+        Byte chunk[4096];
+        std::size_t count;
+        while ((count = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+            buffer.insert(buffer.end(), chunk, chunk + count);
+        }
+        std::fclose(file);
+
+        return !buffer.empty() &&
+               LoadProgramImage(memory, buffer.data(), buffer.size(), options, info);
+#endif
+    }
+
+    // ====================================================================
+    // SEGMENT IMAGES
+    // ====================================================================
+
+    std::vector<Byte> SaveSegmentImage(const std::vector<ImageSegment>& segments,
+                                       const ImageVectors& vectors) {
+        // Split anything too long for a 16-bit size
+        std::vector<ImageSegment> pieces;
+        for (const ImageSegment& segment : segments) {
+            for (std::size_t done = 0; done < segment.size; done += 0xFFFF) {
+                const std::size_t length = std::min<std::size_t>(segment.size - done, 0xFFFF);
+                pieces.push_back({ static_cast<Address>(segment.address + done),
+                                   segment.data + done, length });
+            }
+        }
+
+        std::vector<Byte> buffer;
+        SnapshotWriter writer(buffer);
+        writer.WriteBytes(SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC));
+        writer.WriteByte(SEGMENT_VERSION);
+        writer.WriteByte(vectors.present);
+        if (vectors.present & ImageVectors::NMI)   writer.WriteWord(vectors.nmi);
+        if (vectors.present & ImageVectors::RESET) writer.WriteWord(vectors.reset);
+        if (vectors.present & ImageVectors::IRQ)   writer.WriteWord(vectors.irq);
+
+        writer.WriteWord(static_cast<Word>(pieces.size()));
+        for (const ImageSegment& piece : pieces) {
+            writer.WriteWord(piece.address);
+            writer.WriteWord(static_cast<Word>(piece.size));
+            writer.WriteBytes(piece.data, piece.size);
+        }
+        return buffer;
+    }
+
+} // namespace M6502
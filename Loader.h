@@ -0,0 +1,108 @@
+/**
+ * @file Loader.h
+ * @brief Program image loaders: raw binaries, Intel HEX, S-records and segment images
+ */
+
+#ifndef M6502_LOADER_H
+#define M6502_LOADER_H
+
+#include "Constants.h"
+#include "Memory.h"
+#include <string>
+#include <vector>
+
+namespace M6502 {
+
+    enum class ImageFormat : Byte {
+        Detect,     ///< Decide from the contents (see DetectImageFormat())
+        Raw,        ///< Bytes to copy to LoadOptions::base
+        IntelHex,   ///< Records 00-05; addresses must stay below $10000
+        SRecord,    ///< S0-S9; addresses must stay below $10000
+        Segments    ///< Segment image (see SaveSegmentImage())
+    };
+
+    struct LoadOptions {
+        ImageFormat format = ImageFormat::Detect;
+        Address base = 0;               ///< Where a raw image goes
+        bool setResetVector = false;    ///< Point the reset vector at the image's entry, if any
+    };
+
+    /**
+     * @brief What a load put where
+     */
+    struct ImageInfo {
+        ImageFormat format = ImageFormat::Raw;  ///< The format actually loaded
+        std::size_t bytes = 0;                  ///< Bytes written, vectors included
+        Address lowest = 0;                     ///< Lowest and highest address written
+        Address highest = 0;
+        bool hasEntry = false;                  ///< Start record, or reset vector of a segment image
+        Address entry = 0;
+    };
+
+    /**
+     * @brief One block of a segment image
+     */
+    struct ImageSegment {
+        Address address;
+        const Byte* data;
+        std::size_t size;
+    };
+
+    /**
+     * @brief Interrupt vectors a segment image sets
+     */
+    struct ImageVectors {
+        static constexpr Byte NMI = 0x01;
+        static constexpr Byte RESET = 0x02;
+        static constexpr Byte IRQ = 0x04;
+
+        Byte present = 0;   ///< Which of the three are set
+        Address nmi = 0;
+        Address reset = 0;
+        Address irq = 0;
+    };
+
+    /**
+     * @brief Guess the format of an image from its first bytes
+     *
+     * The segment magic, then a ':' or 'S' and a digit after any leading
+     * whitespace; anything else is raw. A raw binary can start with
+     * those bytes too, so pass the format when it is known.
+     */
+    ImageFormat DetectImageFormat(const Byte* data, std::size_t size);
+
+    /**
+     * @brief Load an image held in memory into `memory`
+     *
+     * Text records are decoded into contiguous runs, and each run (and
+     * each raw image or segment) reaches Memory as one LoadProgram()
+     * copy, marking pages dirty and dropping cached code as a program
+     * written byte by byte would.
+     *
+     * @return false if the image is malformed, fails a checksum or runs
+     *         past $FFFF; memory may then be partly loaded
+     */
+    bool LoadProgramImage(Memory& memory, const Byte* data, std::size_t size,
+                          const LoadOptions& options, ImageInfo& info);
+
+    /**
+     * @brief Load an image file, reading it through a memory mapping
+     */
+    bool LoadProgramFile(const std::string& path, Memory& memory,
+                         const LoadOptions& options, ImageInfo& info);
+
+    /**
+     * @brief Build a segment image
+     *
+     * Layout, little-endian: the magic "M65SEG", a version byte and the
+     * ImageVectors::present bits; each present vector in NMI, RESET, IRQ
+     * order; a segment count; then per segment its address, size and
+     * bytes. Segments over $FFFF bytes are split, so a full 64 KiB image
+     * is two of them.
+     */
+    std::vector<Byte> SaveSegmentImage(const std::vector<ImageSegment>& segments,
+                                       const ImageVectors& vectors = ImageVectors());
+
+} // namespace M6502
+
+#endif // M6502_LOADER_H
@@ -0,0 +1,607 @@
+/**
+ * @file LockstepCPU.cpp
+ * @brief Lane-parallel instruction semantics for LockstepCPU
+ */
+
+#include "LockstepCPU.h"
+
+#if M6502_HAS_LOCKSTEP
+
+#include "OpcodeTable.h"
+#include "Timing.h"
+#include <cstring>
+
+// Lane vectors wider than the enabled SIMD registers are returned from
+// the helpers below; they all have internal linkage and are inlined, so
+// GCC's warning about that calling convention does not apply
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+namespace M6502 {
+
+    namespace {
+
+        constexpr std::size_t LANES = LockstepCPU::LANES;
+
+        using LaneBytes = LockstepCPU::LaneBytes;
+        using LaneWords = LockstepCPU::LaneWords;
+
+        // Signed views for moving comparison masks between lane widths
+        typedef SignedByte LaneMaskBytes __attribute__((vector_size(LANES)));
+        typedef std::int16_t LaneMaskWords __attribute__((vector_size(2 * LANES)));
+        typedef std::int64_t LaneMaskCycles __attribute__((vector_size(8 * LANES)));
+
+        // Status bits as plain bytes: vector operations do not accept the
+        // StatusFlags enum
+        constexpr Byte LANE_CARRY = FLAG_CARRY;
+        constexpr Byte LANE_ZERO = FLAG_ZERO;
+        constexpr Byte LANE_INTERRUPT = FLAG_INTERRUPT;
+        constexpr Byte LANE_DECIMAL = FLAG_DECIMAL;
+        constexpr Byte LANE_OVERFLOW = FLAG_OVERFLOW;
+        constexpr Byte LANE_NEGATIVE = FLAG_NEGATIVE;
+
+        /// a where mask is set, b elsewhere
+        inline LaneBytes Select(LaneBytes mask, LaneBytes a, LaneBytes b) {
+            return (a & mask) | (b & ~mask);
+        }
+
+        inline LaneWords Select(const LaneWords& mask, const LaneWords& a, const LaneWords& b) {
+            return (a & mask) | (b & ~mask);
+        }
+
+        /// Comparison results (0 / -1 per lane) of any width as a byte mask
+        template <typename Comparison>
+        inline LaneBytes Mask(const Comparison& comparison) {
+            return (LaneBytes)__builtin_convertvector(comparison, LaneMaskBytes);
+        }
+
+        /// Byte mask widened to word and cycle lanes
+        inline LaneWords WordMask(LaneBytes mask) {
+            return (LaneWords)__builtin_convertvector((LaneMaskBytes)mask, LaneMaskWords);
+        }
+
+        template <typename LaneCycles>
+        inline LaneCycles CycleMask(LaneBytes mask) {
+            return (LaneCycles)__builtin_convertvector((LaneMaskBytes)mask, LaneMaskCycles);
+        }
+
+        // Reductions work on the mask as 64-bit words, which the compiler
+        // keeps in general registers instead of extracting lane by lane
+        typedef std::array<std::uint64_t, LANES / 8> MaskWords;
+
+        inline MaskWords Words(LaneBytes mask) {
+            MaskWords words;
+            std::memcpy(words.data(), &mask, sizeof(mask));
+            return words;
+        }
+
+        inline bool Any(LaneBytes mask) {
+            std::uint64_t any = 0;
+            for (std::uint64_t word : Words(mask)) {
+                any |= word;
+            }
+            return any != 0;
+        }
+
+        inline std::size_t Count(LaneBytes mask) {
+            std::size_t count = 0;
+            for (std::uint64_t word : Words(mask)) {
+                count += static_cast<std::size_t>(__builtin_popcountll(word & 0x0101010101010101ULL));
+            }
+            return count;
+        }
+
+        /// Index of the first set lane; `mask` must not be empty
+        inline std::size_t First(LaneBytes mask) {
+            std::size_t lane = 0;
+            for (std::uint64_t word : Words(mask)) {
+                if (word != 0) {
+                    break;
+                }
+                lane += 8;
+            }
+            // Scan the word bytewise, so host byte order does not matter
+            while (!mask[lane]) {
+                lane++;
+            }
+            return lane;
+        }
+
+        inline Word Minimum(const LaneWords& values) {
+            std::array<Word, LANES> lanes;
+            std::memcpy(lanes.data(), &values, sizeof(values));
+            Word minimum = lanes[0];
+            for (Word value : lanes) {
+                minimum = value < minimum ? value : minimum;
+            }
+            return minimum;
+        }
+
+        /// P with Z and N set from `value`, lane by lane
+        inline LaneBytes ZeroAndNegative(LaneBytes p, LaneBytes value) {
+            return (p & static_cast<Byte>(~(LANE_ZERO | LANE_NEGATIVE)))
+                 | (Mask(value == 0) & LANE_ZERO)
+                 | (value & LANE_NEGATIVE);
+        }
+
+        // A page that keeps being written after it was found shared is
+        // probably data next to code; stop re-checking it
+        constexpr Byte MAX_PAGE_CHECKS = 8;
+
+        constexpr Byte LengthOf(AddressingMode mode) {
+            switch (mode) {
+                case AddressingMode::Implied:
+                case AddressingMode::Accumulator:
+                    return 1;
+                case AddressingMode::Absolute:
+                case AddressingMode::AbsoluteX:
+                case AddressingMode::AbsoluteY:
+                case AddressingMode::Indirect:
+                    return 3;
+                default:
+                    return 2;
+            }
+        }
+
+    } // namespace
+
+    LockstepCPU::LockstepCPU() : memories(LANES) {
+        // Same power-on state as BasicCPU
+        A = X = Y = SP = P = LaneBytes{};
+        PC = LaneWords{};
+        TotalCycles.fill(0);
+        pages.fill(PageState::Unknown);
+        pageChecks.fill(0);
+        ResetStatistics();
+    }
+
+    void LockstepCPU::Reset() {
+        for (std::size_t lane = 0; lane < LANES; lane++) {
+            scalar = CPU();
+            scalar.Reset(memories[lane]);
+
+            A[lane] = scalar.A;
+            X[lane] = scalar.X;
+            Y[lane] = scalar.Y;
+            SP[lane] = scalar.SP;
+            P[lane] = scalar.P;
+            PC[lane] = scalar.PC;
+            TotalCycles[lane] += scalar.TotalCycles;
+        }
+    }
+
+    void LockstepCPU::ResetStatistics() {
+        vectorSteps = 0;
+        vectorLaneSteps = 0;
+        scalarSteps = 0;
+    }
+
+    // ====================================================================
+    // INSTRUCTION TABLE
+    // ====================================================================
+
+    constexpr std::array<LockstepCPU::Instruction, 256> LockstepCPU::BuildInstructionTable() {
+        std::array<Instruction, 256> table{};
+
+        for (auto& entry : table) {
+            entry = { Operation::Illegal, AddressingMode::Implied, false, false, 1, 0, false };
+        }
+
+        // Memory operations with a lane-parallel version; the rest
+        // (read-modify-write, JSR, JMP indirect) go through the scalar CPU
+        auto vectorMemory = [](Operation operation, AddressingMode mode) {
+            switch (operation) {
+                case Operation::LDA: case Operation::LDX: case Operation::LDY:
+                case Operation::STA: case Operation::STX: case Operation::STY:
+                case Operation::AND: case Operation::ORA: case Operation::EOR:
+                case Operation::BIT: case Operation::ADC: case Operation::SBC:
+                case Operation::CMP: case Operation::CPX: case Operation::CPY:
+                    return true;
+                case Operation::JMP:
+                    return mode == AddressingMode::Absolute;
+                default:
+                    return false;
+            }
+        };
+
+        #define M6502_LOCKSTEP_MEM(opcode, operation, mode, pageCross)                        \
+            table[opcode] = { Operation::operation, AddressingMode::mode, pageCross,           \
+                              vectorMemory(Operation::operation, AddressingMode::mode),        \
+                              LengthOf(AddressingMode::mode), 0, false };
+        #define M6502_LOCKSTEP_IMP(opcode, operation, mode) \
+            table[opcode] = { Operation::operation, AddressingMode::mode, false, true, 1, 0, false };
+        #define M6502_LOCKSTEP_STK(opcode, operation) \
+            table[opcode] = { Operation::operation, AddressingMode::Implied, false, false, 1, 0, false };
+        #define M6502_LOCKSTEP_BRANCH(opcode, flag, expected) \
+            table[opcode] = { Operation::Branch, AddressingMode::Relative, false, true, 2, flag, expected };
+
+        M6502_OPCODE_TABLE(M6502_LOCKSTEP_MEM, M6502_LOCKSTEP_IMP, M6502_LOCKSTEP_STK, M6502_LOCKSTEP_BRANCH)
+
+        #undef M6502_LOCKSTEP_MEM
+        #undef M6502_LOCKSTEP_IMP
+        #undef M6502_LOCKSTEP_STK
+        #undef M6502_LOCKSTEP_BRANCH
+
+        return table;
+    }
+
+    const std::array<LockstepCPU::Instruction, 256> LockstepCPU::InstructionTable =
+        LockstepCPU::BuildInstructionTable();
+
+    // ====================================================================
+    // SHARED CODE TRACKING
+    // ====================================================================
+
+    bool LockstepCPU::SharedPage(Byte page) {
+        if (pages[page] != PageState::Unknown) {
+            return pages[page] == PageState::Shared;
+        }
+
+        if (++pageChecks[page] > MAX_PAGE_CHECKS) {
+            pages[page] = PageState::Mixed;
+            return false;
+        }
+
+        const Byte* first = memories[0].PageData(page);
+        for (std::size_t lane = 1; lane < LANES; lane++) {
+            if (std::memcmp(first, memories[lane].PageData(page), Memory::PAGE_SIZE) != 0) {
+                pages[page] = PageState::Mixed;
+                return false;
+            }
+        }
+
+        for (Memory& memory : memories) {
+            memory.WatchCodePage(page);
+        }
+        pages[page] = PageState::Shared;
+        return true;
+    }
+
+    bool LockstepCPU::SharedCode(Word pc, Byte length) {
+        const Byte first = static_cast<Byte>(pc >> 8);
+        const Byte last = static_cast<Byte>((pc + length - 1) >> 8);
+        return SharedPage(first) && (last == first || SharedPage(last));
+    }
+
+    void LockstepCPU::OnCodeWrite(Address address) {
+        OnCodePageChanged(static_cast<Byte>(address >> 8));
+    }
+
+    void LockstepCPU::OnCodePageChanged(Byte page) {
+        if (pages[page] == PageState::Shared) {
+            pages[page] = PageState::Unknown;
+        }
+    }
+
+    // ====================================================================
+    // MAIN LOOP
+    // ====================================================================
+
+    void LockstepCPU::RunFor(Cycles budget) {
+        // Per-lane counters for this call, committed once at the end
+        LaneCycles elapsed{};
+
+        pages.fill(PageState::Unknown);
+        pageChecks.fill(0);
+        for (Memory& memory : memories) {
+            memory.SetCodeObserver(this);
+        }
+
+        for (;;) {
+            const LaneBytes active = Mask(elapsed < budget);
+            if (!Any(active)) {
+                break;
+            }
+
+            // Lowest PC among the lanes still inside the budget
+            const Word pc = Minimum(Select(WordMask(active), PC, LaneWords{} + 0xFFFF));
+            LaneBytes mask = active & Mask(PC == pc);
+            const std::size_t leader = First(mask);
+            const Memory& reference = memories[leader];
+            const Instruction& instruction = InstructionTable[reference[pc]];
+
+            if (!instruction.vector) {
+                for (std::size_t lane = leader; lane < LANES; lane++) {
+                    if (mask[lane]) {
+                        ExecuteScalar(lane, elapsed);
+                    }
+                }
+                continue;
+            }
+
+            // Lanes holding the same instruction bytes as the leader (code
+            // in RAM may differ between lanes)
+            if (!SharedCode(pc, instruction.length)) {
+                for (std::size_t lane = leader + 1; lane < LANES; lane++) {
+                    if (!mask[lane]) {
+                        continue;
+                    }
+                    const Memory& memory = memories[lane];
+                    for (Byte offset = 0; offset < instruction.length; offset++) {
+                        const Address address = static_cast<Address>(pc + offset);
+                        if (memory[address] != reference[address]) {
+                            mask[lane] = 0;
+                        }
+                    }
+                }
+            }
+
+            // Decimal-mode arithmetic is left to the scalar core
+            if ((instruction.operation == Operation::ADC || instruction.operation == Operation::SBC) &&
+                Any(mask & P & LANE_DECIMAL)) {
+                for (std::size_t lane = leader; lane < LANES; lane++) {
+                    if (mask[lane]) {
+                        ExecuteScalar(lane, elapsed);
+                    }
+                }
+                continue;
+            }
+
+            ExecuteVector(instruction, mask, pc, elapsed);
+        }
+
+        for (Memory& memory : memories) {
+            memory.SetCodeObserver(nullptr);
+        }
+        for (std::size_t lane = 0; lane < LANES; lane++) {
+            TotalCycles[lane] += elapsed[lane];
+        }
+    }
+
+    void LockstepCPU::ExecuteScalar(std::size_t lane, LaneCycles& elapsed) {
+        scalar.A = A[lane];
+        scalar.X = X[lane];
+        scalar.Y = Y[lane];
+        scalar.SP = SP[lane];
+        scalar.P = P[lane];
+        scalar.PC = PC[lane];
+
+        elapsed[lane] += scalar.Execute(memories[lane]);
+
+        A[lane] = scalar.A;
+        X[lane] = scalar.X;
+        Y[lane] = scalar.Y;
+        SP[lane] = scalar.SP;
+        P[lane] = scalar.P;
+        PC[lane] = scalar.PC;
+
+        scalarSteps++;
+    }
+
+    // ====================================================================
+    // LANE-PARALLEL EXECUTION
+    // ====================================================================
+
+    void LockstepCPU::ExecuteVector(const Instruction& instruction, LaneBytes mask, Word pc,
+                                    LaneCycles& elapsed) {
+        const Operation operation = instruction.operation;
+        const LaneWords wordMask = WordMask(mask);
+        const LaneCycles cycleMask = CycleMask<LaneCycles>(mask);
+
+        // Every masked lane has the same instruction bytes, so the operand
+        // bytes are read once
+        const std::size_t leader = First(mask);
+        const Memory& leaderMemory = memories[leader];
+        const Byte low = leaderMemory[static_cast<Address>(pc + 1)];
+        const Word absolute = static_cast<Word>(low | (leaderMemory[static_cast<Address>(pc + 2)] << 8));
+
+        vectorSteps++;
+        vectorLaneSteps += Count(mask);
+
+        // Branches: one target for all lanes, per-lane condition
+
+        if (operation == Operation::Branch) {
+            const Word next = static_cast<Word>(pc + 2);
+            const Word target = static_cast<Word>(next + static_cast<SignedByte>(low));
+            const Cycles takenCycles = ((next & 0xFF00) != (target & 0xFF00)) ? 2 : 1;
+
+            LaneBytes set = Mask((P & instruction.branchFlag) != 0);
+            LaneBytes taken = (instruction.branchExpected ? set : ~set) & mask;
+
+            PC = Select(wordMask, Select(WordMask(taken), LaneWords{} + target, LaneWords{} + next), PC);
+            elapsed += (2 + (CycleMask<LaneCycles>(taken) & takenCycles)) & cycleMask;
+            return;
+        }
+
+        if (operation == Operation::JMP) {
+            PC = Select(wordMask, LaneWords{} + absolute, PC);
+            elapsed += cycleMask & 3;
+            return;
+        }
+
+        // Effective addresses and addressing cycles, cycle for cycle the
+        // same as the scalar Addr* helpers
+
+        LaneWords address{};
+        LaneBytes operand{};
+        LaneBytes pageCrossed{};
+        Cycles cycles = 2;      // opcode fetch and the data access (or internal cycle)
+        bool gather = true;
+
+        auto indexed = [&](const LaneWords& base, LaneBytes index) {
+            LaneWords result = base + __builtin_convertvector(index, LaneWords);
+            if (instruction.pageCrossPenalty) {
+                pageCrossed = Mask((result & 0xFF00) != (base & 0xFF00));
+            }
+            return result;
+        };
+
+        // Little-endian pointer at per-lane zero page addresses
+        auto pointers = [&](LaneBytes at) {
+            LaneWords result{};
+            for (std::size_t lane = leader; lane < LANES; lane++) {
+                if (mask[lane]) {
+                    const Memory& memory = memories[lane];
+                    result[lane] = static_cast<Word>(memory[at[lane]] |
+                                                     (memory[static_cast<Byte>(at[lane] + 1)] << 8));
+                }
+            }
+            return result;
+        };
+
+        switch (instruction.mode) {
+            case AddressingMode::Immediate:
+                cycles += 1;
+                operand = LaneBytes{} + low;
+                gather = false;
+                break;
+            case AddressingMode::ZeroPage:
+                cycles += 1;
+                address = LaneWords{} + low;
+                break;
+            case AddressingMode::ZeroPageX:
+                cycles += 2;
+                address = __builtin_convertvector(static_cast<Byte>(low) + X, LaneWords);
+                break;
+            case AddressingMode::ZeroPageY:
+                cycles += 2;
+                address = __builtin_convertvector(static_cast<Byte>(low) + Y, LaneWords);
+                break;
+            case AddressingMode::Absolute:
+                cycles += 2;
+                address = LaneWords{} + absolute;
+                break;
+            case AddressingMode::AbsoluteX:
+                cycles += 2;
+                address = indexed(LaneWords{} + absolute, X);
+                break;
+            case AddressingMode::AbsoluteY:
+                cycles += 2;
+                address = indexed(LaneWords{} + absolute, Y);
+                break;
+            case AddressingMode::IndexedIndirect:
+                cycles += 4;
+                address = pointers(static_cast<Byte>(low) + X);
+                break;
+            case AddressingMode::IndirectIndexed:
+                cycles += 3;
+                address = indexed(pointers(LaneBytes{} + low), Y);
+                break;
+            default:
+                gather = false;
+                break;
+        }
+
+        const bool store = operation == Operation::STA || operation == Operation::STX ||
+                           operation == Operation::STY;
+
+        if (gather && !store) {
+            for (std::size_t lane = leader; lane < LANES; lane++) {
+                if (mask[lane]) {
+                    operand[lane] = static_cast<const Memory&>(memories[lane])[address[lane]];
+                }
+            }
+        }
+
+        PC = Select(wordMask, LaneWords{} + static_cast<Word>(pc + instruction.length), PC);
+        elapsed += (cycles + (CycleMask<LaneCycles>(pageCrossed) & 1)) & cycleMask;
+
+        // Semantics for all lanes at once; results are kept only where masked
+
+        const LaneBytes carry = P & LANE_CARRY;
+        const Byte nzcv = LANE_NEGATIVE | LANE_ZERO | LANE_CARRY | LANE_OVERFLOW;
+
+        auto addWithCarry = [&](LaneBytes value) {
+            LaneBytes partial = A + value;
+            LaneBytes sum = partial + carry;
+            LaneBytes carryOut = (Mask(partial < A) | Mask(sum < partial)) & LANE_CARRY;
+            LaneBytes overflow = ((A ^ sum) & (value ^ sum) & 0x80) >> 1;
+            P = Select(mask, ZeroAndNegative((P & static_cast<Byte>(~nzcv)) | carryOut | overflow, sum), P);
+            A = Select(mask, sum, A);
+        };
+
+        auto compare = [&](LaneBytes reg) {
+            LaneBytes carryOut = Mask(reg >= operand) & LANE_CARRY;
+            LaneBytes p = (P & static_cast<Byte>(~LANE_CARRY)) | carryOut;
+            P = Select(mask, ZeroAndNegative(p, reg - operand), P);
+        };
+
+        auto load = [&](LaneBytes& reg, LaneBytes value) {
+            reg = Select(mask, value, reg);
+            P = Select(mask, ZeroAndNegative(P, value), P);
+        };
+
+        auto setFlag = [&](Byte flag, bool value) {
+            LaneBytes p = value ? (P | flag) : (P & static_cast<Byte>(~flag));
+            P = Select(mask, p, P);
+        };
+
+        auto shift = [&](LaneBytes result, LaneBytes carryOut) {
+            LaneBytes p = (P & static_cast<Byte>(~LANE_CARRY)) | (carryOut & LANE_CARRY);
+            P = Select(mask, ZeroAndNegative(p, result), P);
+            A = Select(mask, result, A);
+        };
+
+        switch (operation) {
+            case Operation::LDA: load(A, operand); break;
+            case Operation::LDX: load(X, operand); break;
+            case Operation::LDY: load(Y, operand); break;
+
+            case Operation::STA:
+            case Operation::STX:
+            case Operation::STY: {
+                const LaneBytes& source = operation == Operation::STA ? A
+                                        : operation == Operation::STX ? X : Y;
+                NoCycles none;
+                for (std::size_t lane = leader; lane < LANES; lane++) {
+                    if (mask[lane]) {
+                        memories[lane].WriteByte(address[lane], source[lane], none);
+                    }
+                }
+                break;
+            }
+
+            case Operation::AND: load(A, A & operand); break;
+            case Operation::ORA: load(A, A | operand); break;
+            case Operation::EOR: load(A, A ^ operand); break;
+
+            case Operation::BIT: {
+                LaneBytes p = (P & static_cast<Byte>(~(LANE_ZERO | LANE_NEGATIVE | LANE_OVERFLOW)))
+                            | (Mask((A & operand) == 0) & LANE_ZERO)
+                            | (operand & (LANE_NEGATIVE | LANE_OVERFLOW));
+                P = Select(mask, p, P);
+                break;
+            }
+
+            case Operation::ADC: addWithCarry(operand); break;
+            case Operation::SBC: addWithCarry(~operand); break;
+
+            case Operation::CMP: compare(A); break;
+            case Operation::CPX: compare(X); break;
+            case Operation::CPY: compare(Y); break;
+
+            case Operation::TAX: load(X, A); break;
+            case Operation::TAY: load(Y, A); break;
+            case Operation::TXA: load(A, X); break;
+            case Operation::TYA: load(A, Y); break;
+            case Operation::TSX: load(X, SP); break;
+            case Operation::TXS: SP = Select(mask, X, SP); break;
+
+            case Operation::INX: load(X, X + 1); break;
+            case Operation::INY: load(Y, Y + 1); break;
+            case Operation::DEX: load(X, X - 1); break;
+            case Operation::DEY: load(Y, Y - 1); break;
+
+            case Operation::ASL_ACC: shift(A << 1, A >> 7); break;
+            case Operation::LSR_ACC: shift(A >> 1, A); break;
+            case Operation::ROL_ACC: shift((A << 1) | carry, A >> 7); break;
+            case Operation::ROR_ACC: shift((A >> 1) | (carry << 7), A); break;
+
+            case Operation::CLC: setFlag(LANE_CARRY, false); break;
+            case Operation::SEC: setFlag(LANE_CARRY, true); break;
+            case Operation::CLV: setFlag(LANE_OVERFLOW, false); break;
+            case Operation::CLD: setFlag(LANE_DECIMAL, false); break;
+            case Operation::SED: setFlag(LANE_DECIMAL, true); break;
+            case Operation::CLI: setFlag(LANE_INTERRUPT, false); break;
+            case Operation::SEI: setFlag(LANE_INTERRUPT, true); break;
+
+            default:
+                // NOP: nothing beyond PC and cycles
+                break;
+        }
+    }
+
+} // namespace M6502
+
+#endif // M6502_HAS_LOCKSTEP
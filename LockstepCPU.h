@@ -0,0 +1,190 @@
+/**
+ * @file LockstepCPU.h
+ * @brief Structure-of-arrays core running many CPUs in SIMD lockstep
+ */
+
+#ifndef M6502_LOCKSTEP_CPU_H
+#define M6502_LOCKSTEP_CPU_H
+
+#include "CodeObserver.h"
+#include "Constants.h"
+#include "CPU.h"
+#include "Memory.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// The lane registers use the GCC/Clang vector extensions, which lower
+// to SSE2 (16 byte lanes), AVX2 (32 byte lanes, with -mavx2) or NEON
+// without hand-written intrinsics. Other compilers do not get the
+// lockstep core.
+#if defined(__GNUC__) || defined(__clang__)
+    #define M6502_HAS_LOCKSTEP 1
+#else
+    #define M6502_HAS_LOCKSTEP 0
+#endif
+
+#ifndef M6502_LOCKSTEP_LANES
+    #if defined(__AVX2__)
+        #define M6502_LOCKSTEP_LANES 32
+    #else
+        #define M6502_LOCKSTEP_LANES 16
+    #endif
+#endif
+
+#if M6502_HAS_LOCKSTEP
+
+namespace M6502 {
+
+    /**
+     * @brief LANES independent CPUs with their registers stored lane-wise
+     *
+     * Meant for running one program on many machines that differ only
+     * in RAM or starting registers (fuzzing, input sweeps). Each lane
+     * has its own Memory; the register file is one SIMD vector per
+     * register, lane i of each vector belonging to CPU i.
+     *
+     * Every step picks the lanes at the lowest PC whose instruction bytes
+     * match, and runs that instruction for all of them at once. Loads,
+     * stores, ALU operations (ADC, SBC, compares, logic, BIT), register
+     * transfers, increments, accumulator shifts, flag instructions,
+     * branches and JMP execute as vector operations with per-lane
+     * addresses and cycle counts. Anything else (stack, calls, read-
+     * modify-write, decimal-mode arithmetic) runs lane by lane through
+     * the scalar CPU. Lanes that diverge at a branch regroup when their
+     * PCs meet again; lowest-PC-first lets a lane that is behind catch
+     * up.
+     *
+     * Code is checked for sharing a page at a time: a page whose bytes
+     * are identical in every lane is trusted until one of the lanes
+     * writes to it (the core watches the lane memories as their
+     * CodeObserver while RunFor() runs). Instructions in pages that
+     * differ between lanes are compared lane by lane instead.
+     *
+     * Each lane ends in exactly the state CPU::RunFor() would leave it
+     * in, cycle counts included. There are no interrupt inputs.
+     */
+    class LockstepCPU : public CodeObserver {
+    public:
+        static constexpr std::size_t LANES = M6502_LOCKSTEP_LANES;
+
+        /// One byte register for every lane
+        typedef Byte LaneBytes __attribute__((vector_size(M6502_LOCKSTEP_LANES)));
+
+        /// One word register for every lane
+        typedef Word LaneWords __attribute__((vector_size(2 * M6502_LOCKSTEP_LANES)));
+
+        // Registers, lane i belonging to CPU i
+        LaneBytes A;
+        LaneBytes X;
+        LaneBytes Y;
+        LaneBytes SP;
+        LaneBytes P;                            ///< Packed status byte
+        LaneWords PC;
+        std::array<Cycles, LANES> TotalCycles;
+
+        LockstepCPU();
+
+        LockstepCPU(const LockstepCPU&) = delete;
+        LockstepCPU& operator=(const LockstepCPU&) = delete;
+
+        Memory& LaneMemory(std::size_t lane) { return memories[lane]; }
+        const Memory& LaneMemory(std::size_t lane) const { return memories[lane]; }
+
+        /**
+         * @brief Reset every lane from its own reset vector, like CPU::Reset()
+         */
+        void Reset();
+
+        /**
+         * @brief Run every lane until it has executed at least `budget` cycles
+         *
+         * The lane memories' code observer belongs to the core for the
+         * duration of the call and is detached afterwards.
+         */
+        void RunFor(Cycles budget);
+
+        /// Instructions run as one vector operation, and the lanes they covered
+        std::uint64_t VectorSteps() const { return vectorSteps; }
+        std::uint64_t VectorLaneSteps() const { return vectorLaneSteps; }
+
+        /// Instructions run one lane at a time through the scalar CPU
+        std::uint64_t ScalarSteps() const { return scalarSteps; }
+
+        void ResetStatistics();
+
+        void OnCodeWrite(Address address) override;
+        void OnCodePageChanged(Byte page) override;
+
+    private:
+        /// Per-lane cycle counters for one RunFor() call
+        typedef Cycles LaneCycles __attribute__((vector_size(8 * M6502_LOCKSTEP_LANES)));
+
+        /// Whether a page holds the same bytes in every lane
+        enum class PageState : Byte {
+            Unknown,    ///< Not checked since the last write
+            Shared,     ///< Identical everywhere; watched for writes
+            Mixed       ///< Differs (or keeps being written); compare per instruction
+        };
+
+        // Operation names from OpcodeTable.h
+        enum class Operation : Byte {
+            LDA, LDX, LDY, STA, STX, STY,
+            TAX, TAY, TXA, TYA, TSX, TXS,
+            PHA, PHP, PLA, PLP,
+            AND, ORA, EOR, BIT,
+            ADC, SBC, CMP, CPX, CPY,
+            INC, INX, INY, DEC, DEX, DEY,
+            ASL_ACC, ASL_MEM, LSR_ACC, LSR_MEM, ROL_ACC, ROL_MEM, ROR_ACC, ROR_MEM,
+            JMP, JSR, RTS, RTI,
+            CLC, CLD, CLI, CLV, SEC, SED, SEI,
+            BRK, NOP,
+            Branch, Illegal
+        };
+
+        struct Instruction {
+            Operation operation;
+            AddressingMode mode;
+            bool pageCrossPenalty;
+            bool vector;        ///< Has a lane-parallel implementation
+            Byte length;
+            Byte branchFlag;
+            bool branchExpected;
+        };
+
+        static const std::array<Instruction, 256> InstructionTable;
+        static constexpr std::array<Instruction, 256> BuildInstructionTable();
+
+        /**
+         * @brief True if the `length` bytes at `pc` are known equal in every lane
+         */
+        bool SharedCode(Word pc, Byte length);
+        bool SharedPage(Byte page);
+
+        /**
+         * @brief Run one instruction on the lanes in `mask`, all at PC `pc`
+         */
+        void ExecuteVector(const Instruction& instruction, LaneBytes mask, Word pc,
+                           LaneCycles& elapsed);
+
+        /**
+         * @brief Run one instruction on `lane` through the scalar CPU
+         */
+        void ExecuteScalar(std::size_t lane, LaneCycles& elapsed);
+
+        std::vector<Memory> memories;
+        CPU scalar;
+
+        std::array<PageState, Memory::PAGE_COUNT> pages;
+        std::array<Byte, Memory::PAGE_COUNT> pageChecks;    ///< Re-checks this run
+
+        std::uint64_t vectorSteps;
+        std::uint64_t vectorLaneSteps;
+        std::uint64_t scalarSteps;
+    };
+
+} // namespace M6502
+
+#endif // M6502_HAS_LOCKSTEP
+
+#endif // M6502_LOCKSTEP_CPU_H
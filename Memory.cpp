@@ -4,69 +4,219 @@
  */
 
 #include "Memory.h"
+#include "Snapshot.h"
+#include <algorithm>
 #include <cstring>
+#include <vector>
 
 namespace M6502 {
 
-    Memory::Memory() {
+    Memory::Memory()
+        : codeObserver(nullptr), readWatchedPages(0), accessWatcher(nullptr), dirtyCount(0) {
+        writeHooks.fill(0);
+        readWatched.fill(false);
+        dirtyPages.fill(false);
         Initialize();
     }
 
     void Memory::Initialize() {
         // Clear all memory to zero (simulates power-on state)
         data.fill(0);
+        MarkAllPagesDirty();
+
+        // Any cached code is now stale
+        NotifyAllCodePagesChanged();
+    }
+
+    void Memory::LoadImage(const Byte* image) {
+        std::memcpy(data.data(), image, MEMORY_SIZE);
+        MarkAllPagesDirty();
+        NotifyAllCodePagesChanged();
+    }
+
+    bool Memory::LoadProgram(Address start, const Byte* program, std::size_t size) {
+        if (size > MEMORY_SIZE - start) {
+            return false;
+        }
+        if (size == 0) {
+            return true;
+        }
+
+        std::memcpy(data.data() + start, program, size);
+
+        const std::size_t lastPage = (start + size - 1) >> 8;
+        for (std::size_t page = start >> 8; page <= lastPage; page++) {
+            if (!dirtyPages[page]) {
+                MarkPageDirty(static_cast<Byte>(page));
+            }
+            if (writeHooks[page] & HOOK_CODE) {
+                codeObserver->OnCodePageChanged(static_cast<Byte>(page));
+            }
+        }
+        return true;
+    }
+
+    // ====================================================================
+    // SNAPSHOTS
+    // ====================================================================
+
+    void Memory::SaveState(SnapshotWriter& writer, bool compress) const {
+        if (!compress) {
+            writer.WriteBytes(data.data(), MEMORY_SIZE);
+            return;
+        }
+
+        // Records of (zero count, literal count, literals). Counts are
+        // 16-bit, so a long run is split across several records.
+        std::size_t position = 0;
+        while (position < MEMORY_SIZE) {
+            std::size_t zeros = 0;
+            while (position + zeros < MEMORY_SIZE && zeros < 0xFFFF && data[position + zeros] == 0) {
+                zeros++;
+            }
+            position += zeros;
+
+            std::size_t literals = 0;
+            while (position + literals < MEMORY_SIZE && literals < 0xFFFF &&
+                   data[position + literals] != 0) {
+                literals++;
+            }
+
+            writer.WriteWord(static_cast<Word>(zeros));
+            writer.WriteWord(static_cast<Word>(literals));
+            writer.WriteBytes(data.data() + position, literals);
+            position += literals;
+        }
+    }
+
+    bool Memory::LoadState(SnapshotReader& reader, bool compressed) {
+        if (!compressed) {
+            const Byte* image = reader.ReadBytes(MEMORY_SIZE);
+            if (image == nullptr) {
+                return false;
+            }
+            LoadImage(image);
+            return true;
+        }
+
+        // Decode into a scratch image so a truncated or corrupt stream
+        // leaves memory untouched; only a complete one is committed
+        std::vector<Byte> image(MEMORY_SIZE);
+        std::size_t position = 0;
+        while (position < MEMORY_SIZE) {
+            Word zeros, literals;
+            if (!reader.ReadWord(zeros) || !reader.ReadWord(literals) ||
+                position + zeros + literals > MEMORY_SIZE) {
+                return false;
+            }
+
+            const Byte* bytes = reader.ReadBytes(literals);
+            if (bytes == nullptr) {
+                return false;
+            }
+
+            // The scratch image starts zeroed, so zero runs are skipped
+            position += zeros;
+            std::copy_n(bytes, literals, image.begin() + position);
+            position += literals;
+        }
+
+        LoadImage(image.data());
+        return true;
+    }
+
+    // ====================================================================
+    // DIRTY PAGES
+    // ====================================================================
+
+    void Memory::ClearDirtyPages() {
+        for (std::size_t i = 0; i < dirtyCount; i++) {
+            dirtyPages[dirtyList[i]] = false;
+        }
+        dirtyCount = 0;
+    }
+
+    void Memory::RestorePage(Byte page, const Byte* contents) {
+        std::memcpy(data.data() + (page << 8), contents, PAGE_SIZE);
+        if (writeHooks[page] & HOOK_CODE) {
+            codeObserver->OnCodePageChanged(page);
+        }
     }
 
-    Byte Memory::ReadByte(Address address, Cycles& cycles) {
-        // Reading from memory takes 1 cycle
-        cycles++;
-        return data[address];
+    void Memory::MarkAllPagesDirty() {
+        for (std::size_t page = 0; page < PAGE_COUNT; page++) {
+            if (!dirtyPages[page]) {
+                MarkPageDirty(static_cast<Byte>(page));
+            }
+        }
     }
 
-    Byte Memory::ReadByteNoCycles(Address address) const {
-        return data[address];
+    // ====================================================================
+    // CODE WATCHING
+    // ====================================================================
+
+    void Memory::SetCodeObserver(CodeObserver* observer) {
+        codeObserver = observer;
+        for (Byte& hooks : writeHooks) {
+            hooks &= static_cast<Byte>(~HOOK_CODE);
+        }
     }
 
-    void Memory::WriteByte(Address address, Byte value, Cycles& cycles) {
-        // Writing to memory takes 1 cycle
-        cycles++;
-        data[address] = value;
+    void Memory::WatchCodePage(Byte page) {
+        if (codeObserver != nullptr) {
+            writeHooks[page] |= HOOK_CODE;
+        }
     }
 
-    Word Memory::ReadWord(Address address, Cycles& cycles) {
-        // Read low byte (LSB)
-        Byte lowByte = ReadByte(address, cycles);
-        
-        // Read high byte (MSB)
-        Byte highByte = ReadByte(address + 1, cycles);
-        
-        // Combine into 16-bit word (little-endian)
-        // Example: lowByte = 0x34, highByte = 0x12 -> result = 0x1234
-        Word word = (static_cast<Word>(highByte) << 8) | lowByte;
-        
-        return word;
+    void Memory::NotifyCodeWrite(Address address) {
+        codeObserver->OnCodeWrite(address);
     }
 
-    void Memory::WriteWord(Address address, Word value, Cycles& cycles) {
-        // Extract low byte (bits 0-7)
-        Byte lowByte = value & 0xFF;
-        
-        // Extract high byte (bits 8-15)
-        Byte highByte = (value >> 8) & 0xFF;
-        
-        // Write low byte first (little-endian)
-        WriteByte(address, lowByte, cycles);
-        
-        // Write high byte
-        WriteByte(address + 1, highByte, cycles);
+    void Memory::NotifyAllCodePagesChanged() {
+        for (std::size_t page = 0; page < PAGE_COUNT; page++) {
+            if (writeHooks[page] & HOOK_CODE) {
+                codeObserver->OnCodePageChanged(static_cast<Byte>(page));
+            }
+        }
+    }
+
+    // ====================================================================
+    // ACCESS WATCHING
+    // ====================================================================
+
+    void Memory::SetAccessWatcher(AccessWatcher* watcher) {
+        accessWatcher = watcher;
+        readWatched.fill(false);
+        readWatchedPages = 0;
+        for (Byte& hooks : writeHooks) {
+            hooks &= static_cast<Byte>(~HOOK_WATCH);
+        }
     }
 
-    Byte& Memory::operator[](Address address) {
-        return data[address];
+    void Memory::WatchAccesses(Byte page, Byte kinds) {
+        if (accessWatcher == nullptr) {
+            return;
+        }
+        const bool read = (kinds & AccessWatcher::WATCH_READ) != 0;
+        if (read != readWatched[page]) {
+            readWatched[page] = read;
+            readWatchedPages = read ? readWatchedPages + 1 : readWatchedPages - 1;
+        }
+        if (kinds & AccessWatcher::WATCH_WRITE) {
+            writeHooks[page] |= HOOK_WATCH;
+        } else {
+            writeHooks[page] &= static_cast<Byte>(~HOOK_WATCH);
+        }
     }
 
-    const Byte& Memory::operator[](Address address) const {
-        return data[address];
+    void Memory::NotifyHookedWrite(Address address, Byte value) {
+        const Byte hooks = writeHooks[address >> 8];
+        if (hooks & HOOK_CODE) {
+            NotifyCodeWrite(address);
+        }
+        if (hooks & HOOK_WATCH) {
+            accessWatcher->OnWatchedWrite(address, value);
+        }
     }
 
 } // namespace M6502
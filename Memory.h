@@ -0,0 +1,305 @@
+/**
+ * @file Memory.h
+ * @brief 64 KiB flat memory for the 6502 emulator
+ */
+
+#ifndef M6502_MEMORY_H
+#define M6502_MEMORY_H
+
+#include "Constants.h"
+#include "AccessWatcher.h"
+#include "CodeObserver.h"
+#include "IORecorder.h"
+#include <array>
+
+namespace M6502 {
+
+    class SnapshotWriter;
+    class SnapshotReader;
+
+    /**
+     * @brief Flat 64 KiB address space
+     *
+     * Every read and write through the cycle-counting accessors costs
+     * exactly one clock cycle, which is how the CPU accounts for bus
+     * traffic. operator[] gives untimed access for loading programs and
+     * inspecting results.
+     *
+     * The counter type is a template parameter so the functional core
+     * can pass NoCycles (Timing.h) and have the counting compile away.
+     */
+    class Memory {
+    public:
+        static constexpr std::size_t PAGE_SIZE = 0x100;
+        static constexpr std::size_t PAGE_COUNT = MEMORY_SIZE / PAGE_SIZE;
+
+        Memory();
+
+        /**
+         * @brief Clear the whole address space to zero
+         */
+        void Initialize();
+
+        template <typename Counter>
+        Byte ReadByte(Address address, Counter& cycles);
+
+        Byte ReadByteNoCycles(Address address) const;
+
+        template <typename Counter>
+        void WriteByte(Address address, Byte value, Counter& cycles);
+
+        template <typename Counter>
+        Word ReadWord(Address address, Counter& cycles);
+
+        template <typename Counter>
+        void WriteWord(Address address, Word value, Counter& cycles);
+
+        /**
+         * @brief Untimed access for loading programs and inspecting results
+         *
+         * The non-const overload counts as a write for code watching,
+         * since the caller may store through the reference.
+         */
+        Byte& operator[](Address address);
+        const Byte& operator[](Address address) const;
+
+        /**
+         * @brief Report writes to watched pages to `observer` (nullptr detaches)
+         *
+         * Changing the observer clears every watched page.
+         */
+        void SetCodeObserver(CodeObserver* observer);
+
+        /**
+         * @brief Start reporting writes to `page` to the code observer
+         */
+        void WatchCodePage(Byte page);
+
+        /**
+         * @brief Report CPU accesses to watched pages to `watcher` (nullptr detaches)
+         *
+         * Changing the watcher clears every watched page.
+         */
+        void SetAccessWatcher(AccessWatcher* watcher);
+
+        /**
+         * @brief Report the AccessWatcher::WATCH_* `kinds` of access to `page`
+         *
+         * Replaces the page's previous kinds; 0 stops watching it. Ignored
+         * without a watcher.
+         */
+        void WatchAccesses(Byte page, Byte kinds);
+
+        /**
+         * @brief True while any page is read-watched
+         *
+         * ReadByte() does not test for watched pages: that flag test on
+         * every read cost about 14% with nothing watched. Only an armed
+         * debugger watches pages, and it makes the CPU step through its
+         * instrumented path, which then calls ReportRead() for each
+         * address the instruction is about to read.
+         */
+        bool ReadsWatched() const { return readWatchedPages != 0; }
+
+        /**
+         * @brief Tell the watcher about a CPU read of `address`, if its page is read-watched
+         */
+        void ReportRead(Address address) {
+            if (readWatched[address >> 8]) {
+                accessWatcher->OnWatchedRead(address, data[address]);
+            }
+        }
+
+        /**
+         * @brief Flat memory has no device pages; any page may hold cached code
+         */
+        bool IsIOPage(Byte /* page */) const { return false; }
+
+        /**
+         * @brief Nothing here is clock-sensitive; see MemoryBus::HasDevices()
+         */
+        bool HasDevices() const { return false; }
+
+        /**
+         * @brief No devices, so never; see MemoryBus::NextDeviceDeadline()
+         */
+        Cycles NextDeviceDeadline() const { return ~Cycles{0}; }
+
+        /**
+         * @brief No I/O pages, so nothing to record; see MemoryBus::SetIORecorder()
+         */
+        void SetIORecorder(IORecorder* /* recorder */) {}
+
+        /**
+         * @brief Write the 64 KiB image, raw or zero-run compressed (see Snapshot.h)
+         */
+        void SaveState(SnapshotWriter& writer, bool compress) const;
+
+        /**
+         * @brief Read back what SaveState() wrote
+         * @return false if the data ran out or does not decode to 64 KiB;
+         *         memory is then unchanged
+         */
+        bool LoadState(SnapshotReader& reader, bool compressed);
+
+        /**
+         * @brief Replace the whole image with 64 KiB from `image`
+         */
+        void LoadImage(const Byte* image);
+
+        /**
+         * @brief Copy `size` bytes to `start`, as a run of operator[] writes would
+         * @return false (and nothing copied) if they run past $FFFF
+         */
+        bool LoadProgram(Address start, const Byte* program, std::size_t size);
+
+        /**
+         * @brief Whether `page` has been written since ClearDirtyPages()
+         *
+         * Every write marks its page: WriteByte, WriteWord, the non-const
+         * operator[] and the bulk loaders (which mark every page).
+         */
+        bool IsPageDirty(Byte page) const { return dirtyPages[page]; }
+
+        std::size_t DirtyPageCount() const { return dirtyCount; }
+
+        /**
+         * @brief The dirty pages, in the order they were first written
+         */
+        const Byte* DirtyPageList() const { return dirtyList.data(); }
+
+        void ClearDirtyPages();
+
+        /**
+         * @brief The PAGE_SIZE bytes of `page`
+         */
+        const Byte* PageData(Byte page) const { return data.data() + (page << 8); }
+
+        /**
+         * @brief Overwrite a whole page without marking it dirty
+         *
+         * For rolling back to a checkpoint: the page ends up as it was at
+         * the checkpoint, so it is clean relative to it. Cached code in
+         * the page is dropped.
+         */
+        void RestorePage(Byte page, const Byte* contents);
+
+    private:
+        // Reasons a page's writes leave the fast path (writeHooks bits)
+        static constexpr Byte HOOK_CODE = 0x01;     ///< Holds cached code
+        static constexpr Byte HOOK_WATCH = 0x02;    ///< Write-watched
+
+        void NotifyCodeWrite(Address address);
+        void NotifyAllCodePagesChanged();
+
+        void NotifyHookedWrite(Address address, Byte value);
+
+        void MarkPageDirty(Byte page) {
+            dirtyPages[page] = true;
+            dirtyList[dirtyCount++] = page;
+        }
+
+        void MarkAllPagesDirty();
+
+        std::array<Byte, MEMORY_SIZE> data;
+
+        // HOOK_* bits per page. Cached code and write watchpoints share
+        // one test, so the write path costs what it did before watching.
+        std::array<Byte, PAGE_COUNT> writeHooks;
+        CodeObserver* codeObserver;
+
+        // Read-watched pages and how many there are, and who to tell
+        // about watched accesses
+        std::array<bool, PAGE_COUNT> readWatched;
+        std::size_t readWatchedPages;
+        AccessWatcher* accessWatcher;
+
+        // Pages written since the last ClearDirtyPages(), as flags for the
+        // write path and as a list so consumers only visit dirty pages
+        std::array<bool, PAGE_COUNT> dirtyPages;
+        std::array<Byte, PAGE_COUNT> dirtyList;
+        std::size_t dirtyCount;
+    };
+
+    // ====================================================================
+    // INLINE ACCESSORS
+    // ====================================================================
+
+    // Defined here so BasicCPU<Memory> compiles every access down to a
+    // plain load or store with no call.
+
+    template <typename Counter>
+    inline Byte Memory::ReadByte(Address address, Counter& cycles) {
+        // Reading from memory takes 1 cycle
+        cycles++;
+        return data[address];
+    }
+
+    inline Byte Memory::ReadByteNoCycles(Address address) const {
+        return data[address];
+    }
+
+    template <typename Counter>
+    inline void Memory::WriteByte(Address address, Byte value, Counter& cycles) {
+        // Writing to memory takes 1 cycle
+        cycles++;
+        data[address] = value;
+
+        if (!dirtyPages[address >> 8]) {
+            MarkPageDirty(static_cast<Byte>(address >> 8));
+        }
+
+        // Keep cached code in sync with self-modifying programs, and
+        // report watched writes
+        if (writeHooks[address >> 8]) {
+            NotifyHookedWrite(address, value);
+        }
+    }
+
+    template <typename Counter>
+    inline Word Memory::ReadWord(Address address, Counter& cycles) {
+        // Read low byte (LSB)
+        Byte lowByte = ReadByte(address, cycles);
+        
+        // Read high byte (MSB)
+        Byte highByte = ReadByte(address + 1, cycles);
+        
+        // Combine into 16-bit word (little-endian)
+        // Example: lowByte = 0x34, highByte = 0x12 -> result = 0x1234
+        Word word = (static_cast<Word>(highByte) << 8) | lowByte;
+        
+        return word;
+    }
+
+    template <typename Counter>
+    inline void Memory::WriteWord(Address address, Word value, Counter& cycles) {
+        // Extract low byte (bits 0-7)
+        Byte lowByte = value & 0xFF;
+        
+        // Extract high byte (bits 8-15)
+        Byte highByte = (value >> 8) & 0xFF;
+        
+        // Write low byte first (little-endian)
+        WriteByte(address, lowByte, cycles);
+        
+        // Write high byte
+        WriteByte(address + 1, highByte, cycles);
+    }
+
+    inline Byte& Memory::operator[](Address address) {
+        if (!dirtyPages[address >> 8]) {
+            MarkPageDirty(static_cast<Byte>(address >> 8));
+        }
+        if (writeHooks[address >> 8] & HOOK_CODE) {
+            NotifyCodeWrite(address);
+        }
+        return data[address];
+    }
+
+    inline const Byte& Memory::operator[](Address address) const {
+        return data[address];
+    }
+
+} // namespace M6502
+
+#endif // M6502_MEMORY_H
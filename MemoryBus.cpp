@@ -0,0 +1,253 @@
+/**
+ * @file MemoryBus.cpp
+ * @brief Implementation of the page-mapped memory bus
+ */
+
+#include "MemoryBus.h"
+#include <cstring>
+
+namespace M6502 {
+
+    namespace {
+        const Cycles NO_CLOCK = 0;
+    }
+
+    MemoryBus::MemoryBus()
+        : hasDevices(false), clock(&NO_CLOCK), codeObserver(nullptr), accessWatcher(nullptr),
+          ioRecorder(nullptr) {
+        codePages.fill(false);
+        watchedPages.fill(0);
+        devices.fill(nullptr);
+        Initialize();
+        MapInternalRAM(0x00, PAGE_COUNT);
+    }
+
+    void MemoryBus::Initialize() {
+        // Clear internal RAM (simulates power-on state)
+        ram.fill(0);
+
+        // Cached code may have come from internal RAM; drop all of it
+        for (std::size_t page = 0; page < PAGE_COUNT; page++) {
+            if (codePages[page]) {
+                codeObserver->OnCodePageChanged(static_cast<Byte>(page));
+            }
+        }
+    }
+
+    // ====================================================================
+    // MAPPING
+    // ====================================================================
+
+    void MemoryBus::MapRAM(Byte firstPage, std::size_t pageCount, Byte* backing) {
+        for (std::size_t i = 0; i < pageCount && firstPage + i < PAGE_COUNT; i++) {
+            std::size_t page = firstPage + i;
+            NotifyPageRemapped(page);
+            mappedReads[page] = backing + i * PAGE_SIZE;
+            mappedWrites[page] = backing + i * PAGE_SIZE;
+            readHandlers[page] = nullptr;
+            writeHandlers[page] = nullptr;
+            handlerContexts[page] = nullptr;
+            devices[page] = nullptr;
+            UpdateDirectPages(page);
+        }
+        UpdateHasDevices();
+    }
+
+    void MemoryBus::MapROM(Byte firstPage, std::size_t pageCount, Byte* image) {
+        for (std::size_t i = 0; i < pageCount && firstPage + i < PAGE_COUNT; i++) {
+            std::size_t page = firstPage + i;
+            NotifyPageRemapped(page);
+            mappedReads[page] = image + i * PAGE_SIZE;
+            mappedWrites[page] = nullptr;   // no write handler: writes are dropped
+            readHandlers[page] = nullptr;
+            writeHandlers[page] = nullptr;
+            handlerContexts[page] = nullptr;
+            devices[page] = nullptr;
+            UpdateDirectPages(page);
+        }
+        UpdateHasDevices();
+    }
+
+    void MemoryBus::MapIO(Byte firstPage, std::size_t pageCount,
+                          ReadHandler read, WriteHandler write, void* context) {
+        for (std::size_t i = 0; i < pageCount && firstPage + i < PAGE_COUNT; i++) {
+            std::size_t page = firstPage + i;
+            NotifyPageRemapped(page);
+            mappedReads[page] = nullptr;
+            mappedWrites[page] = nullptr;
+            readHandlers[page] = read;
+            writeHandlers[page] = write;
+            handlerContexts[page] = context;
+            devices[page] = nullptr;
+            UpdateDirectPages(page);
+        }
+        UpdateHasDevices();
+    }
+
+    void MemoryBus::MapDevice(Byte firstPage, std::size_t pageCount, Device& device) {
+        for (std::size_t i = 0; i < pageCount && firstPage + i < PAGE_COUNT; i++) {
+            std::size_t page = firstPage + i;
+            NotifyPageRemapped(page);
+            mappedReads[page] = nullptr;
+            mappedWrites[page] = nullptr;
+            readHandlers[page] = nullptr;
+            writeHandlers[page] = nullptr;
+            handlerContexts[page] = nullptr;
+            devices[page] = &device;
+            UpdateDirectPages(page);
+        }
+        hasDevices = true;
+    }
+
+    void MemoryBus::MapInternalRAM(Byte firstPage, std::size_t pageCount) {
+        MapRAM(firstPage, pageCount, ram.data() + firstPage * PAGE_SIZE);
+    }
+
+    void MemoryBus::RestorePage(Byte page, const Byte* contents) {
+        Byte* storage = mappedReads[page] != nullptr ? mappedReads[page] : ram.data() + page * PAGE_SIZE;
+        std::memcpy(storage, contents, PAGE_SIZE);
+        NotifyPageRemapped(page);
+    }
+
+    bool MemoryBus::IsIOPage(Byte page) const {
+        // ROM pages have no write pointer either, but always a read pointer.
+        // Watched pages are still RAM or ROM, whichever path serves them.
+        return mappedReads[page] == nullptr;
+    }
+
+    void MemoryBus::SetClock(const Cycles* total) {
+        clock = total != nullptr ? total : &NO_CLOCK;
+    }
+
+    void MemoryBus::UpdateDirectPages(std::size_t page) {
+        // A watched page loses its direct pointer so the access reaches
+        // ReadIO/WriteIO, which report it
+        readPages[page] = (watchedPages[page] & AccessWatcher::WATCH_READ) ? nullptr : mappedReads[page];
+        writePages[page] = (watchedPages[page] & AccessWatcher::WATCH_WRITE) ? nullptr : mappedWrites[page];
+    }
+
+    void MemoryBus::UpdateHasDevices() {
+        hasDevices = false;
+        for (const Device* device : devices) {
+            hasDevices = hasDevices || device != nullptr;
+        }
+    }
+
+    Cycles MemoryBus::NextDeviceDeadline() const {
+        Cycles next = Device::NO_DEADLINE;
+        if (!hasDevices) {
+            return next;
+        }
+        for (const Device* device : devices) {
+            if (device != nullptr) {
+                const Cycles deadline = device->NextDeadline();
+                next = deadline < next ? deadline : next;
+            }
+        }
+        return next;
+    }
+
+    // ====================================================================
+    // CODE WATCHING
+    // ====================================================================
+
+    void MemoryBus::SetCodeObserver(CodeObserver* observer) {
+        codeObserver = observer;
+        codePages.fill(false);
+    }
+
+    void MemoryBus::WatchCodePage(Byte page) {
+        if (codeObserver != nullptr) {
+            codePages[page] = true;
+        }
+    }
+
+    void MemoryBus::NotifyCodeWrite(Address address) {
+        codeObserver->OnCodeWrite(address);
+    }
+
+    void MemoryBus::NotifyPageRemapped(std::size_t page) {
+        // The observer re-watches the page if it decodes from it again
+        if (codePages[page]) {
+            codePages[page] = false;
+            codeObserver->OnCodePageChanged(static_cast<Byte>(page));
+        }
+    }
+
+    // ====================================================================
+    // ACCESS WATCHING
+    // ====================================================================
+
+    void MemoryBus::SetAccessWatcher(AccessWatcher* watcher) {
+        accessWatcher = watcher;
+        watchedPages.fill(0);
+        for (std::size_t page = 0; page < PAGE_COUNT; page++) {
+            UpdateDirectPages(page);
+        }
+    }
+
+    void MemoryBus::WatchAccesses(Byte page, Byte kinds) {
+        if (accessWatcher != nullptr) {
+            watchedPages[page] = kinds;
+            UpdateDirectPages(page);
+        }
+    }
+
+    // ====================================================================
+    // DEVICE ACCESS
+    // ====================================================================
+
+    // Kept out of line so the inline RAM/ROM path in MemoryBus.h stays
+    // small; only I/O and watched pages pay for the handler call.
+
+    Byte MemoryBus::ReadIO(Address address, Cycles cycle) {
+        Byte page = address >> 8;
+        Byte value;
+        if (const Byte* backing = mappedReads[page]) {
+            // RAM or ROM sent here because the page is watched
+            value = backing[address & 0xFF];
+        } else if (ioRecorder != nullptr && ioRecorder->Replaying()) {
+            // The device answered this read the first time through
+            value = ioRecorder->ReplayIORead(address, cycle);
+        } else {
+            if (Device* device = devices[page]) {
+                device->CatchUp(cycle);
+                value = device->Read(address);
+            } else if (ReadHandler handler = readHandlers[page]) {
+                value = handler(handlerContexts[page], address);
+            } else {
+                value = 0xFF; // Open bus
+            }
+            if (ioRecorder != nullptr) {
+                ioRecorder->OnIORead(address, cycle, value);
+            }
+        }
+
+        if (watchedPages[page] & AccessWatcher::WATCH_READ) {
+            accessWatcher->OnWatchedRead(address, value);
+        }
+        return value;
+    }
+
+    void MemoryBus::WriteIO(Address address, Byte value, Cycles cycle) {
+        Byte page = address >> 8;
+        if (Byte* backing = mappedWrites[page]) {
+            backing[address & 0xFF] = value;
+            if (codePages[page]) {
+                NotifyCodeWrite(address);
+            }
+        } else if (ioRecorder != nullptr && ioRecorder->Replaying()) {
+            // The device took this write the first time through
+        } else if (Device* device = devices[page]) {
+            device->CatchUp(cycle);
+            device->Write(address, value);
+        } else if (WriteHandler handler = writeHandlers[page]) {
+            handler(handlerContexts[page], address, value);
+        }
+
+        if (watchedPages[page] & AccessWatcher::WATCH_WRITE) {
+            accessWatcher->OnWatchedWrite(address, value);
+        }
+    }
+
+} // namespace M6502
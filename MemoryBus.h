@@ -0,0 +1,323 @@
+/**
+ * @file MemoryBus.h
+ * @brief Page-mapped memory bus with RAM, ROM and memory-mapped I/O
+ */
+
+#ifndef M6502_MEMORY_BUS_H
+#define M6502_MEMORY_BUS_H
+
+#include "Constants.h"
+#include "AccessWatcher.h"
+#include "CodeObserver.h"
+#include "Device.h"
+#include "IORecorder.h"
+#include <array>
+#include <type_traits>
+
+namespace M6502 {
+
+    /**
+     * @brief 64 KiB address space split into 256 pages of 256 bytes
+     *
+     * Every page is mapped to one of:
+     *   - RAM: reads and writes go straight to a backing buffer
+     *   - ROM: reads go straight to a backing buffer, writes are ignored
+     *   - I/O: reads and writes call device handlers
+     *   - Device: reads and writes first catch a Device (Device.h) up to
+     *     the exact cycle of the access, then call it
+     *
+     * RAM and ROM accesses cost one table load and a null check, with no
+     * function-pointer call. Remapping is just a pointer update, so bank
+     * switching can be done from inside an I/O write handler.
+     *
+     * The access functions match Memory, including the templated cycle
+     * counter, so the CPU can run on either.
+     * A new bus maps every page to its own internal RAM and behaves
+     * exactly like Memory until something else is mapped.
+     */
+    class MemoryBus {
+    public:
+        using ReadHandler = Byte (*)(void* context, Address address);
+        using WriteHandler = void (*)(void* context, Address address, Byte value);
+
+        static constexpr std::size_t PAGE_SIZE = 0x100;
+        static constexpr std::size_t PAGE_COUNT = MEMORY_SIZE / PAGE_SIZE;
+
+        MemoryBus();
+
+        /**
+         * @brief Clear the internal RAM (mappings are kept)
+         */
+        void Initialize();
+
+        /**
+         * @brief Map pages to read/write storage
+         * @param backing At least pageCount * PAGE_SIZE bytes, owned by the caller
+         */
+        void MapRAM(Byte firstPage, std::size_t pageCount, Byte* backing);
+
+        /**
+         * @brief Map pages to read-only storage; CPU writes are dropped
+         *
+         * The image is not const so operator[] can still load it.
+         */
+        void MapROM(Byte firstPage, std::size_t pageCount, Byte* image);
+
+        /**
+         * @brief Map pages to device handlers
+         *
+         * A null read handler reads as $FF (open bus); a null write handler
+         * ignores writes. Handlers receive the full 16-bit address.
+         */
+        void MapIO(Byte firstPage, std::size_t pageCount,
+                   ReadHandler read, WriteHandler write, void* context);
+
+        /**
+         * @brief Map pages to a lazily synchronized Device
+         *
+         * Every access first runs the device up to the access's cycle
+         * stamp (see SetClock()). The device is owned by the caller.
+         */
+        void MapDevice(Byte firstPage, std::size_t pageCount, Device& device);
+
+        /**
+         * @brief Map pages back to the bus's internal RAM
+         */
+        void MapInternalRAM(Byte firstPage, std::size_t pageCount);
+
+        /**
+         * @brief True if the page is served by device handlers or a Device
+         */
+        bool IsIOPage(Byte page) const;
+
+        /**
+         * @brief True if any page is mapped to a Device
+         *
+         * The block cache then charges fetches instruction by instruction,
+         * so every access gets its exact cycle stamp.
+         */
+        bool HasDevices() const { return hasDevices; }
+
+        /**
+         * @brief Earliest Device::NextDeadline() of the mapped devices
+         *
+         * Device::NO_DEADLINE with no devices or none pending. A device
+         * mapped over several pages is asked once per page.
+         */
+        Cycles NextDeviceDeadline() const;
+
+        /**
+         * @brief Stamp Device accesses with `*total` plus the running batch's cycles
+         *
+         * Pass &cpu.TotalCycles of the CPU driving the bus. The CPU only
+         * adds a batch to TotalCycles when the batch returns. So during a
+         * batch, the access's absolute cycle is TotalCycles plus the
+         * batch's own counter, which every access receives anyway. The
+         * stamp counts the access's own cycle. nullptr stamps from 0.
+         */
+        void SetClock(const Cycles* total);
+
+        template <typename Counter>
+        Byte ReadByte(Address address, Counter& cycles);
+
+        Byte ReadByteNoCycles(Address address) const;
+
+        template <typename Counter>
+        void WriteByte(Address address, Byte value, Counter& cycles);
+
+        template <typename Counter>
+        Word ReadWord(Address address, Counter& cycles);
+
+        template <typename Counter>
+        void WriteWord(Address address, Word value, Counter& cycles);
+
+        /**
+         * @brief Untimed access to the storage behind an address
+         *
+         * RAM and ROM pages return their backing byte. I/O pages return
+         * the internal RAM byte underneath them; devices are not called.
+         */
+        Byte& operator[](Address address);
+        const Byte& operator[](Address address) const;
+
+        /**
+         * @brief Report writes to watched pages to `observer` (nullptr detaches)
+         *
+         * Changing the observer clears every watched page. Remapping a
+         * watched page reports the whole page as changed.
+         */
+        void SetCodeObserver(CodeObserver* observer);
+
+        /**
+         * @brief Start reporting writes to `page` to the code observer
+         */
+        void WatchCodePage(Byte page);
+
+        /**
+         * @brief Report CPU accesses to watched pages to `watcher` (nullptr detaches)
+         *
+         * Changing the watcher clears every watched page.
+         */
+        void SetAccessWatcher(AccessWatcher* watcher);
+
+        /**
+         * @brief Report the AccessWatcher::WATCH_* `kinds` of access to `page`
+         *
+         * A watched RAM or ROM page is served through the I/O path, so
+         * unwatched pages keep their direct access. Replaces the page's
+         * previous kinds; 0 stops watching it. Ignored without a watcher.
+         */
+        void WatchAccesses(Byte page, Byte kinds);
+
+        /**
+         * @brief Log I/O page reads to `recorder`, and let it replay them (nullptr detaches)
+         */
+        void SetIORecorder(IORecorder* recorder) { ioRecorder = recorder; }
+
+        /**
+         * @brief The PAGE_SIZE bytes behind `page`, as operator[] sees them
+         */
+        const Byte* PageData(Byte page) const { return &(*this)[static_cast<Address>(page << 8)]; }
+
+        /**
+         * @brief Overwrite the storage behind `page`, as operator[] would
+         *
+         * For rolling back to a checkpoint. ROM images are overwritten
+         * too, and I/O pages get the internal RAM underneath them.
+         * Cached code in the page is dropped.
+         */
+        void RestorePage(Byte page, const Byte* contents);
+
+    private:
+        template <typename Counter>
+        Cycles Stamp(const Counter& cycles) const;
+
+        Byte ReadIO(Address address, Cycles cycle);
+        void WriteIO(Address address, Byte value, Cycles cycle);
+
+        void NotifyCodeWrite(Address address);
+        void NotifyPageRemapped(std::size_t page);
+        void UpdateHasDevices();
+        void UpdateDirectPages(std::size_t page);
+
+        // Direct page pointers; null sends the access to the handlers.
+        // These are the mapped pointers below, except on watched pages.
+        std::array<Byte*, PAGE_COUNT> readPages;
+        std::array<Byte*, PAGE_COUNT> writePages;
+
+        // RAM and ROM backing as mapped; null on I/O and device pages
+        std::array<Byte*, PAGE_COUNT> mappedReads;
+        std::array<Byte*, PAGE_COUNT> mappedWrites;
+
+        std::array<ReadHandler, PAGE_COUNT> readHandlers;
+        std::array<WriteHandler, PAGE_COUNT> writeHandlers;
+        std::array<void*, PAGE_COUNT> handlerContexts;
+        std::array<Device*, PAGE_COUNT> devices;
+        bool hasDevices;
+
+        const Cycles* clock;
+
+        std::array<Byte, MEMORY_SIZE> ram;
+
+        // Pages holding cached code, and who to tell when they change
+        std::array<bool, PAGE_COUNT> codePages;
+        CodeObserver* codeObserver;
+
+        // AccessWatcher::WATCH_* bits per page, and who to tell
+        std::array<Byte, PAGE_COUNT> watchedPages;
+        AccessWatcher* accessWatcher;
+
+        IORecorder* ioRecorder;
+    };
+
+    // ====================================================================
+    // INLINE ACCESSORS
+    // ====================================================================
+
+    // Defined here so BasicCPU<MemoryBus> inlines the page-table lookup
+    // into every instruction; ReadIO/WriteIO stay in MemoryBus.cpp.
+
+    template <typename Counter>
+    inline Byte MemoryBus::ReadByte(Address address, Counter& cycles) {
+        // Reading from the bus takes 1 cycle, whatever is mapped there
+        cycles++;
+
+        Byte* page = readPages[address >> 8];
+        if (page != nullptr) {
+            return page[address & 0xFF];
+        }
+        return ReadIO(address, Stamp(cycles));
+    }
+
+    template <typename Counter>
+    inline Cycles MemoryBus::Stamp(const Counter& cycles) const {
+        // Only computed on the I/O path. The functional core has no
+        // per-access cycles, so its accesses share the batch's stamp.
+        if constexpr (std::is_same_v<Counter, Cycles>) {
+            return *clock + cycles;
+        } else {
+            return *clock;
+        }
+    }
+
+    inline Byte MemoryBus::ReadByteNoCycles(Address address) const {
+        return (*this)[address];
+    }
+
+    template <typename Counter>
+    inline void MemoryBus::WriteByte(Address address, Byte value, Counter& cycles) {
+        // Writing to the bus takes 1 cycle, whatever is mapped there
+        cycles++;
+
+        Byte* page = writePages[address >> 8];
+        if (page != nullptr) {
+            page[address & 0xFF] = value;
+
+            // Keep cached code in sync with self-modifying programs
+            if (codePages[address >> 8]) {
+                NotifyCodeWrite(address);
+            }
+            return;
+        }
+        WriteIO(address, value, Stamp(cycles));
+    }
+
+    template <typename Counter>
+    inline Word MemoryBus::ReadWord(Address address, Counter& cycles) {
+        // Two separate bus reads: either byte may hit a device
+        Byte lowByte = ReadByte(address, cycles);
+        Byte highByte = ReadByte(address + 1, cycles);
+        return (static_cast<Word>(highByte) << 8) | lowByte;
+    }
+
+    template <typename Counter>
+    inline void MemoryBus::WriteWord(Address address, Word value, Counter& cycles) {
+        // Low byte first (little-endian)
+        WriteByte(address, value & 0xFF, cycles);
+        WriteByte(address + 1, (value >> 8) & 0xFF, cycles);
+    }
+
+    inline Byte& MemoryBus::operator[](Address address) {
+        // The caller may store through the reference
+        if (codePages[address >> 8]) {
+            NotifyCodeWrite(address);
+        }
+
+        Byte* page = mappedReads[address >> 8];
+        if (page != nullptr) {
+            return page[address & 0xFF];
+        }
+        return ram[address];
+    }
+
+    inline const Byte& MemoryBus::operator[](Address address) const {
+        const Byte* page = mappedReads[address >> 8];
+        if (page != nullptr) {
+            return page[address & 0xFF];
+        }
+        return ram[address];
+    }
+
+} // namespace M6502
+
+#endif // M6502_MEMORY_BUS_H
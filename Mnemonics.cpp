@@ -0,0 +1,76 @@
+/**
+ * @file Mnemonics.cpp
+ * @brief Opcode name table built from OpcodeTable.h
+ */
+
+#include "Mnemonics.h"
+#include "OpcodeTable.h"
+#include <array>
+
+namespace M6502 {
+
+    namespace {
+
+        struct OpcodeName {
+            char mnemonic[4];
+            AddressingMode mode;
+        };
+
+        constexpr std::array<OpcodeName, 256> BuildNames() {
+            std::array<OpcodeName, 256> names{};
+            for (OpcodeName& name : names) {
+                name = { { '?', '?', '?', '\0' }, AddressingMode::Implied };
+            }
+
+            // The mnemonic is the three letters after "INS_" in the
+            // opcode's constant name
+            auto set = [&names](Byte opcode, const char* constant, AddressingMode mode) {
+                names[opcode] = { { constant[4], constant[5], constant[6], '\0' }, mode };
+            };
+
+            #define M6502_NAME_MEM(opcode, operation, mode, pageCross) set(opcode, #opcode, AddressingMode::mode);
+            #define M6502_NAME_IMP(opcode, operation, mode) set(opcode, #opcode, AddressingMode::mode);
+            #define M6502_NAME_STK(opcode, operation) set(opcode, #opcode, AddressingMode::Implied);
+            #define M6502_NAME_BRANCH(opcode, flag, expected) set(opcode, #opcode, AddressingMode::Relative);
+
+            M6502_OPCODE_TABLE(M6502_NAME_MEM, M6502_NAME_IMP, M6502_NAME_STK, M6502_NAME_BRANCH)
+
+            #undef M6502_NAME_MEM
+            #undef M6502_NAME_IMP
+            #undef M6502_NAME_STK
+            #undef M6502_NAME_BRANCH
+
+            return names;
+        }
+
+        constexpr std::array<OpcodeName, 256> NAMES = BuildNames();
+
+    } // namespace
+
+    const char* Mnemonic(Byte opcode) {
+        return NAMES[opcode].mnemonic;
+    }
+
+    AddressingMode ModeOf(Byte opcode) {
+        return NAMES[opcode].mode;
+    }
+
+    const char* OperandNotation(AddressingMode mode) {
+        switch (mode) {
+            case AddressingMode::Accumulator:     return "A";
+            case AddressingMode::Immediate:       return "#imm";
+            case AddressingMode::ZeroPage:        return "zp";
+            case AddressingMode::ZeroPageX:       return "zp,X";
+            case AddressingMode::ZeroPageY:       return "zp,Y";
+            case AddressingMode::Relative:        return "rel";
+            case AddressingMode::Absolute:        return "abs";
+            case AddressingMode::AbsoluteX:       return "abs,X";
+            case AddressingMode::AbsoluteY:       return "abs,Y";
+            case AddressingMode::Indirect:        return "(abs)";
+            case AddressingMode::IndexedIndirect: return "(zp,X)";
+            case AddressingMode::IndirectIndexed: return "(zp),Y";
+            default:                              return "";
+        }
+    }
+
+} // namespace M6502
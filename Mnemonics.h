@@ -0,0 +1,33 @@
+/**
+ * @file Mnemonics.h
+ * @brief Assembler names for opcodes, for reports and trace output
+ */
+
+#ifndef M6502_MNEMONICS_H
+#define M6502_MNEMONICS_H
+
+#include "Constants.h"
+#include "CPU.h"
+
+namespace M6502 {
+
+    /**
+     * @brief Three-letter mnemonic of `opcode` ("???" if it is illegal)
+     */
+    const char* Mnemonic(Byte opcode);
+
+    /**
+     * @brief Addressing mode of `opcode` from OpcodeTable.h (Implied if illegal)
+     */
+    AddressingMode ModeOf(Byte opcode);
+
+    /**
+     * @brief Operand shape in assembler notation: "#imm", "zp,X", "(zp),Y", ...
+     *
+     * Empty for implied instructions.
+     */
+    const char* OperandNotation(AddressingMode mode);
+
+} // namespace M6502
+
+#endif // M6502_MNEMONICS_H
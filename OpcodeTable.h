@@ -0,0 +1,220 @@
+/**
+ * @file OpcodeTable.h
+ * @brief Master list of every implemented opcode
+ *
+ * Each row binds an opcode to an operation and, for memory operations,
+ * an addressing mode. The list is expanded with different row macros to
+ * build the dispatch table, so adding an instruction means adding one
+ * row here.
+ *
+ * Row kinds:
+ *   MEM(opcode, operation, mode, pageCrossPenalty)
+ *       operation(Memory&, Cycles&, Address) on the resolved address
+ *   IMP(opcode, operation, mode)
+ *       operation(Cycles&) - implied and accumulator instructions
+ *   STK(opcode, operation)
+ *       operation(Memory&, Cycles&) - stack, return and break
+ *   BRANCH(opcode, flag, expected)
+ *       branch taken when GetFlag(flag) == expected
+ */
+
+#ifndef M6502_OPCODE_TABLE_H
+#define M6502_OPCODE_TABLE_H
+
+#define M6502_OPCODE_TABLE(MEM, IMP, STK, BRANCH)                           \
+    /* LDA - Load Accumulator */                                            \
+    MEM(INS_LDA_IM,   LDA, Immediate,       true)                           \
+    MEM(INS_LDA_ZP,   LDA, ZeroPage,        true)                           \
+    MEM(INS_LDA_ZPX,  LDA, ZeroPageX,       true)                           \
+    MEM(INS_LDA_ABS,  LDA, Absolute,        true)                           \
+    MEM(INS_LDA_ABSX, LDA, AbsoluteX,       true)                           \
+    MEM(INS_LDA_ABSY, LDA, AbsoluteY,       true)                           \
+    MEM(INS_LDA_INDX, LDA, IndexedIndirect, true)                           \
+    MEM(INS_LDA_INDY, LDA, IndirectIndexed, true)                           \
+    /* LDX - Load X Register */                                             \
+    MEM(INS_LDX_IM,   LDX, Immediate,       true)                           \
+    MEM(INS_LDX_ZP,   LDX, ZeroPage,        true)                           \
+    MEM(INS_LDX_ZPY,  LDX, ZeroPageY,       true)                           \
+    MEM(INS_LDX_ABS,  LDX, Absolute,        true)                           \
+    MEM(INS_LDX_ABSY, LDX, AbsoluteY,       true)                           \
+    /* LDY - Load Y Register */                                             \
+    MEM(INS_LDY_IM,   LDY, Immediate,       true)                           \
+    MEM(INS_LDY_ZP,   LDY, ZeroPage,        true)                           \
+    MEM(INS_LDY_ZPX,  LDY, ZeroPageX,       true)                           \
+    MEM(INS_LDY_ABS,  LDY, Absolute,        true)                           \
+    MEM(INS_LDY_ABSX, LDY, AbsoluteX,       true)                           \
+    /* STA - Store Accumulator (no page-cross shortcut on stores) */        \
+    MEM(INS_STA_ZP,   STA, ZeroPage,        true)                           \
+    MEM(INS_STA_ZPX,  STA, ZeroPageX,       true)                           \
+    MEM(INS_STA_ABS,  STA, Absolute,        true)                           \
+    MEM(INS_STA_ABSX, STA, AbsoluteX,       false)                          \
+    MEM(INS_STA_ABSY, STA, AbsoluteY,       false)                          \
+    MEM(INS_STA_INDX, STA, IndexedIndirect, true)                           \
+    MEM(INS_STA_INDY, STA, IndirectIndexed, false)                          \
+    /* STX / STY - Store X / Y Register */                                  \
+    MEM(INS_STX_ZP,   STX, ZeroPage,        true)                           \
+    MEM(INS_STX_ZPY,  STX, ZeroPageY,       true)                           \
+    MEM(INS_STX_ABS,  STX, Absolute,        true)                           \
+    MEM(INS_STY_ZP,   STY, ZeroPage,        true)                           \
+    MEM(INS_STY_ZPX,  STY, ZeroPageX,       true)                           \
+    MEM(INS_STY_ABS,  STY, Absolute,        true)                           \
+    /* Register Transfers */                                                \
+    IMP(INS_TAX, TAX, Implied)                                              \
+    IMP(INS_TAY, TAY, Implied)                                              \
+    IMP(INS_TXA, TXA, Implied)                                              \
+    IMP(INS_TYA, TYA, Implied)                                              \
+    IMP(INS_TSX, TSX, Implied)                                              \
+    IMP(INS_TXS, TXS, Implied)                                              \
+    /* Stack Operations */                                                  \
+    STK(INS_PHA, PHA)                                                       \
+    STK(INS_PHP, PHP)                                                       \
+    STK(INS_PLA, PLA)                                                       \
+    STK(INS_PLP, PLP)                                                       \
+    /* AND - Logical AND */                                                 \
+    MEM(INS_AND_IM,   AND, Immediate,       true)                           \
+    MEM(INS_AND_ZP,   AND, ZeroPage,        true)                           \
+    MEM(INS_AND_ZPX,  AND, ZeroPageX,       true)                           \
+    MEM(INS_AND_ABS,  AND, Absolute,        true)                           \
+    MEM(INS_AND_ABSX, AND, AbsoluteX,       true)                           \
+    MEM(INS_AND_ABSY, AND, AbsoluteY,       true)                           \
+    MEM(INS_AND_INDX, AND, IndexedIndirect, true)                           \
+    MEM(INS_AND_INDY, AND, IndirectIndexed, true)                           \
+    /* ORA - Logical Inclusive OR */                                        \
+    MEM(INS_ORA_IM,   ORA, Immediate,       true)                           \
+    MEM(INS_ORA_ZP,   ORA, ZeroPage,        true)                           \
+    MEM(INS_ORA_ZPX,  ORA, ZeroPageX,       true)                           \
+    MEM(INS_ORA_ABS,  ORA, Absolute,        true)                           \
+    MEM(INS_ORA_ABSX, ORA, AbsoluteX,       true)                           \
+    MEM(INS_ORA_ABSY, ORA, AbsoluteY,       true)                           \
+    MEM(INS_ORA_INDX, ORA, IndexedIndirect, true)                           \
+    MEM(INS_ORA_INDY, ORA, IndirectIndexed, true)                           \
+    /* EOR - Exclusive OR */                                                \
+    MEM(INS_EOR_IM,   EOR, Immediate,       true)                           \
+    MEM(INS_EOR_ZP,   EOR, ZeroPage,        true)                           \
+    MEM(INS_EOR_ZPX,  EOR, ZeroPageX,       true)                           \
+    MEM(INS_EOR_ABS,  EOR, Absolute,        true)                           \
+    MEM(INS_EOR_ABSX, EOR, AbsoluteX,       true)                           \
+    MEM(INS_EOR_ABSY, EOR, AbsoluteY,       true)                           \
+    MEM(INS_EOR_INDX, EOR, IndexedIndirect, true)                           \
+    MEM(INS_EOR_INDY, EOR, IndirectIndexed, true)                           \
+    /* BIT - Bit Test */                                                    \
+    MEM(INS_BIT_ZP,   BIT, ZeroPage,        true)                           \
+    MEM(INS_BIT_ABS,  BIT, Absolute,        true)                           \
+    /* ADC - Add with Carry */                                              \
+    MEM(INS_ADC_IM,   ADC, Immediate,       true)                           \
+    MEM(INS_ADC_ZP,   ADC, ZeroPage,        true)                           \
+    MEM(INS_ADC_ZPX,  ADC, ZeroPageX,       true)                           \
+    MEM(INS_ADC_ABS,  ADC, Absolute,        true)                           \
+    MEM(INS_ADC_ABSX, ADC, AbsoluteX,       true)                           \
+    MEM(INS_ADC_ABSY, ADC, AbsoluteY,       true)                           \
+    MEM(INS_ADC_INDX, ADC, IndexedIndirect, true)                           \
+    MEM(INS_ADC_INDY, ADC, IndirectIndexed, true)                           \
+    /* SBC - Subtract with Carry */                                         \
+    MEM(INS_SBC_IM,   SBC, Immediate,       true)                           \
+    MEM(INS_SBC_ZP,   SBC, ZeroPage,        true)                           \
+    MEM(INS_SBC_ZPX,  SBC, ZeroPageX,       true)                           \
+    MEM(INS_SBC_ABS,  SBC, Absolute,        true)                           \
+    MEM(INS_SBC_ABSX, SBC, AbsoluteX,       true)                           \
+    MEM(INS_SBC_ABSY, SBC, AbsoluteY,       true)                           \
+    MEM(INS_SBC_INDX, SBC, IndexedIndirect, true)                           \
+    MEM(INS_SBC_INDY, SBC, IndirectIndexed, true)                           \
+    /* CMP - Compare Accumulator */                                         \
+    MEM(INS_CMP_IM,   CMP, Immediate,       true)                           \
+    MEM(INS_CMP_ZP,   CMP, ZeroPage,        true)                           \
+    MEM(INS_CMP_ZPX,  CMP, ZeroPageX,       true)                           \
+    MEM(INS_CMP_ABS,  CMP, Absolute,        true)                           \
+    MEM(INS_CMP_ABSX, CMP, AbsoluteX,       true)                           \
+    MEM(INS_CMP_ABSY, CMP, AbsoluteY,       true)                           \
+    MEM(INS_CMP_INDX, CMP, IndexedIndirect, true)                           \
+    MEM(INS_CMP_INDY, CMP, IndirectIndexed, true)                           \
+    /* CPX / CPY - Compare X / Y Register */                                \
+    MEM(INS_CPX_IM,   CPX, Immediate,       true)                           \
+    MEM(INS_CPX_ZP,   CPX, ZeroPage,        true)                           \
+    MEM(INS_CPX_ABS,  CPX, Absolute,        true)                           \
+    MEM(INS_CPY_IM,   CPY, Immediate,       true)                           \
+    MEM(INS_CPY_ZP,   CPY, ZeroPage,        true)                           \
+    MEM(INS_CPY_ABS,  CPY, Absolute,        true)                           \
+    /* Increment/Decrement */                                               \
+    MEM(INS_INC_ZP,   INC, ZeroPage,        true)                           \
+    MEM(INS_INC_ZPX,  INC, ZeroPageX,       true)                           \
+    MEM(INS_INC_ABS,  INC, Absolute,        true)                           \
+    MEM(INS_INC_ABSX, INC, AbsoluteX,       false)                          \
+    IMP(INS_INX, INX, Implied)                                              \
+    IMP(INS_INY, INY, Implied)                                              \
+    MEM(INS_DEC_ZP,   DEC, ZeroPage,        true)                           \
+    MEM(INS_DEC_ZPX,  DEC, ZeroPageX,       true)                           \
+    MEM(INS_DEC_ABS,  DEC, Absolute,        true)                           \
+    MEM(INS_DEC_ABSX, DEC, AbsoluteX,       false)                          \
+    IMP(INS_DEX, DEX, Implied)                                              \
+    IMP(INS_DEY, DEY, Implied)                                              \
+    /* Shifts and Rotates */                                                \
+    IMP(INS_ASL_ACC,  ASL_ACC, Accumulator)                                 \
+    MEM(INS_ASL_ZP,   ASL_MEM, ZeroPage,    true)                           \
+    MEM(INS_ASL_ZPX,  ASL_MEM, ZeroPageX,   true)                           \
+    MEM(INS_ASL_ABS,  ASL_MEM, Absolute,    true)                           \
+    MEM(INS_ASL_ABSX, ASL_MEM, AbsoluteX,   false)                          \
+    IMP(INS_LSR_ACC,  LSR_ACC, Accumulator)                                 \
+    MEM(INS_LSR_ZP,   LSR_MEM, ZeroPage,    true)                           \
+    MEM(INS_LSR_ZPX,  LSR_MEM, ZeroPageX,   true)                           \
+    MEM(INS_LSR_ABS,  LSR_MEM, Absolute,    true)                           \
+    MEM(INS_LSR_ABSX, LSR_MEM, AbsoluteX,   false)                          \
+    IMP(INS_ROL_ACC,  ROL_ACC, Accumulator)                                 \
+    MEM(INS_ROL_ZP,   ROL_MEM, ZeroPage,    true)                           \
+    MEM(INS_ROL_ZPX,  ROL_MEM, ZeroPageX,   true)                           \
+    MEM(INS_ROL_ABS,  ROL_MEM, Absolute,    true)                           \
+    MEM(INS_ROL_ABSX, ROL_MEM, AbsoluteX,   false)                          \
+    IMP(INS_ROR_ACC,  ROR_ACC, Accumulator)                                 \
+    MEM(INS_ROR_ZP,   ROR_MEM, ZeroPage,    true)                           \
+    MEM(INS_ROR_ZPX,  ROR_MEM, ZeroPageX,   true)                           \
+    MEM(INS_ROR_ABS,  ROR_MEM, Absolute,    true)                           \
+    MEM(INS_ROR_ABSX, ROR_MEM, AbsoluteX,   false)                          \
+    /* Jumps and Calls */                                                   \
+    MEM(INS_JMP_ABS,  JMP, Absolute,        true)                           \
+    MEM(INS_JMP_IND,  JMP, Indirect,        true)                           \
+    MEM(INS_JSR,      JSR, Absolute,        true)                           \
+    STK(INS_RTS, RTS)                                                       \
+    STK(INS_RTI, RTI)                                                       \
+    /* Branches */                                                          \
+    BRANCH(INS_BCC, FLAG_CARRY,    false)                                   \
+    BRANCH(INS_BCS, FLAG_CARRY,    true)                                    \
+    BRANCH(INS_BEQ, FLAG_ZERO,     true)                                    \
+    BRANCH(INS_BMI, FLAG_NEGATIVE, true)                                    \
+    BRANCH(INS_BNE, FLAG_ZERO,     false)                                   \
+    BRANCH(INS_BPL, FLAG_NEGATIVE, false)                                   \
+    BRANCH(INS_BVC, FLAG_OVERFLOW, false)                                   \
+    BRANCH(INS_BVS, FLAG_OVERFLOW, true)                                    \
+    /* Status Flag Changes */                                               \
+    IMP(INS_CLC, CLC, Implied)                                              \
+    IMP(INS_CLD, CLD, Implied)                                              \
+    IMP(INS_CLI, CLI, Implied)                                              \
+    IMP(INS_CLV, CLV, Implied)                                              \
+    IMP(INS_SEC, SEC, Implied)                                              \
+    IMP(INS_SED, SED, Implied)                                              \
+    IMP(INS_SEI, SEI, Implied)                                              \
+    /* System */                                                            \
+    STK(INS_BRK, BRK)                                                       \
+    IMP(INS_NOP, NOP, Implied)
+
+/**
+ * @brief Expands X(opcode) for all 256 opcode values in order
+ *
+ * Used where a dense, ordered list is needed (e.g. the label table of
+ * the computed-goto interpreter).
+ */
+#define M6502_OPCODE_ROW(X, h)                                              \
+    X(0x##h##0) X(0x##h##1) X(0x##h##2) X(0x##h##3)                         \
+    X(0x##h##4) X(0x##h##5) X(0x##h##6) X(0x##h##7)                         \
+    X(0x##h##8) X(0x##h##9) X(0x##h##A) X(0x##h##B)                         \
+    X(0x##h##C) X(0x##h##D) X(0x##h##E) X(0x##h##F)
+
+#define M6502_ALL_OPCODES(X)                                                \
+    M6502_OPCODE_ROW(X, 0) M6502_OPCODE_ROW(X, 1)                           \
+    M6502_OPCODE_ROW(X, 2) M6502_OPCODE_ROW(X, 3)                           \
+    M6502_OPCODE_ROW(X, 4) M6502_OPCODE_ROW(X, 5)                           \
+    M6502_OPCODE_ROW(X, 6) M6502_OPCODE_ROW(X, 7)                           \
+    M6502_OPCODE_ROW(X, 8) M6502_OPCODE_ROW(X, 9)                           \
+    M6502_OPCODE_ROW(X, A) M6502_OPCODE_ROW(X, B)                           \
+    M6502_OPCODE_ROW(X, C) M6502_OPCODE_ROW(X, D)                           \
+    M6502_OPCODE_ROW(X, E) M6502_OPCODE_ROW(X, F)
+
+#endif // M6502_OPCODE_TABLE_H
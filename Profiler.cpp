@@ -0,0 +1,153 @@
+/**
+ * @file Profiler.cpp
+ * @brief Report and folded-stack output for Profiler
+ */
+
+#include "Profiler.h"
+#include "Mnemonics.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+namespace M6502 {
+
+    namespace {
+
+        /// Frame name in folded stacks and reports
+        void WriteAddress(std::ostream& out, Word address) {
+            out << '$' << std::hex << std::uppercase << std::setw(4) << std::setfill('0')
+                << address << std::dec << std::setfill(' ');
+        }
+
+        double Percent(Cycles part, Cycles total) {
+            return total == 0 ? 0.0 : 100.0 * static_cast<double>(part) / static_cast<double>(total);
+        }
+
+    } // namespace
+
+    Profiler::Profiler() : addresses(MEMORY_SIZE) {
+        Clear();
+    }
+
+    void Profiler::Clear() {
+        std::fill(addresses.begin(), addresses.end(), AddressCounters{});
+        opcodes.fill(OpcodeCounters{});
+        penalties = 0;
+
+        totalCycles = 0;
+        instructions = 0;
+        interrupts = 0;
+
+        frames.assign(1, Frame{ 0, 0, 0 });
+        children.clear();
+        current = 0;
+        depth = 0;
+        overflow = 0;
+    }
+
+    // ====================================================================
+    // REPORTS
+    // ====================================================================
+
+    std::vector<Profiler::HotSpot> Profiler::HotSpots(std::size_t count) const {
+        std::vector<HotSpot> spots;
+        for (std::size_t address = 0; address < addresses.size(); address++) {
+            if (addresses[address].executions != 0) {
+                spots.push_back(HotSpot{ static_cast<Address>(address), addresses[address] });
+            }
+        }
+
+        auto hotter = [](const HotSpot& a, const HotSpot& b) {
+            return a.counters.cycles != b.counters.cycles ? a.counters.cycles > b.counters.cycles
+                                                          : a.address < b.address;
+        };
+
+        count = std::min(count, spots.size());
+        std::partial_sort(spots.begin(), spots.begin() + count, spots.end(), hotter);
+        spots.resize(count);
+        return spots;
+    }
+
+    void Profiler::WriteReport(std::ostream& out, std::size_t count) const {
+        out << "Profile: " << instructions << " instructions, " << totalCycles << " cycles, "
+            << interrupts << " interrupts\n\n";
+
+        out << "Hottest addresses\n"
+            << "  address  instruction    executions        cycles      %   page-x    taken\n";
+        for (const HotSpot& spot : HotSpots(count)) {
+            const AddressCounters& counters = spot.counters;
+            out << "  ";
+            WriteAddress(out, spot.address);
+            out << "    " << Mnemonic(counters.opcode) << ' ' << std::left << std::setw(7)
+                << OperandNotation(ModeOf(counters.opcode)) << std::right
+                << std::setw(14) << counters.executions
+                << std::setw(14) << counters.cycles
+                << std::fixed << std::setprecision(1)
+                << std::setw(7) << Percent(counters.cycles, totalCycles)
+                << std::setw(9) << counters.pageCrosses
+                << std::setw(9) << counters.branchesTaken << "\n";
+        }
+
+        std::vector<Byte> order;
+        for (int opcode = 0; opcode < 256; opcode++) {
+            if (opcodes[opcode].executions != 0) {
+                order.push_back(static_cast<Byte>(opcode));
+            }
+        }
+        std::sort(order.begin(), order.end(), [this](Byte a, Byte b) {
+            return opcodes[a].cycles != opcodes[b].cycles ? opcodes[a].cycles > opcodes[b].cycles
+                                                          : a < b;
+        });
+        if (order.size() > count) {
+            order.resize(count);
+        }
+
+        out << "\nHottest opcodes\n"
+            << "  opcode  instruction    executions        cycles      %   page-x    taken\n";
+        for (Byte opcode : order) {
+            const OpcodeCounters& counters = opcodes[opcode];
+            out << "    " << std::hex << std::uppercase << std::setw(2) << std::setfill('0')
+                << static_cast<int>(opcode) << std::dec << std::setfill(' ')
+                << "    " << Mnemonic(opcode) << ' ' << std::left << std::setw(7)
+                << OperandNotation(ModeOf(opcode)) << std::right
+                << std::setw(14) << counters.executions
+                << std::setw(14) << counters.cycles
+                << std::fixed << std::setprecision(1)
+                << std::setw(7) << Percent(counters.cycles, totalCycles)
+                << std::setw(9) << counters.pageCrosses
+                << std::setw(9) << counters.branchesTaken << "\n";
+        }
+    }
+
+    void Profiler::WriteFoldedStacks(std::ostream& out) const {
+        std::vector<std::uint32_t> path;
+
+        for (std::uint32_t frame = 0; frame < frames.size(); frame++) {
+            if (frames[frame].cycles == 0) {
+                continue;
+            }
+
+            path.clear();
+            for (std::uint32_t node = frame; node != 0; node = frames[node].parent) {
+                path.push_back(node);
+            }
+
+            out << "root";
+            for (auto node = path.rbegin(); node != path.rend(); ++node) {
+                out << ';';
+                WriteAddress(out, frames[*node].function);
+            }
+            out << ' ' << frames[frame].cycles << "\n";
+        }
+    }
+
+    bool Profiler::SaveFoldedStacks(const char* path) const {
+        std::ofstream file(path);
+        if (!file) {
+            return false;
+        }
+        WriteFoldedStacks(file);
+        return static_cast<bool>(file);
+    }
+
+} // namespace M6502
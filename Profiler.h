@@ -0,0 +1,232 @@
+/**
+ * @file Profiler.h
+ * @brief Per-opcode and per-address execution profile with call stacks
+ */
+
+#ifndef M6502_PROFILER_H
+#define M6502_PROFILER_H
+
+#include "Constants.h"
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+namespace M6502 {
+
+    /**
+     * @brief Counts executions and cycles per opcode and per PC
+     *
+     * Attach with CPU::SetProfiler(); no rebuild is needed, and a CPU
+     * without a profiler pays nothing beyond its existing interrupt poll.
+     * Besides the flat counters the profiler follows JSR/RTS (and
+     * BRK, interrupts and RTI) to keep a call tree, charging every
+     * instruction's cycles to the subroutine it ran in. That tree is
+     * written as folded stacks ("root;$C000;$C123;$C456 1234" per line),
+     * the input format of flamegraph.pl and speedscope. Every line
+     * starts at `root`, which is also charged with what ran before the
+     * first call.
+     *
+     * The functional core has no cycles; there every instruction counts
+     * as one.
+     */
+    class Profiler {
+    public:
+        /// One PC's counters, padded to 32 bytes
+        struct AddressCounters {
+            std::uint64_t executions;
+            std::uint64_t cycles;
+            std::uint32_t pageCrosses;      ///< Indexed accesses that paid the page-cross cycle
+            std::uint32_t branchesTaken;
+            Byte opcode;                    ///< Last opcode executed here
+        };
+
+        struct OpcodeCounters {
+            std::uint64_t executions;
+            std::uint64_t cycles;
+            std::uint64_t pageCrosses;
+            std::uint64_t branchesTaken;
+        };
+
+        struct HotSpot {
+            Address address;
+            AddressCounters counters;
+        };
+
+        Profiler();
+
+        Profiler(const Profiler&) = delete;
+        Profiler& operator=(const Profiler&) = delete;
+
+        /**
+         * @brief Zero every counter and forget the call tree
+         */
+        void Clear();
+
+        // ================================================================
+        // HOOKS CALLED BY THE CORE
+        // ================================================================
+
+        /// The current instruction paid a page-cross cycle
+        void OnPageCross() { penalties |= PAGE_CROSSED; }
+
+        /// The current instruction is a taken branch
+        void OnBranchTaken() { penalties |= BRANCH_TAKEN; }
+
+        /**
+         * @brief The instruction at `pc` finished, costing `cycles`; PC is now `next`
+         */
+        void OnInstruction(Word pc, Byte opcode, Cycles cycles, Word next) {
+            AddressCounters& address = addresses[pc];
+            OpcodeCounters& operation = opcodes[opcode];
+            address.executions++;
+            address.cycles += cycles;
+            address.opcode = opcode;
+            operation.executions++;
+            operation.cycles += cycles;
+
+            if (penalties != 0) {
+                if (penalties & PAGE_CROSSED) {
+                    address.pageCrosses++;
+                    operation.pageCrosses++;
+                }
+                if (penalties & BRANCH_TAKEN) {
+                    address.branchesTaken++;
+                    operation.branchesTaken++;
+                }
+                penalties = 0;
+            }
+
+            frames[current].cycles += cycles;
+            totalCycles += cycles;
+            instructions++;
+
+            if (opcode == INS_JSR || opcode == INS_BRK) {
+                Call(next);
+            } else if (opcode == INS_RTS || opcode == INS_RTI) {
+                Return();
+            }
+        }
+
+        /**
+         * @brief An interrupt entry costing `cycles` jumped to `handler`
+         */
+        void OnInterrupt(Cycles cycles, Word handler);
+
+        // ================================================================
+        // RESULTS
+        // ================================================================
+
+        const AddressCounters& AtAddress(Address address) const { return addresses[address]; }
+        const OpcodeCounters& ForOpcode(Byte opcode) const { return opcodes[opcode]; }
+
+        /// Cycles (functional core: instructions) seen, interrupt entries included
+        Cycles TotalCycles() const { return totalCycles; }
+        std::uint64_t Instructions() const { return instructions; }
+        std::uint64_t Interrupts() const { return interrupts; }
+
+        /**
+         * @brief The `count` addresses with the most cycles, most first
+         */
+        std::vector<HotSpot> HotSpots(std::size_t count) const;
+
+        /**
+         * @brief Totals, the `count` hottest addresses and the hottest opcodes
+         */
+        void WriteReport(std::ostream& out, std::size_t count = 20) const;
+
+        /**
+         * @brief One "root;caller;callee;... cycles" line per call path
+         */
+        void WriteFoldedStacks(std::ostream& out) const;
+
+        /**
+         * @brief WriteFoldedStacks() to a file
+         * @return false if the file could not be written
+         */
+        bool SaveFoldedStacks(const char* path) const;
+
+    private:
+        static constexpr Byte PAGE_CROSSED = 0x01;
+        static constexpr Byte BRANCH_TAKEN = 0x02;
+
+        /// Deeper calls are charged to the frame at this depth
+        static constexpr std::uint32_t MAX_DEPTH = 256;
+
+        /// A node of the call tree: one subroutine reached by one call path
+        struct Frame {
+            std::uint32_t parent;
+            Word function;      ///< Entry address
+            Cycles cycles;      ///< Spent in this frame itself, not its callees
+        };
+
+        void Call(Word function);
+        void Return();
+
+        std::vector<AddressCounters> addresses;     ///< MEMORY_SIZE entries
+        std::array<OpcodeCounters, 256> opcodes;
+        Byte penalties;
+
+        Cycles totalCycles;
+        std::uint64_t instructions;
+        std::uint64_t interrupts;
+
+        // Call tree; frames[0] is the root (whatever ran before any call)
+        std::vector<Frame> frames;
+        std::unordered_map<std::uint64_t, std::uint32_t> children;
+        std::uint32_t current;
+        std::uint32_t depth;
+        std::uint32_t overflow;     ///< Calls past MAX_DEPTH not yet returned
+    };
+
+    // ====================================================================
+    // CALL TREE
+    // ====================================================================
+    //
+    // Inline like the hooks above, so the core links without Profiler.cpp
+    // (which only holds the reports).
+
+    inline void Profiler::OnInterrupt(Cycles cycles, Word handler) {
+        // The entry sequence is charged to the handler it starts
+        Call(handler);
+        frames[current].cycles += cycles;
+        totalCycles += cycles;
+        interrupts++;
+    }
+
+    inline void Profiler::Call(Word function) {
+        if (depth >= MAX_DEPTH) {
+            overflow++;
+            return;
+        }
+
+        // Child frames are keyed by (parent frame, entry address)
+        const std::uint64_t key = (static_cast<std::uint64_t>(current) << 16) | function;
+        auto found = children.find(key);
+        if (found == children.end()) {
+            frames.push_back(Frame{ current, function, 0 });
+            found = children.emplace(key, static_cast<std::uint32_t>(frames.size() - 1)).first;
+        }
+
+        current = found->second;
+        depth++;
+    }
+
+    inline void Profiler::Return() {
+        if (overflow > 0) {
+            overflow--;
+            return;
+        }
+
+        // An RTS with no matching JSR (an RTS used as a jump, or a return
+        // from code entered before the profiler was attached) stays at the root
+        if (current != 0) {
+            current = frames[current].parent;
+            depth--;
+        }
+    }
+
+} // namespace M6502
+
+#endif // M6502_PROFILER_H
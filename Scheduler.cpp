@@ -0,0 +1,130 @@
+/**
+ * @file Scheduler.cpp
+ * @brief Heap operations for Scheduler
+ */
+
+#include "Scheduler.h"
+
+namespace M6502 {
+
+    Scheduler::Scheduler(std::size_t capacity)
+        : capacity(capacity), endBatch(nullptr), runningCPU(nullptr), batchEnd(0) {
+        // The only allocation: the heap never grows past this
+        heap.reserve(capacity);
+    }
+
+    Scheduler::~Scheduler() {
+        // Leave no event pointing into a dead heap
+        for (Event* event : heap) {
+            event->index = Event::NOT_SCHEDULED;
+        }
+    }
+
+    // ====================================================================
+    // QUEUE
+    // ====================================================================
+
+    bool Scheduler::Schedule(Event& event, Cycles deadline) {
+        if (event.Scheduled()) {
+            // Move in place: up if earlier, down if later
+            const Cycles previous = event.deadline;
+            event.deadline = deadline;
+            if (deadline < previous) {
+                SiftUp(event.index);
+            } else {
+                SiftDown(event.index);
+            }
+        } else {
+            if (heap.size() == capacity) {
+                return false;
+            }
+            event.deadline = deadline;
+            heap.push_back(&event);
+            event.index = heap.size() - 1;
+            SiftUp(event.index);
+        }
+
+        // A batch running past the new deadline must come back for it
+        if (runningCPU != nullptr && deadline < batchEnd) {
+            endBatch(runningCPU);
+        }
+        return true;
+    }
+
+    void Scheduler::Cancel(Event& event) {
+        if (event.Scheduled()) {
+            RemoveAt(event.index);
+        }
+    }
+
+    void Scheduler::RunDue(Cycles cycle) {
+        while (!heap.empty() && heap[0]->deadline <= cycle) {
+            Event* event = heap[0];
+            RemoveAt(0);
+
+            // Off the queue first, so the callback can reschedule it
+            event->callback(event->context, event->deadline);
+        }
+    }
+
+    // ====================================================================
+    // HEAP
+    // ====================================================================
+
+    void Scheduler::Place(Event* event, std::size_t index) {
+        heap[index] = event;
+        event->index = index;
+    }
+
+    void Scheduler::SiftUp(std::size_t index) {
+        Event* event = heap[index];
+        while (index > 0) {
+            const std::size_t parent = (index - 1) / 2;
+            if (heap[parent]->deadline <= event->deadline) {
+                break;
+            }
+            Place(heap[parent], index);
+            index = parent;
+        }
+        Place(event, index);
+    }
+
+    void Scheduler::SiftDown(std::size_t index) {
+        Event* event = heap[index];
+        const std::size_t size = heap.size();
+        while (true) {
+            std::size_t child = 2 * index + 1;
+            if (child >= size) {
+                break;
+            }
+            if (child + 1 < size && heap[child + 1]->deadline < heap[child]->deadline) {
+                child++;
+            }
+            if (event->deadline <= heap[child]->deadline) {
+                break;
+            }
+            Place(heap[child], index);
+            index = child;
+        }
+        Place(event, index);
+    }
+
+    void Scheduler::RemoveAt(std::size_t index) {
+        Event* removed = heap[index];
+        Event* last = heap.back();
+        heap.pop_back();
+        removed->index = Event::NOT_SCHEDULED;
+
+        if (last != removed) {
+            // The last leaf fills the hole and moves whichever way it must
+            heap[index] = last;
+            last->index = index;
+            if (index > 0 && last->deadline < heap[(index - 1) / 2]->deadline) {
+                SiftUp(index);
+            } else {
+                SiftDown(index);
+            }
+        }
+    }
+
+} // namespace M6502
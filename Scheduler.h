@@ -0,0 +1,227 @@
+/**
+ * @file Scheduler.h
+ * @brief Cycle-based event queue the run loop executes straight up to
+ */
+
+#ifndef M6502_SCHEDULER_H
+#define M6502_SCHEDULER_H
+
+#include "Constants.h"
+#include "IdleLoop.h"
+#include <cstddef>
+#include <vector>
+
+namespace M6502 {
+
+    class Scheduler;
+
+    /**
+     * @brief A callback due at an absolute cycle
+     *
+     * Owned by the caller, typically as a member of the device it drives,
+     * and linked into a Scheduler without copying: scheduling, moving and
+     * cancelling never allocate. An event is in at most one scheduler at
+     * a time, and must be cancelled (or fired) before it is destroyed.
+     */
+    class Event {
+    public:
+        /**
+         * @brief Called once the CPU reaches `deadline`
+         *
+         * The event is already off the queue, so the callback may
+         * schedule it again, for example at `deadline` plus a period.
+         */
+        using Callback = void (*)(void* context, Cycles deadline);
+
+        Event(Callback callback, void* context) : callback(callback), context(context) {}
+
+        Event(const Event&) = delete;
+        Event& operator=(const Event&) = delete;
+
+        bool Scheduled() const { return index != NOT_SCHEDULED; }
+
+        /// Only meaningful while Scheduled()
+        Cycles Deadline() const { return deadline; }
+
+    private:
+        friend class Scheduler;
+
+        static constexpr std::size_t NOT_SCHEDULED = ~std::size_t{0};
+
+        Callback callback;
+        void* context;
+        Cycles deadline = 0;
+        std::size_t index = NOT_SCHEDULED;  ///< Position in the scheduler's heap
+    };
+
+    /**
+     * @brief Min-heap of pending events ordered by deadline
+     *
+     * RunFor() replaces polling every device on every instruction: the
+     * CPU runs one batch straight to the earliest deadline, the events
+     * due by then fire, and the next batch runs to the new earliest one.
+     * With nothing due soon the CPU runs the whole budget in one batch.
+     *
+     * The heap is a fixed array of event pointers sized at construction.
+     * Each event remembers its own position, so Schedule() and Cancel()
+     * are O(log n) with no search and no allocation.
+     *
+     * Events fire at the first instruction boundary at or after their
+     * deadline, the same boundary a loop checking after every Execute()
+     * would use; the callback receives the deadline, not the boundary.
+     * Events with equal deadlines fire in an unspecified but reproducible
+     * order.
+     */
+    class Scheduler {
+    public:
+        static constexpr Cycles NO_DEADLINE = ~Cycles{0};
+
+        /// With idle skipping on, how often RunFor() looks for an idle loop
+        static constexpr Cycles IDLE_CHECK_INTERVAL = 256;
+
+        explicit Scheduler(std::size_t capacity);
+        ~Scheduler();
+
+        Scheduler(const Scheduler&) = delete;
+        Scheduler& operator=(const Scheduler&) = delete;
+
+        /**
+         * @brief Queue `event` at `deadline`, or move it there if already queued
+         *
+         * Called from inside a RunFor() batch (by a device register write,
+         * say) with a deadline before the batch's end, it makes the batch
+         * return after the current instruction so the event is not late.
+         *
+         * @return false if the queue is full and `event` was not queued
+         */
+        bool Schedule(Event& event, Cycles deadline);
+
+        /**
+         * @brief Remove `event` from the queue; nothing happens if it is not queued
+         */
+        void Cancel(Event& event);
+
+        /// Earliest pending deadline, NO_DEADLINE if nothing is queued
+        Cycles NextDeadline() const { return heap.empty() ? NO_DEADLINE : heap[0]->deadline; }
+
+        std::size_t Pending() const { return heap.size(); }
+        std::size_t Capacity() const { return capacity; }
+
+        /**
+         * @brief Fire every event due at or before `cycle`, earliest first
+         *
+         * Events the callbacks schedule at or before `cycle` fire too.
+         */
+        void RunDue(Cycles cycle);
+
+        /**
+         * @brief Run `cpu` for `budget` cycles, firing events as they fall due
+         *
+         * Each batch is a plain cpu.RunFor() up to the next deadline. The
+         * bus should stamp device accesses with `cpu`'s clock
+         * (MemoryBus::SetClock()) so devices know the current cycle when
+         * they schedule. As with RunFor(), the last instruction may end
+         * past the budget.
+         *
+         * @return Cycles (functional core: instructions) executed
+         */
+        template <typename CPUType, typename Bus>
+        Cycles RunFor(CPUType& cpu, Bus& bus, Cycles budget);
+
+        /**
+         * @brief Let RunFor() fast-forward through idle loops (off by default)
+         *
+         * Every IDLE_CHECK_INTERVAL cycles, RunFor() runs one pass of the
+         * loop at PC through IdleLoopPeriod(). If the pass came back to
+         * the same PC and registers without writing memory, moving SP or
+         * reading an I/O page, every pass until the next deadline would
+         * do exactly the same, so the clock jumps ahead by whole passes
+         * and the rest of the batch runs normally. The CPU ends each
+         * batch on the same instruction boundary, with the same state and
+         * cycle count, as without skipping; only the skipped instructions
+         * go unexecuted.
+         *
+         * What ends such a loop is an event (a write to the RAM it polls,
+         * an interrupt) or the host between RunFor() calls, and neither
+         * can happen mid-batch, or a Device (Device.h) reaching its
+         * NextDeadline(), so no skip goes past the bus's
+         * NextDeviceDeadline() either. A loop polling a device register
+         * reads an I/O page and is never skipped, as the device may
+         * change what it returns on its own. Nothing is skipped while
+         * cpu.Observed().
+         */
+        void SetIdleSkip(bool enabled) { idleSkip = enabled; }
+
+        /// Cycles (functional core: instructions) fast-forwarded so far
+        Cycles IdleCyclesSkipped() const { return idleCyclesSkipped; }
+
+    private:
+        // Heap order: earliest deadline at index 0
+        void SiftUp(std::size_t index);
+        void SiftDown(std::size_t index);
+        void Place(Event* event, std::size_t index);
+        void RemoveAt(std::size_t index);
+
+        std::vector<Event*> heap;
+        std::size_t capacity;
+
+        // Set while RunFor() has a batch running, for Schedule()
+        void (*endBatch)(void* cpu);
+        void* runningCPU;
+        Cycles batchEnd;
+
+        bool idleSkip = false;
+        Cycles idleCyclesSkipped = 0;
+    };
+
+    // ========================================================================
+    // RUN LOOP
+    // ========================================================================
+
+    template <typename CPUType, typename Bus>
+    Cycles Scheduler::RunFor(CPUType& cpu, Bus& bus, Cycles budget) {
+        const Cycles start = cpu.TotalCycles;
+        const Cycles end = start + budget;
+
+        // Anything already due fires before the first instruction
+        RunDue(cpu.TotalCycles);
+
+        while (cpu.TotalCycles < end) {
+            // RunDue() left every deadline in the future
+            const Cycles next = NextDeadline();
+            batchEnd = next < end ? next : end;
+
+            endBatch = [](void* running) { static_cast<CPUType*>(running)->EndBatch(); };
+            runningCPU = &cpu;
+            Cycles chunkEnd = batchEnd;
+            if (idleSkip && !cpu.Observed()) {
+                // One real pass of the loop, then skip whole passes up to
+                // the first deadline, ours or a device's; the partial pass
+                // left and anything past a device deadline run below
+                const Cycles device = bus.NextDeviceDeadline();
+                const Cycles skipEnd = device < batchEnd ? device : batchEnd;
+                const Cycles period = IdleLoopPeriod(cpu, bus, skipEnd);
+                if (period != 0 && cpu.TotalCycles < skipEnd) {
+                    const Cycles skipped = (skipEnd - cpu.TotalCycles) / period * period;
+                    cpu.TotalCycles += skipped;
+                    idleCyclesSkipped += skipped;
+                }
+                // Come back now and then to catch a loop entered mid-batch
+                if (cpu.TotalCycles < batchEnd && batchEnd - cpu.TotalCycles > IDLE_CHECK_INTERVAL) {
+                    chunkEnd = cpu.TotalCycles + IDLE_CHECK_INTERVAL;
+                }
+            }
+            if (cpu.TotalCycles < chunkEnd) {
+                cpu.RunFor(chunkEnd - cpu.TotalCycles, bus);
+            }
+            runningCPU = nullptr;
+
+            RunDue(cpu.TotalCycles);
+        }
+
+        return cpu.TotalCycles - start;
+    }
+
+} // namespace M6502
+
+#endif // M6502_SCHEDULER_H
@@ -0,0 +1,247 @@
+/**
+ * @file Snapshot.cpp
+ * @brief Snapshot save/load and the memory-mapped restore path
+ */
+
+#include "Snapshot.h"
+#include <cstdio>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #define M6502_HAS_MMAP 1
+#else
+    #define M6502_HAS_MMAP 0
+#endif
+
+namespace M6502 {
+
+    namespace {
+
+        const Byte SNAPSHOT_MAGIC[8] = { 'M', '6', '5', '0', '2', 'S', 'N', 'P' };
+
+        /**
+         * @brief Check magic and version, leaving the reader at the CPU state
+         */
+        bool ReadHeader(SnapshotReader& reader, Byte& flags) {
+            const Byte* magic = reader.ReadBytes(sizeof(SNAPSHOT_MAGIC));
+            if (magic == nullptr || std::memcmp(magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+                return false;
+            }
+
+            Word version;
+            Byte reserved;
+            if (!reader.ReadWord(version) || !reader.ReadByte(flags) || !reader.ReadByte(reserved)) {
+                return false;
+            }
+
+            // Only one version so far; later versions must keep reading this one
+            return version == SNAPSHOT_VERSION;
+        }
+
+    } // namespace
+
+    // ====================================================================
+    // BUFFERS
+    // ====================================================================
+
+    std::vector<Byte> SaveSnapshot(const CPU& cpu, const Memory& memory, bool compress) {
+        std::vector<Byte> buffer;
+        buffer.reserve(compress ? 0x1000 : SNAPSHOT_FULL_SIZE);
+
+        SnapshotWriter writer(buffer);
+        writer.WriteBytes(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+        writer.WriteWord(SNAPSHOT_VERSION);
+        writer.WriteByte(compress ? SNAPSHOT_COMPRESSED : 0);
+        writer.WriteByte(0);
+
+        cpu.SaveState(writer);
+
+        if (!compress) {
+            // Page-aligned so the image can be mapped in place
+            writer.PadTo(SNAPSHOT_MEMORY_OFFSET);
+        }
+        memory.SaveState(writer, compress);
+
+        return buffer;
+    }
+
+    bool LoadSnapshot(CPU& cpu, Memory& memory, const Byte* data, std::size_t size) {
+        SnapshotReader reader(data, size);
+
+        Byte flags;
+        if (!ReadHeader(reader, flags) || !cpu.LoadState(reader)) {
+            return false;
+        }
+
+        const bool compressed = (flags & SNAPSHOT_COMPRESSED) != 0;
+        if (!compressed && !reader.SeekTo(SNAPSHOT_MEMORY_OFFSET)) {
+            return false;
+        }
+        return memory.LoadState(reader, compressed);
+    }
+
+    // ====================================================================
+    // FILES
+    // ====================================================================
+
+    bool SaveSnapshotFile(const std::string& path, const CPU& cpu, const Memory& memory,
+                          bool compress) {
+        std::vector<Byte> buffer = SaveSnapshot(cpu, memory, compress);
+
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        if (file == nullptr) {
+            return false;
+        }
+        bool written = std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+        return std::fclose(file) == 0 && written;
+    }
+
+    bool LoadSnapshotFile(const std::string& path, CPU& cpu, Memory& memory) {
+#if M6502_HAS_MMAP
+        // Map instead of read: the kernel hands over page-cache pages
+        // and the only copy is the one into Memory
+        int file = open(path.c_str(), O_RDONLY);
+        if (file < 0) {
+            return false;
+        }
+
+        struct stat info;
+        if (fstat(file, &info) != 0 || info.st_size <= 0) {
+            close(file);
+            return false;
+        }
+
+        std::size_t size = static_cast<std::size_t>(info.st_size);
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+        close(file);
+        if (mapping == MAP_FAILED) {
+            return false;
+        }
+
+        bool loaded = LoadSnapshot(cpu, memory, static_cast<const Byte*>(mapping), size);
+        munmap(mapping, size);
+        return loaded;
+#else
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        if (file == nullptr) {
+            return false;
+        }
+
+        std::vector<Byte> buffer;
+        Byte chunk[4096];
+        std::size_t count;
+        while ((count = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+            buffer.insert(buffer.end(), chunk, chunk + count);
+        }
+        std::fclose(file);
+
+        return LoadSnapshot(cpu, memory, buffer.data(), buffer.size());
+#endif
+    }
+
+    // ====================================================================
+    // MAPPED SNAPSHOTS
+    // ====================================================================
+
+    MappedSnapshot::MappedSnapshot() : file(-1), fileSize(0), mapping(nullptr) {}
+
+    MappedSnapshot::~MappedSnapshot() {
+        Close();
+    }
+
+    bool MappedSnapshot::Open(const std::string& path) {
+        Close();
+
+#if M6502_HAS_MMAP
+        file = open(path.c_str(), O_RDONLY);
+        if (file < 0) {
+            return false;
+        }
+
+        struct stat info;
+        if (fstat(file, &info) != 0 || static_cast<std::size_t>(info.st_size) < SNAPSHOT_FULL_SIZE) {
+            Close();
+            return false;
+        }
+        fileSize = static_cast<std::size_t>(info.st_size);
+
+        // Only uncompressed snapshots can be used in place
+        Byte header[12];
+        Byte flags;
+        SnapshotReader reader(header, sizeof(header));
+        if (pread(file, header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+            !ReadHeader(reader, flags) || (flags & SNAPSHOT_COMPRESSED) != 0) {
+            Close();
+            return false;
+        }
+        return true;
+#else
+        (void)path;
+        return false;
+#endif
+    }
+
+    void MappedSnapshot::Close() {
+        Unmap();
+#if M6502_HAS_MMAP
+        if (file >= 0) {
+            close(file);
+        }
+#endif
+        file = -1;
+        fileSize = 0;
+    }
+
+    bool MappedSnapshot::Restore(BasicCPU<MemoryBus>& cpu, MemoryBus& bus) {
+#if M6502_HAS_MMAP
+        if (file < 0) {
+            return false;
+        }
+
+        // A fresh private mapping drops every page the last run dirtied.
+        // The bus keeps pointing into the old one until the new one has
+        // checked out, so a failure leaves the machine as it was.
+        void* fresh = mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+        if (fresh == MAP_FAILED) {
+            return false;
+        }
+
+        Byte* base = static_cast<Byte*>(fresh);
+        SnapshotReader reader(base, fileSize);
+        SnapshotReader probe = reader;
+        Byte flags;
+        if (!ReadHeader(probe, flags) || (flags & SNAPSHOT_COMPRESSED) != 0 ||
+            probe.ReadBytes(SNAPSHOT_CPU_STATE_SIZE) == nullptr) {
+            munmap(fresh, fileSize);
+            return false;
+        }
+
+        // The probe read the same bytes, so neither of these can fail now
+        ReadHeader(reader, flags);
+        cpu.LoadState(reader);
+        bus.MapRAM(0x00, MemoryBus::PAGE_COUNT, base + SNAPSHOT_MEMORY_OFFSET);
+
+        Unmap();
+        mapping = fresh;
+        return true;
+#else
+        (void)cpu;
+        (void)bus;
+        return false;
+#endif
+    }
+
+    void MappedSnapshot::Unmap() {
+#if M6502_HAS_MMAP
+        if (mapping != nullptr) {
+            munmap(mapping, fileSize);
+        }
+#endif
+        mapping = nullptr;
+    }
+
+} // namespace M6502
@@ -0,0 +1,210 @@
+/**
+ * @file Snapshot.h
+ * @brief Versioned binary snapshots of CPU and memory state
+ *
+ * Layout (all multi-byte fields little-endian):
+ *
+ *   offset  size  field
+ *   0       8     magic "M6502SNP"
+ *   8       2     format version (SNAPSHOT_VERSION)
+ *   10      1     flags (SNAPSHOT_COMPRESSED)
+ *   11      1     reserved, 0
+ *   12      17    CPU: A, X, Y, SP, P, PC, TotalCycles, pending
+ *                 interrupts, NMI line
+ *   ...           memory image
+ *
+ * An uncompressed image is 64 KiB stored at SNAPSHOT_MEMORY_OFFSET, so
+ * a snapshot file can be mapped and its memory used in place. A
+ * compressed image follows the CPU state directly, as a sequence of
+ * (zero run, literal run, literal bytes) records with 16-bit counts.
+ */
+
+#ifndef M6502_SNAPSHOT_H
+#define M6502_SNAPSHOT_H
+
+#include "Constants.h"
+#include "CPU.h"
+#include "Memory.h"
+#include "MemoryBus.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace M6502 {
+
+    constexpr Word SNAPSHOT_VERSION = 1;
+
+    /// Bytes written by BasicCPU::SaveState()
+    constexpr std::size_t SNAPSHOT_CPU_STATE_SIZE = 17;
+
+    /// Uncompressed memory starts on a page boundary for mapping
+    constexpr std::size_t SNAPSHOT_MEMORY_OFFSET = 0x1000;
+
+    /// Size of an uncompressed snapshot
+    constexpr std::size_t SNAPSHOT_FULL_SIZE = SNAPSHOT_MEMORY_OFFSET + MEMORY_SIZE;
+
+    enum SnapshotFlags : Byte {
+        SNAPSHOT_COMPRESSED = 0x01  ///< Memory image is zero-run compressed
+    };
+
+    /**
+     * @brief Appends little-endian fields to a byte buffer
+     */
+    class SnapshotWriter {
+    public:
+        explicit SnapshotWriter(std::vector<Byte>& buffer) : buffer(buffer) {}
+
+        void WriteByte(Byte value) { buffer.push_back(value); }
+
+        void WriteWord(Word value) {
+            WriteByte(value & 0xFF);
+            WriteByte((value >> 8) & 0xFF);
+        }
+
+        void WriteQuad(std::uint64_t value) {
+            for (int i = 0; i < 8; i++) {
+                WriteByte(static_cast<Byte>(value >> (8 * i)));
+            }
+        }
+
+        void WriteBytes(const Byte* data, std::size_t count) {
+            buffer.insert(buffer.end(), data, data + count);
+        }
+
+        /// Zero-fill up to an absolute offset in the buffer
+        void PadTo(std::size_t offset) {
+            if (buffer.size() < offset) {
+                buffer.resize(offset, 0);
+            }
+        }
+
+    private:
+        std::vector<Byte>& buffer;
+    };
+
+    /**
+     * @brief Reads little-endian fields, failing (not throwing) on truncation
+     */
+    class SnapshotReader {
+    public:
+        SnapshotReader(const Byte* data, std::size_t size)
+            : data(data), size(size), offset(0) {}
+
+        bool ReadByte(Byte& value) {
+            if (offset + 1 > size) {
+                return false;
+            }
+            value = data[offset++];
+            return true;
+        }
+
+        bool ReadWord(Word& value) {
+            Byte low, high;
+            if (!ReadByte(low) || !ReadByte(high)) {
+                return false;
+            }
+            value = (static_cast<Word>(high) << 8) | low;
+            return true;
+        }
+
+        bool ReadQuad(std::uint64_t& value) {
+            if (offset + 8 > size) {
+                return false;
+            }
+            value = 0;
+            for (int i = 0; i < 8; i++) {
+                value |= static_cast<std::uint64_t>(data[offset++]) << (8 * i);
+            }
+            return true;
+        }
+
+        /// Pointer to `count` bytes at the current offset, or nullptr
+        const Byte* ReadBytes(std::size_t count) {
+            if (offset + count > size) {
+                return nullptr;
+            }
+            const Byte* bytes = data + offset;
+            offset += count;
+            return bytes;
+        }
+
+        bool SeekTo(std::size_t position) {
+            if (position > size) {
+                return false;
+            }
+            offset = position;
+            return true;
+        }
+
+    private:
+        const Byte* data;
+        std::size_t size;
+        std::size_t offset;
+    };
+
+    // ====================================================================
+    // WHOLE-MACHINE SNAPSHOTS
+    // ====================================================================
+
+    /**
+     * @brief Serialize `cpu` and `memory`
+     * @param compress Store the memory image zero-run compressed
+     */
+    std::vector<Byte> SaveSnapshot(const CPU& cpu, const Memory& memory, bool compress = false);
+
+    /**
+     * @brief Restore `cpu` and `memory` from a snapshot buffer
+     * @return false if the data is not a valid snapshot (state is then unspecified)
+     */
+    bool LoadSnapshot(CPU& cpu, Memory& memory, const Byte* data, std::size_t size);
+
+    bool SaveSnapshotFile(const std::string& path, const CPU& cpu, const Memory& memory,
+                          bool compress = false);
+
+    /**
+     * @brief Restore from a file, reading it through a memory mapping
+     */
+    bool LoadSnapshotFile(const std::string& path, CPU& cpu, Memory& memory);
+
+    /**
+     * @brief Uncompressed snapshot file mapped copy-on-write for MemoryBus
+     *
+     * Restore() maps a fresh private view of the file and points every
+     * page of the bus at it with MapRAM(), so restoring costs a mapping
+     * rather than a 64 KiB copy. Guest writes touch private copies of
+     * the pages they hit and never reach the file. A MemoryBus restored
+     * this way must not outlive the MappedSnapshot (or its next Restore).
+     *
+     * Needs POSIX mmap; elsewhere Open() fails.
+     */
+    class MappedSnapshot {
+    public:
+        MappedSnapshot();
+        ~MappedSnapshot();
+
+        MappedSnapshot(const MappedSnapshot&) = delete;
+        MappedSnapshot& operator=(const MappedSnapshot&) = delete;
+
+        /**
+         * @brief Open an uncompressed snapshot file
+         */
+        bool Open(const std::string& path);
+
+        void Close();
+
+        /**
+         * @brief Reset `cpu` and `bus` to the snapshot, discarding changes
+         */
+        bool Restore(BasicCPU<MemoryBus>& cpu, MemoryBus& bus);
+
+    private:
+        void Unmap();
+
+        int file;
+        std::size_t fileSize;
+        void* mapping;
+    };
+
+} // namespace M6502
+
+#endif // M6502_SNAPSHOT_H
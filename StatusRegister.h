@@ -0,0 +1,98 @@
+/**
+ * @file StatusRegister.h
+ * @brief Processor status register with lazily evaluated N and Z flags
+ */
+
+#ifndef M6502_STATUS_REGISTER_H
+#define M6502_STATUS_REGISTER_H
+
+#include "Constants.h"
+
+namespace M6502 {
+
+    /**
+     * @brief The P register, stored unpacked
+     *
+     * Almost every instruction updates N and Z, but few of those values
+     * are ever looked at before the next instruction replaces them. So
+     * instead of a read-modify-write of a packed byte, N and Z keep the
+     * last byte that defined them and are only derived when read; C and
+     * V are plain booleans. The packed value is built only when P is
+     * observed as a byte (PHP, BRK, the host reading cpu.P).
+     *
+     * Converts to and from Byte, so code that reads or assigns cpu.P as
+     * a byte keeps working and sees exactly the same bits as before.
+     */
+    class StatusRegister {
+    public:
+        StatusRegister() { *this = 0; }
+
+        /**
+         * @brief The packed status byte
+         */
+        operator Byte() const {
+            return other
+                 | (carry ? FLAG_CARRY : 0)
+                 | (zeroSource == 0 ? FLAG_ZERO : 0)
+                 | (overflow ? FLAG_OVERFLOW : 0)
+                 | (negativeSource & FLAG_NEGATIVE);
+        }
+
+        StatusRegister& operator=(Byte value) {
+            carry = (value & FLAG_CARRY) != 0;
+            zeroSource = (value & FLAG_ZERO) ? 0 : 1;
+            overflow = (value & FLAG_OVERFLOW) != 0;
+            negativeSource = value & FLAG_NEGATIVE;
+            other = value & (FLAG_INTERRUPT | FLAG_DECIMAL | FLAG_BREAK | FLAG_UNUSED);
+            return *this;
+        }
+
+        StatusRegister& operator|=(Byte mask) { return *this = static_cast<Byte>(*this) | mask; }
+        StatusRegister& operator&=(Byte mask) { return *this = static_cast<Byte>(*this) & mask; }
+
+        bool Get(StatusFlags flag) const {
+            // `flag` is a constant at every call site, so this folds away
+            switch (flag) {
+                case FLAG_CARRY:    return carry;
+                case FLAG_ZERO:     return zeroSource == 0;
+                case FLAG_OVERFLOW: return overflow;
+                case FLAG_NEGATIVE: return (negativeSource & 0x80) != 0;
+                default:            return (other & flag) != 0;
+            }
+        }
+
+        void Set(StatusFlags flag, bool condition) {
+            switch (flag) {
+                case FLAG_CARRY:    carry = condition; break;
+                case FLAG_ZERO:     zeroSource = condition ? 0 : 1; break;
+                case FLAG_OVERFLOW: overflow = condition; break;
+                case FLAG_NEGATIVE: negativeSource = condition ? 0x80 : 0; break;
+                default:
+                    if (condition) {
+                        other |= flag;
+                    } else {
+                        other &= ~flag;
+                    }
+                    break;
+            }
+        }
+
+        /**
+         * @brief N and Z from a result byte: two stores, no flag arithmetic
+         */
+        void SetZeroAndNegative(Byte value) {
+            zeroSource = value;
+            negativeSource = value;
+        }
+
+    private:
+        Byte zeroSource;        ///< Z is set when this is zero
+        Byte negativeSource;    ///< N is bit 7 of this
+        bool carry;
+        bool overflow;
+        Byte other;             ///< I, D, B and the unused bit, in place
+    };
+
+} // namespace M6502
+
+#endif // M6502_STATUS_REGISTER_H
@@ -0,0 +1,269 @@
+/**
+ * @file Timeline.cpp
+ * @brief Implementation of BasicTimeline
+ */
+
+#include "Timeline.h"
+#include <algorithm>
+
+namespace M6502 {
+
+    namespace {
+        // The longest instruction or interrupt entry takes 7 cycles, so
+        // instruction boundaries are never further apart than this
+        constexpr Cycles LONGEST_STEP = 8;
+    }
+
+    template <typename Bus, typename Timing>
+    BasicTimeline<Bus, Timing>::BasicTimeline(CPUType& cpu, Bus& memory, const TimelineOptions& options)
+        : cpu(cpu), memory(memory), options(options), interval(options.minInterval),
+          nextCheckpoint(0), applied(0), ioReplayed(0), frontier(0), replaying(false) {
+        memory.SetIORecorder(this);
+        Start();
+    }
+
+    template <typename Bus, typename Timing>
+    BasicTimeline<Bus, Timing>::~BasicTimeline() {
+        memory.SetIORecorder(nullptr);
+    }
+
+    template <typename Bus, typename Timing>
+    void BasicTimeline<Bus, Timing>::Start() {
+        chain.Clear();
+        marks.clear();
+        inputs.clear();
+        applied = 0;
+        ioReads.clear();
+        ioReplayed = 0;
+        frontier = cpu.TotalCycles;
+        interval = options.minInterval;
+        TakeCheckpoint();
+    }
+
+    template <typename Bus, typename Timing>
+    Cycles BasicTimeline<Bus, Timing>::RunFor(Cycles budget) {
+        const Cycles start = cpu.TotalCycles;
+        const Cycles end = start + budget;
+
+        while (cpu.TotalCycles < end) {
+            ApplyDue();
+            if (cpu.TotalCycles >= nextCheckpoint) {
+                TakeCheckpoint();
+            }
+
+            // Run straight to whichever comes first: the end, the next
+            // checkpoint or the next logged input
+            Cycles target = std::min(end, nextCheckpoint);
+            if (applied < inputs.size()) {
+                target = std::min(target, inputs[applied].position);
+            }
+            if (RunBatch(target) == 0) {
+                break;  // A debugger stopped the batch
+            }
+        }
+        ApplyDue();
+
+        return cpu.TotalCycles - start;
+    }
+
+    // ====================================================================
+    // LOGGED INPUTS
+    // ====================================================================
+
+    template <typename Bus, typename Timing>
+    void BasicTimeline<Bus, Timing>::SetIRQ(bool asserted) {
+        Record({ cpu.TotalCycles, InputKind::IRQ, static_cast<Byte>(asserted ? 1 : 0), 0 });
+    }
+
+    template <typename Bus, typename Timing>
+    void BasicTimeline<Bus, Timing>::SetNMI(bool asserted) {
+        Record({ cpu.TotalCycles, InputKind::NMI, static_cast<Byte>(asserted ? 1 : 0), 0 });
+    }
+
+    template <typename Bus, typename Timing>
+    void BasicTimeline<Bus, Timing>::Poke(Address address, Byte value) {
+        Record({ cpu.TotalCycles, InputKind::Poke, value, address });
+    }
+
+    template <typename Bus, typename Timing>
+    void BasicTimeline<Bus, Timing>::Record(const Input& input) {
+        // A new input changes what happens next; the logged future is
+        // void, device reads included. The devices stay where the old
+        // future left them.
+        inputs.resize(applied);
+        inputs.push_back(input);
+        ioReads.resize(ioReplayed);
+        frontier = cpu.TotalCycles;
+        ApplyDue();
+    }
+
+    template <typename Bus, typename Timing>
+    void BasicTimeline<Bus, Timing>::Apply(const Input& input) {
+        switch (input.kind) {
+            case InputKind::IRQ:  cpu.SetIRQ(input.value != 0); break;
+            case InputKind::NMI:  cpu.SetNMI(input.value != 0); break;
+            case InputKind::Poke: memory[input.address] = input.value; break;
+        }
+    }
+
+    // ====================================================================
+    // DEVICE READS
+    // ====================================================================
+
+    template <typename Bus, typename Timing>
+    void BasicTimeline<Bus, Timing>::OnIORead(Address address, Cycles cycle, Byte value) {
+        ioReads.push_back({ cycle, address, value });
+        ioReplayed = ioReads.size();
+    }
+
+    template <typename Bus, typename Timing>
+    Byte BasicTimeline<Bus, Timing>::ReplayIORead(Address /* address */, Cycles /* cycle */) {
+        // Replay is deterministic up to the frontier, so the reads come
+        // back in the order they were logged. Running out means the
+        // machine was changed behind the timeline's back: open bus.
+        return ioReplayed < ioReads.size() ? ioReads[ioReplayed++].value : 0xFF;
+    }
+
+    template <typename Bus, typename Timing>
+    Cycles BasicTimeline<Bus, Timing>::RunBatch(Cycles target) {
+        // Behind the frontier, stop on it so no batch is half replayed
+        // and half live; it is an instruction boundary like any position
+        replaying = cpu.TotalCycles < frontier;
+        if (replaying) {
+            target = std::min(target, frontier);
+        }
+        const Cycles executed = cpu.RunFor(target - cpu.TotalCycles, memory);
+        if (!replaying) {
+            frontier = cpu.TotalCycles;
+        }
+        replaying = false;
+        return executed;
+    }
+
+    template <typename Bus, typename Timing>
+    void BasicTimeline<Bus, Timing>::ApplyDue() {
+        while (applied < inputs.size() && inputs[applied].position <= cpu.TotalCycles) {
+            Apply(inputs[applied++]);
+        }
+    }
+
+    // ====================================================================
+    // GOING BACK
+    // ====================================================================
+
+    template <typename Bus, typename Timing>
+    bool BasicTimeline<Bus, Timing>::StepBack() {
+        const Cycles now = cpu.TotalCycles;
+        if (now <= Earliest()) {
+            return false;
+        }
+
+        // Land just short of now, then step to find where the last
+        // instruction began
+        const Cycles from = now - std::min(now - Earliest(), LONGEST_STEP);
+        RestoreBefore(from);
+        ReplayTo(from);
+
+        Cycles previous = cpu.TotalCycles;
+        while (cpu.TotalCycles < now) {
+            previous = cpu.TotalCycles;
+            if (!StepOnce()) {
+                break;
+            }
+            ApplyDue();
+        }
+
+        RestoreBefore(previous);
+        ReplayTo(previous);
+        return true;
+    }
+
+    template <typename Bus, typename Timing>
+    void BasicTimeline<Bus, Timing>::Seek(Cycles position) {
+        if (position >= cpu.TotalCycles) {
+            RunFor(position - cpu.TotalCycles);
+            return;
+        }
+        RestoreBefore(position);
+        ReplayTo(position);
+    }
+
+    template <typename Bus, typename Timing>
+    void BasicTimeline<Bus, Timing>::RestoreBefore(Cycles position) {
+        // The first checkpoint is at or before anything reachable
+        std::size_t index = marks.size() - 1;
+        while (index > 0 && marks[index].position > position) {
+            index--;
+        }
+
+        chain.Restore(index, cpu, memory);
+        marks.resize(index + 1);
+        applied = marks[index].applied;
+        ioReplayed = marks[index].ioReplayed;
+        nextCheckpoint = marks[index].position + interval;
+    }
+
+    template <typename Bus, typename Timing>
+    void BasicTimeline<Bus, Timing>::ReplayTo(Cycles position) {
+        while (cpu.TotalCycles < position) {
+            ApplyDue();
+            Cycles target = position;
+            if (applied < inputs.size()) {
+                target = std::min(target, inputs[applied].position);
+            }
+            if (RunBatch(target) == 0) {
+                break;
+            }
+        }
+        ApplyDue();
+    }
+
+    template <typename Bus, typename Timing>
+    bool BasicTimeline<Bus, Timing>::StepOnce() {
+        const Cycles before = cpu.TotalCycles;
+        replaying = before < frontier;
+        cpu.Execute(memory);
+        if (!replaying) {
+            frontier = std::max(frontier, cpu.TotalCycles);
+        }
+        replaying = false;
+        return cpu.TotalCycles != before;
+    }
+
+    // ====================================================================
+    // CHECKPOINTS
+    // ====================================================================
+
+    template <typename Bus, typename Timing>
+    void BasicTimeline<Bus, Timing>::TakeCheckpoint() {
+        const std::size_t storedBefore = chain.StoredPages();
+        chain.Take(cpu, memory);
+        marks.push_back({ cpu.TotalCycles, applied, ioReplayed });
+
+        // The first checkpoint stores every page; adapt on the later ones
+        if (marks.size() > 1) {
+            const std::size_t stored = chain.StoredPages() - storedBefore;
+            if (stored > options.pageBudget) {
+                interval = std::min(interval * 2, options.maxInterval);
+            } else if (stored * 4 < options.pageBudget) {
+                interval = std::max(interval / 2, options.minInterval);
+            }
+        }
+        nextCheckpoint = cpu.TotalCycles + interval;
+    }
+
+    template <typename Bus, typename Timing>
+    std::size_t BasicTimeline<Bus, Timing>::FootprintBytes() const {
+        return chain.FootprintBytes()
+             + marks.capacity() * sizeof(Mark)
+             + inputs.capacity() * sizeof(Input)
+             + ioReads.capacity() * sizeof(IORead);
+    }
+
+    // Explicit instantiations for both buses and both timing policies
+    template class BasicTimeline<Memory, CycleAccurate>;
+    template class BasicTimeline<Memory, Functional>;
+    template class BasicTimeline<MemoryBus, CycleAccurate>;
+    template class BasicTimeline<MemoryBus, Functional>;
+
+} // namespace M6502
@@ -0,0 +1,282 @@
+/**
+ * @file Timeline.h
+ * @brief Reverse execution: step back and reverse-continue by checkpoint and replay
+ */
+
+#ifndef M6502_TIMELINE_H
+#define M6502_TIMELINE_H
+
+#include "Checkpoint.h"
+#include "Constants.h"
+#include "CPU.h"
+#include "IORecorder.h"
+#include "Memory.h"
+#include "MemoryBus.h"
+#include "Timing.h"
+#include <cstdint>
+#include <vector>
+
+namespace M6502 {
+
+    /**
+     * @brief How often a timeline checkpoints
+     *
+     * The interval starts at `minInterval` and adapts after every
+     * checkpoint: it doubles while checkpoints store more than
+     * `pageBudget` new pages and halves while they store under a quarter
+     * of it. Busy programs thus checkpoint less often, keeping memory
+     * down, and quiet ones more often, keeping step-back fast.
+     * `maxInterval` caps the replay behind any step back.
+     */
+    struct TimelineOptions {
+        Cycles minInterval = 10'000;        ///< Cycles (functional: instructions)
+        Cycles maxInterval = 1'000'000;
+        std::size_t pageBudget = 16;        ///< New pages per checkpoint
+    };
+
+    /**
+     * @brief Records a CPU and its bus (Memory or MemoryBus) so they can run backwards
+     *
+     * Forward execution goes through RunFor(), which checkpoints the
+     * machine (see CheckpointChain) every so often. Anything the host
+     * does to the machine between batches is an input that replay
+     * cannot reproduce by itself, so it goes through SetIRQ(), SetNMI()
+     * or Poke(), which apply it and log it with the cycle it happened
+     * at.
+     *
+     * On a MemoryBus, devices are the other non-deterministic part, and
+     * checkpoints do not capture them. The timeline is the bus's
+     * IORecorder: every read from an I/O page is logged with its value
+     * and cycle stamp, and a replay gets the logged value back instead
+     * of calling the device, while its writes to I/O pages are dropped.
+     * Devices therefore only ever see the furthest run, the frontier.
+     * A new input logged behind the frontier makes that the frontier,
+     * and the devices carry on from where the old one left them.
+     *
+     * Any earlier instruction boundary is then reached by restoring the
+     * nearest checkpoint at or before it and replaying forward with the
+     * logged inputs. Going back leaves the logged future in place: the
+     * next RunFor() replays it, reaching the same states again, until
+     * the host logs a new input, which discards everything after it.
+     *
+     * Positions are TotalCycles values. Replay lands on them exactly,
+     * since every logged position is an instruction boundary and a
+     * batch stops at the first boundary at or past its budget. The
+     * state at a position includes the inputs logged there.
+     *
+     * The timeline owns the Memory's dirty-page tracking (one chain per
+     * Memory, see Checkpoint.h) and the MemoryBus's IORecorder, and both
+     * the CPU and the bus must outlive it. Changing either behind its
+     * back breaks replay.
+     */
+    template <typename Bus, typename Timing = CycleAccurate>
+    class BasicTimeline : public IORecorder {
+    public:
+        using CPUType = BasicCPU<Bus, Timing>;
+
+        BasicTimeline(CPUType& cpu, Bus& memory, const TimelineOptions& options = TimelineOptions());
+        ~BasicTimeline();
+
+        BasicTimeline(const BasicTimeline&) = delete;
+        BasicTimeline& operator=(const BasicTimeline&) = delete;
+
+        /**
+         * @brief Drop all history and start recording at the current state
+         */
+        void Start();
+
+        /**
+         * @brief Run forward at least `budget` cycles, checkpointing on the way
+         *
+         * Replays logged inputs if an earlier step back left a future.
+         *
+         * @return Cycles executed
+         */
+        Cycles RunFor(Cycles budget);
+
+        // ================================================================
+        // LOGGED INPUTS
+        // ================================================================
+
+        void SetIRQ(bool asserted);
+        void SetNMI(bool asserted);
+
+        /**
+         * @brief Write `value` to `address` as an input (keyboard, disk, ...)
+         */
+        void Poke(Address address, Byte value);
+
+        // ================================================================
+        // GOING BACK
+        // ================================================================
+
+        /**
+         * @brief Go back to the start of the instruction (or interrupt entry) just run
+         * @return false, with nothing changed, at the start of the history
+         */
+        bool StepBack();
+
+        /**
+         * @brief Go to the first instruction boundary at or after `position`
+         *
+         * Earlier than Earliest() goes to Earliest(); later than Now()
+         * runs forward.
+         */
+        void Seek(Cycles position);
+
+        /**
+         * @brief Go back to the latest earlier boundary where `stop(cpu)` is true
+         *
+         * Like RunUntil() backwards. The predicate sees the state before
+         * each instruction, as a breakpoint would.
+         *
+         * @return false if there is none; the machine is then at Earliest()
+         */
+        template <typename Predicate>
+        bool ReverseContinue(Predicate stop);
+
+        Cycles Now() const { return cpu.TotalCycles; }
+
+        /// Where the history starts
+        Cycles Earliest() const { return marks.empty() ? cpu.TotalCycles : marks.front().position; }
+
+        /// Cycles until the next checkpoint, as adapted so far
+        Cycles Interval() const { return interval; }
+
+        std::size_t CheckpointCount() const { return chain.Count(); }
+        std::size_t InputCount() const { return inputs.size(); }
+
+        /// Device reads logged up to the frontier
+        std::size_t IOReadCount() const { return ioReads.size(); }
+
+        /// Heap bytes held by the checkpoints and the input log
+        std::size_t FootprintBytes() const;
+
+    private:
+        enum class InputKind : Byte { IRQ, NMI, Poke };
+
+        struct Input {
+            Cycles position;
+            InputKind kind;
+            Byte value;         ///< Line level, or the byte poked
+            Address address;    ///< Poke only
+        };
+
+        /// A read from an I/O page as the device answered it
+        struct IORead {
+            Cycles cycle;       ///< The access's stamp (MemoryBus::SetClock())
+            Address address;
+            Byte value;
+        };
+
+        /// Where a checkpoint was taken, and how much of each log it had used
+        struct Mark {
+            Cycles position;
+            std::size_t applied;
+            std::size_t ioReplayed;
+        };
+
+        // IORecorder
+        bool Replaying() const override { return replaying; }
+        void OnIORead(Address address, Cycles cycle, Byte value) override;
+        Byte ReplayIORead(Address address, Cycles cycle) override;
+
+        /// cpu.RunFor() to `target`, or only to the frontier if behind it
+        Cycles RunBatch(Cycles target);
+
+        /// Apply one more input to the machine
+        void Apply(const Input& input);
+
+        /// Log an input happening now, discarding any logged future
+        void Record(const Input& input);
+
+        /// Apply logged inputs due at or before the current position
+        void ApplyDue();
+
+        /// Restore the latest checkpoint at or before `position`
+        void RestoreBefore(Cycles position);
+
+        /// Replay from the current state to the first boundary at or after `position`
+        void ReplayTo(Cycles position);
+
+        /// Replay one instruction (or interrupt entry); false if none ran
+        bool StepOnce();
+
+        void TakeCheckpoint();
+
+        CPUType& cpu;
+        Bus& memory;
+        TimelineOptions options;
+
+        CheckpointChain chain;
+        std::vector<Mark> marks;        ///< One per checkpoint in the chain
+        Cycles interval;
+        Cycles nextCheckpoint;
+
+        std::vector<Input> inputs;
+        std::size_t applied;            ///< Inputs already in the machine's state
+
+        std::vector<IORead> ioReads;
+        std::size_t ioReplayed;         ///< Reads the machine has made so far
+        Cycles frontier;                ///< Furthest position the devices have seen
+        bool replaying;                 ///< A batch behind the frontier is running
+    };
+
+    // ====================================================================
+    // REVERSE CONTINUE
+    // ====================================================================
+
+    template <typename Bus, typename Timing>
+    template <typename Predicate>
+    bool BasicTimeline<Bus, Timing>::ReverseContinue(Predicate stop) {
+        const Cycles now = cpu.TotalCycles;
+
+        // Restoring a checkpoint drops the later ones, so remember where
+        // each segment ends before scanning them newest first
+        std::vector<Cycles> ends;
+        for (std::size_t i = 1; i < marks.size(); i++) {
+            ends.push_back(marks[i].position);
+        }
+        ends.push_back(now);
+
+        for (std::size_t segment = ends.size(); segment-- > 0;) {
+            RestoreBefore(marks[segment].position);
+
+            // Step through the segment keeping the latest match
+            bool found = false;
+            Cycles match = 0;
+            while (cpu.TotalCycles < ends[segment]) {
+                ApplyDue();
+                if (stop(static_cast<const CPUType&>(cpu))) {
+                    found = true;
+                    match = cpu.TotalCycles;
+                }
+                if (!StepOnce()) {
+                    break;
+                }
+            }
+
+            if (found) {
+                RestoreBefore(match);
+                ReplayTo(match);
+                return true;
+            }
+        }
+
+        // Nothing matched: stop at the start of the history
+        RestoreBefore(Earliest());
+        ReplayTo(Earliest());
+        return false;
+    }
+
+    using Timeline = BasicTimeline<Memory, CycleAccurate>;
+    using FunctionalTimeline = BasicTimeline<Memory, Functional>;
+
+    extern template class BasicTimeline<Memory, CycleAccurate>;
+    extern template class BasicTimeline<Memory, Functional>;
+    extern template class BasicTimeline<MemoryBus, CycleAccurate>;
+    extern template class BasicTimeline<MemoryBus, Functional>;
+
+} // namespace M6502
+
+#endif // M6502_TIMELINE_H
@@ -0,0 +1,52 @@
+/**
+ * @file Timing.h
+ * @brief Timing policies for the CPU core: cycle-accurate or functional
+ */
+
+#ifndef M6502_TIMING_H
+#define M6502_TIMING_H
+
+#include "Constants.h"
+
+namespace M6502 {
+
+    /**
+     * @brief Cycle counter that ignores every update
+     *
+     * Stands in for Cycles in the functional core. Every `cycles++` and
+     * `cycles += n` in the instruction helpers and bus accessors compiles
+     * to nothing.
+     */
+    struct NoCycles {
+        NoCycles& operator++() { return *this; }
+        NoCycles operator++(int) { return *this; }
+        NoCycles& operator+=(Cycles) { return *this; }
+        NoCycles& operator-=(Cycles) { return *this; }
+    };
+
+    /**
+     * @brief Default policy: every bus access and internal operation is counted
+     *
+     * Budgets passed to RunFor() and friends, return values and
+     * TotalCycles are all in clock cycles.
+     */
+    struct CycleAccurate {
+        using Counter = Cycles;
+        static constexpr bool COUNTS_CYCLES = true;
+    };
+
+    /**
+     * @brief No cycle bookkeeping at all, for runs that only need final state
+     *
+     * Same instruction implementations as the accurate core, with the
+     * counter replaced by NoCycles. Budgets, return values and
+     * TotalCycles count instructions (an interrupt entry counts as one).
+     */
+    struct Functional {
+        using Counter = NoCycles;
+        static constexpr bool COUNTS_CYCLES = false;
+    };
+
+} // namespace M6502
+
+#endif // M6502_TIMING_H
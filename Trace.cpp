@@ -0,0 +1,212 @@
+/**
+ * @file Trace.cpp
+ * @brief TraceBuffer and the trace file format
+ */
+
+#include "Trace.h"
+#include <algorithm>
+#include <cstring>
+
+namespace M6502 {
+
+    namespace {
+
+        const Byte TRACE_MAGIC[8] = { 'M', '6', '5', '0', '2', 'T', 'R', 'C' };
+        constexpr Word TRACE_VERSION = 1;
+        constexpr std::size_t TRACE_HEADER_SIZE = 16;
+
+        void EncodeRecord(const TraceRecord& record, Byte* out) {
+            out[0] = static_cast<Byte>(record.PC & 0xFF);
+            out[1] = static_cast<Byte>(record.PC >> 8);
+            out[2] = record.opcode;
+            out[3] = record.A;
+            out[4] = record.X;
+            out[5] = record.Y;
+            out[6] = record.SP;
+            out[7] = record.P;
+            out[8] = record.cycles;
+            out[9] = record.kind;
+        }
+
+        TraceRecord DecodeRecord(const Byte* in) {
+            TraceRecord record;
+            record.PC = static_cast<Word>(in[0] | (in[1] << 8));
+            record.opcode = in[2];
+            record.A = in[3];
+            record.X = in[4];
+            record.Y = in[5];
+            record.SP = in[6];
+            record.P = in[7];
+            record.cycles = in[8];
+            record.kind = in[9];
+            return record;
+        }
+
+    } // namespace
+
+    // ====================================================================
+    // RING BUFFER
+    // ====================================================================
+
+    TraceBuffer::TraceBuffer(std::size_t capacity, Mode mode) : mode(mode) {
+        std::size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        records.resize(size);
+        mask = size - 1;
+
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+        dropped.store(0, std::memory_order_relaxed);
+        cachedTail = 0;
+    }
+
+    void TraceBuffer::Write(const TraceRecord* batch, std::size_t count) {
+        const std::uint64_t position = head.load(std::memory_order_relaxed);
+
+        if (mode == Mode::Stream) {
+            // Only look at the consumer's index when the batch seems not to fit
+            if (position - cachedTail + count > records.size()) {
+                cachedTail = tail.load(std::memory_order_acquire);
+            }
+            const std::uint64_t room = records.size() - (position - cachedTail);
+            if (count > room) {
+                dropped.store(dropped.load(std::memory_order_relaxed) + (count - room),
+                              std::memory_order_relaxed);
+                count = static_cast<std::size_t>(room);
+            }
+        }
+
+        // At most two runs: up to the end of the ring, then from its start
+        const std::size_t start = static_cast<std::size_t>(position & mask);
+        const std::size_t first = std::min(count, records.size() - start);
+        std::memcpy(records.data() + start, batch, first * sizeof(TraceRecord));
+        std::memcpy(records.data(), batch + first, (count - first) * sizeof(TraceRecord));
+        head.store(position + count, std::memory_order_release);
+    }
+
+    std::size_t TraceBuffer::Drain(std::vector<TraceRecord>& out) {
+        const std::uint64_t end = head.load(std::memory_order_acquire);
+        std::uint64_t begin = tail.load(std::memory_order_relaxed);
+
+        // Overwrite mode: anything older than one lap is gone
+        if (end - begin > records.size()) {
+            begin = end - records.size();
+        }
+
+        for (std::uint64_t position = begin; position < end; position++) {
+            out.push_back(records[position & mask]);
+        }
+
+        // Hands the slots back to a Stream producer
+        tail.store(end, std::memory_order_release);
+        return static_cast<std::size_t>(end - begin);
+    }
+
+    std::vector<TraceRecord> TraceBuffer::Records() const {
+        const std::uint64_t end = head.load(std::memory_order_acquire);
+        std::uint64_t begin = mode == Mode::Stream ? tail.load(std::memory_order_acquire) : 0;
+        if (end - begin > records.size()) {
+            begin = end - records.size();
+        }
+
+        std::vector<TraceRecord> result;
+        result.reserve(static_cast<std::size_t>(end - begin));
+        for (std::uint64_t position = begin; position < end; position++) {
+            result.push_back(records[position & mask]);
+        }
+        return result;
+    }
+
+    bool TraceBuffer::Save(const char* path) const {
+        std::FILE* file = std::fopen(path, "wb");
+        if (file == nullptr) {
+            return false;
+        }
+
+        const std::vector<TraceRecord> held = Records();
+        bool written = WriteTraceHeader(file) && WriteTraceRecords(file, held.data(), held.size());
+        return std::fclose(file) == 0 && written;
+    }
+
+    void TraceBuffer::Clear() {
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+        dropped.store(0, std::memory_order_relaxed);
+        cachedTail = 0;
+    }
+
+    // ====================================================================
+    // TRACE FILES
+    // ====================================================================
+
+    bool WriteTraceHeader(std::FILE* file) {
+        Byte header[TRACE_HEADER_SIZE] = {};
+        std::memcpy(header, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+        header[8] = static_cast<Byte>(TRACE_VERSION & 0xFF);
+        header[9] = static_cast<Byte>(TRACE_VERSION >> 8);
+        header[10] = static_cast<Byte>(TRACE_RECORD_SIZE);
+        header[11] = 0;
+        return std::fwrite(header, 1, sizeof(header), file) == sizeof(header);
+    }
+
+    bool WriteTraceRecords(std::FILE* file, const TraceRecord* records, std::size_t count) {
+        // Encode in chunks so a long trace is a few large writes
+        constexpr std::size_t CHUNK = 4096;
+        Byte buffer[CHUNK * TRACE_RECORD_SIZE];
+
+        while (count > 0) {
+            std::size_t batch = count < CHUNK ? count : CHUNK;
+            for (std::size_t i = 0; i < batch; i++) {
+                EncodeRecord(records[i], buffer + i * TRACE_RECORD_SIZE);
+            }
+
+            std::size_t bytes = batch * TRACE_RECORD_SIZE;
+            if (std::fwrite(buffer, 1, bytes, file) != bytes) {
+                return false;
+            }
+            records += batch;
+            count -= batch;
+        }
+        return true;
+    }
+
+    bool ReadTraceFile(const char* path, std::vector<TraceRecord>& records) {
+        records.clear();
+
+        std::FILE* file = std::fopen(path, "rb");
+        if (file == nullptr) {
+            return false;
+        }
+
+        Byte header[TRACE_HEADER_SIZE];
+        bool valid = std::fread(header, 1, sizeof(header), file) == sizeof(header) &&
+                     std::memcmp(header, TRACE_MAGIC, sizeof(TRACE_MAGIC)) == 0 &&
+                     (header[8] | (header[9] << 8)) == TRACE_VERSION &&
+                     (header[10] | (header[11] << 8)) == TRACE_RECORD_SIZE;
+
+        Byte buffer[4096 * TRACE_RECORD_SIZE];
+        std::size_t pending = 0;    // bytes of a record split across reads
+
+        while (valid) {
+            std::size_t count = std::fread(buffer + pending, 1, sizeof(buffer) - pending, file);
+            if (count == 0) {
+                break;
+            }
+
+            count += pending;
+            std::size_t whole = count / TRACE_RECORD_SIZE;
+            for (std::size_t i = 0; i < whole; i++) {
+                records.push_back(DecodeRecord(buffer + i * TRACE_RECORD_SIZE));
+            }
+
+            pending = count - whole * TRACE_RECORD_SIZE;
+            std::memmove(buffer, buffer + whole * TRACE_RECORD_SIZE, pending);
+        }
+
+        std::fclose(file);
+        return valid && pending == 0;
+    }
+
+} // namespace M6502
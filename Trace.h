@@ -0,0 +1,170 @@
+/**
+ * @file Trace.h
+ * @brief Binary execution trace: fixed-size records in a lock-free ring buffer
+ */
+
+#ifndef M6502_TRACE_H
+#define M6502_TRACE_H
+
+#include "Constants.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace M6502 {
+
+    /**
+     * @brief One executed instruction (or interrupt entry)
+     *
+     * Registers are as they were before the instruction ran, which is
+     * what a reference log such as nestest.log shows. `cycles` is what
+     * the instruction took; the functional core leaves it at zero.
+     */
+    struct TraceRecord {
+        Word PC;
+        Byte opcode;        ///< Zero for an interrupt entry
+        Byte A;
+        Byte X;
+        Byte Y;
+        Byte SP;
+        Byte P;
+        Byte cycles;
+        Byte kind;          ///< TRACE_INSTRUCTION or TRACE_INTERRUPT
+    };
+
+    constexpr Byte TRACE_INSTRUCTION = 0;
+    constexpr Byte TRACE_INTERRUPT = 1;
+
+    /// Size of a record in a trace file (little-endian, no padding)
+    constexpr std::size_t TRACE_RECORD_SIZE = 10;
+
+    /**
+     * @brief Single-producer, single-consumer ring of TraceRecords
+     *
+     * The CPU is the producer; Write() never blocks or allocates. In
+     * Overwrite mode the ring is a flight recorder holding the newest
+     * Capacity() records, and is read with Records() or Save() while the
+     * CPU is stopped. In Stream mode a full ring drops new records
+     * (counted by Dropped()) instead, so another thread may Drain() it
+     * concurrently, for example to append the trace to a file.
+     */
+    class TraceBuffer {
+    public:
+        enum class Mode : Byte {
+            Overwrite,
+            Stream
+        };
+
+        /**
+         * @param capacity Records held; rounded up to a power of two
+         */
+        explicit TraceBuffer(std::size_t capacity = 1 << 20, Mode mode = Mode::Overwrite);
+
+        TraceBuffer(const TraceBuffer&) = delete;
+        TraceBuffer& operator=(const TraceBuffer&) = delete;
+
+        /**
+         * @brief Append one record (producer thread only)
+         */
+        void Write(const TraceRecord& record) {
+            const std::uint64_t position = head.load(std::memory_order_relaxed);
+
+            if (mode == Mode::Stream && position - cachedTail == records.size()) {
+                // Only look at the consumer's index when the ring seems full
+                cachedTail = tail.load(std::memory_order_acquire);
+                if (position - cachedTail == records.size()) {
+                    dropped.store(dropped.load(std::memory_order_relaxed) + 1,
+                                  std::memory_order_relaxed);
+                    return;
+                }
+            }
+
+            records[position & mask] = record;
+            head.store(position + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief Append `count` records in order, publishing them at once (producer only)
+         *
+         * For producers that collect records locally first, like the
+         * threaded interpreter. A Stream ring keeps as many as fit and
+         * drops the rest, as that many Write() calls would.
+         */
+        void Write(const TraceRecord* batch, std::size_t count);
+
+        /**
+         * @brief Move every unread record to the end of `out` (consumer thread)
+         *
+         * Safe to call while the CPU runs in Stream mode. In Overwrite mode
+         * the producer must be stopped; records overwritten since the last
+         * Drain() are skipped.
+         *
+         * @return Records appended
+         */
+        std::size_t Drain(std::vector<TraceRecord>& out);
+
+        /**
+         * @brief The records still held, oldest first (producer stopped)
+         */
+        std::vector<TraceRecord> Records() const;
+
+        /**
+         * @brief Write Records() to a trace file (producer stopped)
+         * @return false if the file could not be written
+         */
+        bool Save(const char* path) const;
+
+        /**
+         * @brief Forget every record and reset the counters (producer stopped)
+         */
+        void Clear();
+
+        std::size_t Capacity() const { return records.size(); }
+        Mode GetMode() const { return mode; }
+
+        /// Records ever written, including ones since overwritten
+        std::uint64_t Written() const { return head.load(std::memory_order_acquire); }
+
+        /// Records refused because a Stream ring was full
+        std::uint64_t Dropped() const { return dropped.load(std::memory_order_relaxed); }
+
+    private:
+        std::vector<TraceRecord> records;
+        std::uint64_t mask;
+        Mode mode;
+
+        // Producer and consumer indices on separate cache lines
+        alignas(64) std::atomic<std::uint64_t> head;
+        std::uint64_t cachedTail;       ///< Producer's last view of `tail`
+        std::atomic<std::uint64_t> dropped;
+        alignas(64) std::atomic<std::uint64_t> tail;
+    };
+
+    // ====================================================================
+    // TRACE FILES
+    // ====================================================================
+    //
+    // A 16-byte header ("M6502TRC", version, record size, reserved)
+    // followed by TRACE_RECORD_SIZE-byte records up to the end of the
+    // file. There is no record count, so a consumer can keep appending.
+
+    /**
+     * @brief Start a trace file
+     */
+    bool WriteTraceHeader(std::FILE* file);
+
+    /**
+     * @brief Append `count` records to a file started with WriteTraceHeader()
+     */
+    bool WriteTraceRecords(std::FILE* file, const TraceRecord* records, std::size_t count);
+
+    /**
+     * @brief Read a whole trace file into `records` (replacing its contents)
+     * @return false if the file is missing, not a trace, or truncated mid-record
+     */
+    bool ReadTraceFile(const char* path, std::vector<TraceRecord>& records);
+
+} // namespace M6502
+
+#endif // M6502_TRACE_H
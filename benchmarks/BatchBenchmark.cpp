@@ -0,0 +1,136 @@
+/**
+ * @file BatchBenchmark.cpp
+ * @brief Throughput of the batch runner against thread count
+ *
+ * Runs the same set of short, independent jobs with 1, 2, 4, ... up to
+ * the hardware thread count, reporting jobs per second and speedup over
+ * one thread, and checks every run returns exactly the single-threaded
+ * results. Jobs differ in length so the work-stealing path is used.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -I. -pthread benchmarks/BatchBenchmark.cpp \
+ *       CPU.cpp Instructions.cpp Memory.cpp MemoryBus.cpp BatchRunner.cpp -o batch_bench
+ */
+
+#include "BatchRunner.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace M6502;
+
+namespace {
+
+    constexpr std::size_t JOBS = 100'000;
+    constexpr Address LOAD_ADDRESS = 0x0400;
+    constexpr Address HALT_ADDRESS = 0x040D;
+
+    /**
+     *        STX $10
+     * loop:  CLC
+     *        ADC $10
+     *        STA $0200,X
+     *        DEX
+     *        BNE loop
+     *        STA $11
+     * halt:  JMP halt
+     *
+     * Runs X iterations, so job length follows the initial X.
+     */
+    const Byte PROGRAM[] = {
+        INS_STX_ZP,   0x10,
+        INS_CLC,
+        INS_ADC_ZP,   0x10,
+        INS_STA_ABSX, 0x00, 0x02,
+        INS_DEX,
+        INS_BNE,      0xF7,         // back to $0402
+        INS_STA_ZP,   0x11,
+        INS_JMP_ABS,  0x0D, 0x04
+    };
+
+    std::vector<BatchJob> MakeJobs() {
+        std::vector<BatchJob> jobs(JOBS);
+        for (std::size_t i = 0; i < JOBS; i++) {
+            BatchJob& job = jobs[i];
+            job.image = PROGRAM;
+            job.imageSize = sizeof(PROGRAM);
+            job.loadAddress = LOAD_ADDRESS;
+            job.initial.PC = LOAD_ADDRESS;
+            job.initial.A = static_cast<Byte>(i);
+            job.initial.X = static_cast<Byte>(1 + (i * 37) % 255);
+            job.budget = 100'000;
+            job.stopAtHalt = true;
+            job.haltAddress = HALT_ADDRESS;
+            job.outputAddress = 0x0200;
+            job.outputSize = 0x100;
+        }
+        return jobs;
+    }
+
+    bool SameResults(const std::vector<BatchResult>& a, const std::vector<BatchResult>& b) {
+        for (std::size_t i = 0; i < a.size(); i++) {
+            const BatchRegisters& x = a[i].final;
+            const BatchRegisters& y = b[i].final;
+            if (x.A != y.A || x.X != y.X || x.Y != y.Y || x.SP != y.SP || x.P != y.P ||
+                x.PC != y.PC || a[i].cycles != b[i].cycles || a[i].halted != b[i].halted ||
+                a[i].output != b[i].output) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+} // namespace
+
+int main() {
+    const std::vector<BatchJob> jobs = MakeJobs();
+    const std::size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << "Batch runner benchmark (" << JOBS << " jobs, "
+              << hardware << " hardware threads)\n\n"
+              << std::setw(8) << "threads" << std::setw(14) << "jobs/s"
+              << std::setw(10) << "speedup" << std::setw(10) << "steals" << "\n";
+
+    std::vector<BatchResult> reference;
+    double baseline = 0;
+
+    for (std::size_t threads = 1; ; threads *= 2) {
+        if (threads > hardware) {
+            threads = hardware;
+        }
+
+        BatchRunner runner(threads);
+        runner.Run(jobs);   // warm the arenas
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<BatchResult> results = runner.Run(jobs);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        double rate = JOBS / seconds;
+        if (reference.empty()) {
+            reference = results;
+            baseline = rate;
+        }
+
+        bool halted = true;
+        for (const BatchResult& result : results) {
+            halted &= result.halted;
+        }
+
+        std::cout << std::setw(8) << threads << std::fixed << std::setprecision(0)
+                  << std::setw(14) << rate << std::setprecision(2)
+                  << std::setw(9) << rate / baseline << "x" << std::setw(10) << runner.Steals()
+                  << (SameResults(reference, results) && halted ? "" : "   RESULTS DIFFER")
+                  << "\n";
+
+        if (threads == hardware) {
+            break;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,498 @@
+/**
+ * @file BenchmarkSuite.cpp
+ * @brief Per-opcode and whole-program timings as JSON, for regression tracking
+ *
+ * Microbenchmarks, one per row of OpcodeTable.h:
+ *   opcode      64 copies of the instruction and a JMP back, so the
+ *               instruction is 64 of every 65 executed
+ *   decimal     ADC/SBC in every mode with the D flag set
+ *   page-cross  indexed reads whose effective address crosses a page
+ *   branch      every branch taken, not taken, and taken across a page
+ *
+ * Control flow cannot repeat in a straight line, so JMP is chained to
+ * the next copy, and JSR/RTS and BRK/RTI are timed as pairs.
+ *
+ * Whole programs: the Workloads.h loops (memcpy, bubble sort, BCD
+ * arithmetic, and the mixed, call, page-fill and self-modifying loops).
+ *
+ * Every case runs its cycle budget through RunFor() several times and
+ * keeps the fastest run. The instruction count comes from one untimed
+ * run of the same budget stepped through Execute().
+ *
+ * Usage: benchmark_suite [--cycles N] [--repeat N] [--group G] [output.json]
+ *
+ * --group runs only one group (opcode, decimal, page-cross, branch or
+ * workload).
+ *
+ * JSON goes to the file, or to stdout if none is given. Progress goes
+ * to stderr.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -I. benchmarks/BenchmarkSuite.cpp CPU.cpp Instructions.cpp \
+ *       Memory.cpp MemoryBus.cpp Mnemonics.cpp -o benchmark_suite
+ */
+
+#include "CPU.h"
+#include "Decimal.h"
+#include "Memory.h"
+#include "Mnemonics.h"
+#include "OpcodeTable.h"
+#include "Workloads.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace M6502;
+
+namespace {
+
+    constexpr Address PROLOGUE = 0x0200;    ///< Register and flag setup, then JMP to the loop
+    constexpr Address POINTERS = 0x0300;    ///< JMP (ind) targets, one per copy
+    constexpr Address LOOP = 0x1000;
+    constexpr Address RETURN = 0x1F00;      ///< RTS for JSR, RTI for BRK
+    constexpr Address DATA = 0x2000;
+    constexpr int COPIES = 64;
+
+    // Zero-page operands
+    constexpr Byte ZP_DATA = 0x80;
+    constexpr Byte ZP_POINTER = 0x40;       ///< -> DATA, for (zp,X) with X = 0
+    constexpr Byte ZP_POINTER_Y = 0x42;     ///< -> DATA, for (zp),Y
+    constexpr Byte ZP_POINTER_CROSS = 0x44; ///< -> DATA + $FF, for (zp),Y with Y = 1
+
+    struct Options {
+        Cycles cycles = 2'000'000;
+        int repeat = 5;
+        const char* group = nullptr;        ///< Only this group; all if null
+        const char* output = nullptr;
+    };
+
+    struct Case {
+        std::string name;
+        const char* group;
+        int opcode;                                 ///< -1 for whole programs
+        std::function<void(Memory&)> load;          ///< Program, data and reset vector
+    };
+
+    struct Result {
+        double nsPerInstruction;
+        double cyclesPerInstruction;
+        double mips;
+        std::uint64_t instructions;                 ///< In the fastest run
+    };
+
+    // ====================================================================
+    // MICROBENCHMARK PROGRAMS
+    // ====================================================================
+
+    /// One row of OpcodeTable.h
+    struct Row {
+        enum class Kind { Memory, Implied, Stack, Branch } kind;
+        Byte opcode;
+        AddressingMode mode;
+        bool pageCross;
+        Byte flag;          ///< Branches: the flag tested...
+        bool expected;      ///< ...and the value that takes the branch
+    };
+
+    std::vector<Row> TableRows() {
+        std::vector<Row> rows;
+
+        #define M6502_ROW_MEM(opcode, operation, mode, pageCross) \
+            rows.push_back({ Row::Kind::Memory, opcode, AddressingMode::mode, pageCross, 0, false });
+        #define M6502_ROW_IMP(opcode, operation, mode) \
+            rows.push_back({ Row::Kind::Implied, opcode, AddressingMode::mode, false, 0, false });
+        #define M6502_ROW_STK(opcode, operation) \
+            rows.push_back({ Row::Kind::Stack, opcode, AddressingMode::Implied, false, 0, false });
+        #define M6502_ROW_BRANCH(opcode, flag, expected) \
+            rows.push_back({ Row::Kind::Branch, opcode, AddressingMode::Relative, false, flag, expected });
+
+        M6502_OPCODE_TABLE(M6502_ROW_MEM, M6502_ROW_IMP, M6502_ROW_STK, M6502_ROW_BRANCH)
+
+        #undef M6502_ROW_MEM
+        #undef M6502_ROW_IMP
+        #undef M6502_ROW_STK
+        #undef M6502_ROW_BRANCH
+
+        return rows;
+    }
+
+    /// Registers and flags the loop starts with
+    struct Setup {
+        Byte x = 0;
+        Byte y = 0;
+        Byte p = FLAG_UNUSED | FLAG_INTERRUPT;
+    };
+
+    void Place(Memory& memory, Address& address, std::initializer_list<Byte> bytes) {
+        for (Byte value : bytes) {
+            memory[address++] = value;
+        }
+    }
+
+    /// Data every microbenchmark can read and write, and the setup code
+    void LoadCommon(Memory& memory, const Setup& setup, Address entry) {
+        for (int i = 0; i < 0x200; i++) {
+            memory[DATA + i] = static_cast<Byte>(i * 7);
+        }
+        for (int i = 0; i < 0x20; i++) {
+            memory[ZP_DATA + i] = static_cast<Byte>(i * 11);
+        }
+        const Address pointers[] = { DATA, DATA, DATA + 0xFF };
+        for (int i = 0; i < 3; i++) {
+            memory[ZP_POINTER + 2 * i] = pointers[i] & 0xFF;
+            memory[ZP_POINTER + 2 * i + 1] = (pointers[i] >> 8) & 0xFF;
+        }
+
+        // P goes through the stack so every flag can be set at once;
+        // A = $11 is a valid BCD operand for the decimal cases
+        Address address = PROLOGUE;
+        Place(memory, address, {
+            INS_LDX_IM,  setup.x,
+            INS_LDY_IM,  setup.y,
+            INS_LDA_IM,  setup.p,
+            INS_PHA,
+            INS_LDA_IM,  0x11,
+            INS_PLP,
+            INS_JMP_ABS, static_cast<Byte>(entry & 0xFF), static_cast<Byte>(entry >> 8)
+        });
+
+        Benchmarks::SetResetVector(memory, PROLOGUE);
+    }
+
+    /// Operand bytes of `mode` pointing at the benchmark data
+    std::vector<Byte> Operand(AddressingMode mode, bool cross) {
+        const Address absolute = cross ? DATA + 0xFF : DATA;
+        switch (mode) {
+            case AddressingMode::Immediate:       return { 0x11 };
+            case AddressingMode::ZeroPage:
+            case AddressingMode::ZeroPageX:
+            case AddressingMode::ZeroPageY:       return { ZP_DATA };
+            case AddressingMode::Absolute:
+            case AddressingMode::AbsoluteX:
+            case AddressingMode::AbsoluteY:       return { static_cast<Byte>(absolute & 0xFF),
+                                                           static_cast<Byte>(absolute >> 8) };
+            case AddressingMode::IndexedIndirect: return { ZP_POINTER };
+            case AddressingMode::IndirectIndexed: return { cross ? ZP_POINTER_CROSS : ZP_POINTER_Y };
+            default:                              return {};
+        }
+    }
+
+    /// COPIES of `instruction` at LOOP, then JMP LOOP
+    void LoadRepeated(Memory& memory, const std::vector<Byte>& instruction, const Setup& setup) {
+        Address address = LOOP;
+        for (int copy = 0; copy < COPIES; copy++) {
+            for (Byte value : instruction) {
+                memory[address++] = value;
+            }
+        }
+        Place(memory, address, { INS_JMP_ABS, LOOP & 0xFF, LOOP >> 8 });
+        LoadCommon(memory, setup, LOOP);
+    }
+
+    /// JMP abs chained through COPIES jumps, each to the next
+    void LoadJumpChain(Memory& memory) {
+        Address address = LOOP;
+        for (int copy = 0; copy < COPIES; copy++) {
+            const Address next = copy + 1 < COPIES ? address + 3 : LOOP;
+            Place(memory, address, { INS_JMP_ABS, static_cast<Byte>(next & 0xFF),
+                                     static_cast<Byte>(next >> 8) });
+        }
+        LoadCommon(memory, Setup{}, LOOP);
+    }
+
+    /// JMP (ind) chained the same way through a pointer per copy
+    void LoadIndirectJumpChain(Memory& memory) {
+        Address address = LOOP;
+        for (int copy = 0; copy < COPIES; copy++) {
+            const Address pointer = POINTERS + 2 * copy;
+            const Address next = copy + 1 < COPIES ? address + 3 : LOOP;
+            memory[pointer] = next & 0xFF;
+            memory[pointer + 1] = (next >> 8) & 0xFF;
+            Place(memory, address, { INS_JMP_IND, static_cast<Byte>(pointer & 0xFF),
+                                     static_cast<Byte>(pointer >> 8) });
+        }
+        LoadCommon(memory, Setup{}, LOOP);
+    }
+
+    /// Taken branches bouncing across the $10FF/$1100 boundary
+    void LoadPageCrossingBranches(Memory& memory, Byte opcode, const Setup& setup) {
+        // $10FC: branch to $1100; $1100: branch back to $10FC. Both
+        // targets are on a different page from the following instruction.
+        memory[0x10FC] = opcode;
+        memory[0x10FD] = 0x02;
+        memory[0x1100] = opcode;
+        memory[0x1101] = 0xFA;
+        LoadCommon(memory, setup, 0x10FC);
+    }
+
+    /// Flags that make a branch on (flag == expected) go the wanted way
+    Setup BranchSetup(const Row& row, bool taken) {
+        Setup setup;
+        if (row.expected == taken) {
+            setup.p |= row.flag;
+        }
+        return setup;
+    }
+
+    std::string Name(Byte opcode, AddressingMode mode) {
+        std::string name = Mnemonic(opcode);
+        const char* operand = OperandNotation(mode);
+        if (*operand != '\0') {
+            name += ' ';
+            name += operand;
+        }
+        return name;
+    }
+
+    std::vector<Case> MicroBenchmarks() {
+        std::vector<Case> cases;
+
+        for (const Row& row : TableRows()) {
+            const std::string name = Name(row.opcode, row.mode);
+            const int opcode = row.opcode;
+
+            if (row.kind == Row::Kind::Branch) {
+                // Offset 0 continues at the next copy either way
+                const std::vector<Byte> branch = { row.opcode, 0x00 };
+                const Setup taken = BranchSetup(row, true);
+                const Setup notTaken = BranchSetup(row, false);
+                cases.push_back({ name + " taken", "branch", opcode,
+                                  [branch, taken](Memory& m) { LoadRepeated(m, branch, taken); } });
+                cases.push_back({ name + " not taken", "branch", opcode,
+                                  [branch, notTaken](Memory& m) { LoadRepeated(m, branch, notTaken); } });
+                cases.push_back({ name + " page cross", "branch", opcode,
+                                  [opcode = row.opcode, taken](Memory& m) {
+                                      LoadPageCrossingBranches(m, opcode, taken);
+                                  } });
+                continue;
+            }
+
+            if (row.opcode == INS_JMP_ABS) {
+                cases.push_back({ name, "opcode", opcode, LoadJumpChain });
+                continue;
+            }
+            if (row.opcode == INS_JMP_IND) {
+                cases.push_back({ name, "opcode", opcode, LoadIndirectJumpChain });
+                continue;
+            }
+            if (row.opcode == INS_JSR || row.opcode == INS_BRK) {
+                // Paired with the return at RETURN; BRK skips a signature byte
+                const bool brk = row.opcode == INS_BRK;
+                const std::vector<Byte> call = brk
+                    ? std::vector<Byte>{ INS_BRK, 0x00 }
+                    : std::vector<Byte>{ INS_JSR, RETURN & 0xFF, RETURN >> 8 };
+                cases.push_back({ brk ? "BRK / RTI" : "JSR abs / RTS", "opcode", opcode,
+                                  [call, brk](Memory& m) {
+                                      LoadRepeated(m, call, Setup{});
+                                      m[RETURN] = brk ? INS_RTI : INS_RTS;
+                                      m[VECTOR_IRQ_BRK] = RETURN & 0xFF;
+                                      m[VECTOR_IRQ_BRK + 1] = RETURN >> 8;
+                                  } });
+                continue;
+            }
+            if (row.opcode == INS_RTS || row.opcode == INS_RTI) {
+                continue;   // Timed with JSR and BRK
+            }
+
+            std::vector<Byte> instruction = { row.opcode };
+            for (Byte value : Operand(row.mode, false)) {
+                instruction.push_back(value);
+            }
+            cases.push_back({ name, "opcode", opcode,
+                              [instruction](Memory& m) { LoadRepeated(m, instruction, Setup{}); } });
+
+            const char* mnemonic = Mnemonic(row.opcode);
+            if (std::strcmp(mnemonic, "ADC") == 0 || std::strcmp(mnemonic, "SBC") == 0) {
+                Setup decimal;
+                decimal.p |= FLAG_DECIMAL;
+                cases.push_back({ name, "decimal", opcode,
+                                  [instruction, decimal](Memory& m) {
+                                      LoadRepeated(m, instruction, decimal);
+                                  } });
+            }
+
+            const bool indexed = row.mode == AddressingMode::AbsoluteX
+                              || row.mode == AddressingMode::AbsoluteY
+                              || row.mode == AddressingMode::IndirectIndexed;
+            if (indexed && row.pageCross) {
+                std::vector<Byte> crossing = { row.opcode };
+                for (Byte value : Operand(row.mode, true)) {
+                    crossing.push_back(value);
+                }
+                Setup cross;
+                cross.x = cross.y = 1;
+                cases.push_back({ name, "page-cross", opcode,
+                                  [crossing, cross](Memory& m) { LoadRepeated(m, crossing, cross); } });
+            }
+        }
+
+        return cases;
+    }
+
+    std::vector<Case> Programs() {
+        using namespace Benchmarks;
+        return {
+            { "memcpy",         "workload", -1, LoadMemcpyWorkload<Memory> },
+            { "bubble sort",    "workload", -1, LoadSortWorkload<Memory> },
+            { "bcd arithmetic", "workload", -1, LoadBcdWorkload<Memory> },
+            { "mixed",          "workload", -1, LoadMixedWorkload<Memory> },
+            { "calls",          "workload", -1, LoadCallWorkload<Memory> },
+            { "page fill",      "workload", -1, LoadPageFillWorkload<Memory> },
+            { "self-modifying", "workload", -1, LoadSelfModifyingWorkload<Memory> },
+        };
+    }
+
+    // ====================================================================
+    // MEASUREMENT
+    // ====================================================================
+
+    /// Average cycles per instruction over `budget`, single-stepped
+    double CyclesPerInstruction(const Case& test, Cycles budget) {
+        CPU cpu;
+        Memory memory;
+        test.load(memory);
+        cpu.Reset(memory);
+
+        std::uint64_t instructions = 0;
+        Cycles cycles = 0;
+        while (cycles < budget) {
+            cycles += cpu.Execute(memory);
+            instructions++;
+        }
+        return static_cast<double>(cycles) / static_cast<double>(instructions);
+    }
+
+    Result Measure(const Case& test, const Options& options) {
+        const double cyclesPerInstruction = CyclesPerInstruction(test, options.cycles);
+
+        double best = 0.0;
+        Cycles bestCycles = 0;
+        for (int run = 0; run < options.repeat; run++) {
+            CPU cpu;
+            Memory memory;
+            test.load(memory);
+            cpu.Reset(memory);
+
+            const Cycles startCycles = cpu.TotalCycles;
+            auto start = std::chrono::steady_clock::now();
+            cpu.RunFor(options.cycles, memory);
+            auto end = std::chrono::steady_clock::now();
+
+            const double seconds = std::chrono::duration<double>(end - start).count();
+            if (run == 0 || seconds < best) {
+                best = seconds;
+                bestCycles = cpu.TotalCycles - startCycles;
+            }
+        }
+
+        const double instructions = static_cast<double>(bestCycles) / cyclesPerInstruction;
+        return { best * 1e9 / instructions, cyclesPerInstruction, instructions / best / 1e6,
+                 static_cast<std::uint64_t>(instructions + 0.5) };
+    }
+
+    // ====================================================================
+    // OUTPUT
+    // ====================================================================
+
+    void WriteJson(std::ostream& out, const Options& options,
+                   const std::vector<Case>& cases, const std::vector<Result>& results) {
+        out << "{\n"
+            << "  \"schema\": 1,\n"
+#if defined(__VERSION__)
+            << "  \"compiler\": \"" << __VERSION__ << "\",\n"
+#endif
+            << "  \"computed_goto\": " << (M6502_COMPUTED_GOTO ? "true" : "false") << ",\n"
+            << "  \"trace_compiled_in\": " << (M6502_TRACE ? "true" : "false") << ",\n"
+            << "  \"bcd_tables\": " << (M6502_BCD_TABLES ? "true" : "false") << ",\n"
+            << "  \"cycles_per_run\": " << options.cycles << ",\n"
+            << "  \"repeat\": " << options.repeat << ",\n"
+            << "  \"results\": [\n";
+
+        out << std::fixed;
+        for (std::size_t i = 0; i < cases.size(); i++) {
+            const Case& test = cases[i];
+            const Result& result = results[i];
+            out << "    { \"name\": \"" << test.name << "\", \"group\": \"" << test.group << "\", ";
+            if (test.opcode >= 0) {
+                out << "\"opcode\": \"" << std::hex << std::uppercase << std::setw(2) << std::setfill('0')
+                    << test.opcode << std::dec << std::setfill(' ') << "\", ";
+            }
+            out << std::setprecision(3)
+                << "\"ns_per_instruction\": " << result.nsPerInstruction << ", "
+                << "\"cycles_per_instruction\": " << result.cyclesPerInstruction << ", "
+                << std::setprecision(1)
+                << "\"mips\": " << result.mips << ", "
+                << "\"instructions\": " << result.instructions << " }"
+                << (i + 1 < cases.size() ? "," : "") << "\n";
+        }
+
+        out << "  ]\n}\n";
+    }
+
+    bool ParseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; i++) {
+            const bool hasValue = i + 1 < argc;
+            if (std::strcmp(argv[i], "--cycles") == 0 && hasValue) {
+                options.cycles = std::strtoull(argv[++i], nullptr, 10);
+            } else if (std::strcmp(argv[i], "--repeat") == 0 && hasValue) {
+                options.repeat = std::atoi(argv[++i]);
+            } else if (std::strcmp(argv[i], "--group") == 0 && hasValue) {
+                options.group = argv[++i];
+            } else if (argv[i][0] != '-' && options.output == nullptr) {
+                options.output = argv[i];
+            } else {
+                return false;
+            }
+        }
+        return options.cycles > 0 && options.repeat > 0;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::cerr << "usage: " << argv[0] << " [--cycles N] [--repeat N] [--group G] [output.json]\n";
+        return 2;
+    }
+
+    std::vector<Case> cases;
+    for (std::vector<Case> source : { MicroBenchmarks(), Programs() }) {
+        for (Case& test : source) {
+            if (options.group == nullptr || std::strcmp(test.group, options.group) == 0) {
+                cases.push_back(std::move(test));
+            }
+        }
+    }
+    if (cases.empty()) {
+        std::cerr << "no benchmarks in group '" << options.group << "'\n";
+        return 2;
+    }
+
+    std::vector<Result> results;
+    for (const Case& test : cases) {
+        results.push_back(Measure(test, options));
+        std::cerr << std::left << std::setw(12) << test.group << std::setw(24) << test.name
+                  << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(8) << results.back().nsPerInstruction << " ns\n";
+    }
+
+    if (options.output == nullptr) {
+        WriteJson(std::cout, options, cases, results);
+        return 0;
+    }
+
+    std::ofstream file(options.output);
+    WriteJson(file, options, cases, results);
+    if (!file) {
+        std::cerr << options.output << ": could not be written\n";
+        return 1;
+    }
+    return 0;
+}
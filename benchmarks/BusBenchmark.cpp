@@ -0,0 +1,110 @@
+/**
+ * @file BusBenchmark.cpp
+ * @brief Compares the CPU core instantiated on different bus types
+ *
+ * Runs the same guest programs on:
+ *   - BasicCPU<Memory>     flat 64 KiB array, fully inlined accesses
+ *   - BasicCPU<MemoryBus>  every page mapped to RAM
+ *   - BasicCPU<MemoryBus>  with an I/O page the program talks to
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -I. benchmarks/BusBenchmark.cpp \
+ *       CPU.cpp Instructions.cpp Memory.cpp MemoryBus.cpp -o bus_bench
+ */
+
+#include "CPU.h"
+#include "Memory.h"
+#include "MemoryBus.h"
+#include "Workloads.h"
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+
+using namespace M6502;
+
+namespace {
+
+    constexpr Cycles BUDGET = 200'000'000;
+    constexpr Address DEVICE_BASE = 0xD000;
+
+    /**
+     * @brief Minimal device: a free-running status counter and a data latch
+     */
+    struct CounterDevice {
+        Byte status = 0;
+        Byte data = 0;
+
+        static Byte Read(void* context, Address /* address */) {
+            return static_cast<CounterDevice*>(context)->status++;
+        }
+
+        static void Write(void* context, Address /* address */, Byte value) {
+            static_cast<CounterDevice*>(context)->data = value;
+        }
+    };
+
+    template <typename Bus>
+    double Run(Bus& bus) {
+        BasicCPU<Bus> cpu;
+        cpu.Reset(bus);
+
+        auto start = std::chrono::steady_clock::now();
+        Cycles cycles = cpu.RunFor(BUDGET, bus);
+        auto end = std::chrono::steady_clock::now();
+
+        // Emulated clock rate in MHz
+        return cycles / std::chrono::duration<double>(end - start).count() / 1e6;
+    }
+
+    void Report(const char* name, double mhz) {
+        std::cout << std::left << std::setw(36) << name
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << mhz << " MHz\n";
+    }
+
+} // namespace
+
+int main() {
+    std::cout << "Bus instantiation benchmark (" << BUDGET << " cycles per run)\n";
+
+    std::cout << "\nMixed RAM workload\n";
+    {
+        Memory memory;
+        Benchmarks::LoadMixedWorkload(memory);
+        Report("BasicCPU<Memory>", Run(memory));
+    }
+    {
+        MemoryBus bus;
+        Benchmarks::LoadMixedWorkload(bus);
+        Report("BasicCPU<MemoryBus>, all RAM", Run(bus));
+    }
+    {
+        MemoryBus bus;
+        CounterDevice device;
+        bus.MapIO(DEVICE_BASE >> 8, 1, &CounterDevice::Read, &CounterDevice::Write, &device);
+        Benchmarks::LoadMixedWorkload(bus);
+        Report("BasicCPU<MemoryBus>, idle I/O page", Run(bus));
+    }
+
+    std::cout << "\nDevice workload (one I/O read and write per iteration)\n";
+    {
+        Memory memory;
+        Benchmarks::LoadDeviceWorkload(memory, DEVICE_BASE);
+        Report("BasicCPU<Memory>", Run(memory));
+    }
+    {
+        MemoryBus bus;
+        Benchmarks::LoadDeviceWorkload(bus, DEVICE_BASE);
+        Report("BasicCPU<MemoryBus>, all RAM", Run(bus));
+    }
+    {
+        MemoryBus bus;
+        CounterDevice device;
+        bus.MapIO(DEVICE_BASE >> 8, 1, &CounterDevice::Read, &CounterDevice::Write, &device);
+        Benchmarks::LoadDeviceWorkload(bus, DEVICE_BASE);
+        Report("BasicCPU<MemoryBus>, device mapped", Run(bus));
+    }
+
+    return 0;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file CheckpointBenchmark.cpp
+ * @brief Memory footprint and latency of incremental checkpoints
+ *
+ * Takes 10,000 checkpoints over a long run of each workload and
+ * reports what the chain holds against 10,000 full 64 KiB copies. Then
+ * times the fuzzing pattern (restore the latest checkpoint, run one
+ * interval, repeat) and rewinds to earlier checkpoints, checking each
+ * restored machine against a full snapshot taken at the time.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -I. benchmarks/CheckpointBenchmark.cpp \
+ *       CPU.cpp Instructions.cpp Memory.cpp MemoryBus.cpp Snapshot.cpp \
+ *       Checkpoint.cpp -o checkpoint_bench
+ */
+
+#include "Checkpoint.h"
+#include "CPU.h"
+#include "Memory.h"
+#include "Snapshot.h"
+#include "Workloads.h"
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace M6502;
+
+namespace {
+
+    constexpr std::size_t CHECKPOINTS = 10'000;
+    constexpr Cycles INTERVAL = 20'000;
+    constexpr std::size_t VERIFY_EVERY = 1'000;
+    constexpr int RESTORES = 10'000;
+
+    using Clock = std::chrono::steady_clock;
+
+    double Microseconds(Clock::time_point start, Clock::time_point end) {
+        return std::chrono::duration<double, std::micro>(end - start).count();
+    }
+
+    template <typename LoadFunction>
+    void Run(const char* name, LoadFunction load) {
+        CPU cpu;
+        Memory memory;
+        load(memory);
+        cpu.Reset(memory);
+
+        CheckpointChain chain;
+        std::vector<std::vector<Byte>> references;
+
+        double takeTime = 0;
+        for (std::size_t i = 0; i < CHECKPOINTS; i++) {
+            cpu.RunFor(INTERVAL, memory);
+
+            auto start = Clock::now();
+            chain.Take(cpu, memory);
+            takeTime += Microseconds(start, Clock::now());
+
+            if (i % VERIFY_EVERY == 0) {
+                references.push_back(SaveSnapshot(cpu, memory));
+            }
+        }
+
+        const double full = static_cast<double>(CHECKPOINTS) * MEMORY_SIZE;
+        const double footprint = static_cast<double>(chain.FootprintBytes());
+
+        std::cout << name << "\n" << std::fixed << std::setprecision(2)
+                  << "  stored pages       " << std::setw(12) << chain.StoredPages() << "\n"
+                  << "  chain footprint    " << std::setw(12) << footprint / (1 << 20) << " MiB\n"
+                  << "  full copies        " << std::setw(12) << full / (1 << 20) << " MiB ("
+                  << std::setprecision(1) << full / footprint << "x)\n"
+                  << std::setprecision(2)
+                  << "  take               " << std::setw(12) << takeTime / CHECKPOINTS << " us\n";
+
+        // Fuzzing: restart from the latest checkpoint over and over
+        const std::size_t latest = chain.Count() - 1;
+        double restoreTime = 0;
+        bool same = true;
+        for (int i = 0; i < RESTORES; i++) {
+            cpu.RunFor(INTERVAL, memory);
+
+            auto start = Clock::now();
+            same &= chain.Restore(latest, cpu, memory);
+            restoreTime += Microseconds(start, Clock::now());
+        }
+        std::cout << "  restore latest     " << std::setw(12) << restoreTime / RESTORES << " us\n";
+
+        // Rewind: step back through the verified checkpoints
+        double rewindTime = 0;
+        for (std::size_t k = references.size(); k-- > 0;) {
+            auto start = Clock::now();
+            same &= chain.Restore(k * VERIFY_EVERY, cpu, memory);
+            rewindTime += Microseconds(start, Clock::now());
+
+            same &= SaveSnapshot(cpu, memory) == references[k];
+        }
+        std::cout << "  rewind " << std::setw(4) << VERIFY_EVERY << " back   " << std::setw(12)
+                  << rewindTime / references.size() << " us\n"
+                  << (same ? "" : "  STATE DIFFERS\n") << "\n";
+    }
+
+} // namespace
+
+int main() {
+    std::cout << "Checkpoint benchmark (" << CHECKPOINTS << " checkpoints, one every "
+              << INTERVAL << " cycles)\n\n";
+
+    Run("Mixed workload", Benchmarks::LoadMixedWorkload<Memory>);
+    Run("Self-modifying workload", Benchmarks::LoadSelfModifyingWorkload<Memory>);
+    Run("Page-fill workload (16 pages rewritten per lap)", Benchmarks::LoadPageFillWorkload<Memory>);
+
+    return 0;
+}
@@ -0,0 +1,154 @@
+/**
+ * @file DebuggerBenchmark.cpp
+ * @brief Checks breakpoints and watchpoints, then measures what they cost
+ *
+ * On both bus types, runs the mixed workload into a breakpoint, a
+ * conditional breakpoint, a write watchpoint and a conditional read
+ * watchpoint, checking where each stop lands. Then times the workload
+ * with no debugger, with one attached but nothing enabled, and with a
+ * breakpoint armed on a page the program never executes.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -I. benchmarks/DebuggerBenchmark.cpp CPU.cpp Debugger.cpp \
+ *       Instructions.cpp Memory.cpp MemoryBus.cpp -o debugger_bench
+ */
+
+#include "CPU.h"
+#include "Debugger.h"
+#include "Memory.h"
+#include "MemoryBus.h"
+#include "Workloads.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace M6502;
+
+namespace {
+
+    constexpr Cycles BUDGET = 50'000'000;
+    constexpr Cycles CHECK_BUDGET = 100'000;
+
+    // Addresses in the mixed workload (see Workloads.h)
+    constexpr Address STORE = 0x1008;       // STA $2100,X
+    constexpr Address AFTER_STORE = 0x100B; // EOR #$55
+    constexpr Address UNUSED_CODE = 0x8000;
+
+    using Benchmarks::Check;
+
+    template <typename Bus>
+    void CheckStops(const char* name) {
+        Bus bus;
+        Benchmarks::LoadMixedWorkload(bus);
+        BasicCPU<Bus> cpu;
+        cpu.Reset(bus);
+
+        Debugger debugger;
+        debugger.Attach(cpu, bus);
+        Debugger::Stop stop;
+
+        // Plain breakpoint: stops before the instruction, then resumes past it
+        Debugger::PointId point = debugger.AddBreakpoint(STORE);
+        cpu.RunFor(CHECK_BUDGET, bus);
+        Check(debugger.TakeStop(stop) && stop.reason == Debugger::StopReason::Execute &&
+              stop.point == point && cpu.PC == STORE && cpu.X == 0x00,
+              name, "breakpoint stops before the instruction");
+        cpu.RunFor(CHECK_BUDGET, bus);
+        Check(debugger.TakeStop(stop) && cpu.PC == STORE && cpu.X == 0x01,
+              name, "breakpoint resumes and stops on the next pass");
+        debugger.Remove(point);
+
+        // Conditional breakpoint
+        Condition condition;
+        Check(Condition::Parse("x == $10 && !D", condition), name, "condition parses");
+        point = debugger.AddBreakpoint(STORE, condition);
+        cpu.RunFor(CHECK_BUDGET, bus);
+        Check(debugger.TakeStop(stop) && cpu.PC == STORE && cpu.X == 0x10,
+              name, "conditional breakpoint waits for X == $10");
+        Check(debugger.Find(point)->hits == 1, name, "hit counted once");
+        debugger.Remove(point);
+
+        // Write watchpoint: stops after the storing instruction
+        point = debugger.AddWatchpoint(0x2120, 0x2120, AccessWatcher::WATCH_WRITE);
+        cpu.RunFor(CHECK_BUDGET, bus);
+        Check(debugger.TakeStop(stop) && stop.reason == Debugger::StopReason::Write &&
+              stop.address == 0x2120 && stop.registers.PC == STORE && cpu.PC == AFTER_STORE &&
+              bus.ReadByteNoCycles(0x2120) == stop.value,
+              name, "write watchpoint stops after the store");
+        debugger.Remove(point);
+
+        // Conditional read watchpoint on the table the loop reads
+        Check(Condition::Parse("VALUE == 21", condition), name, "value condition parses");
+        point = debugger.AddWatchpoint(0x2000, 0x20FF, AccessWatcher::WATCH_READ, condition);
+        cpu.RunFor(CHECK_BUDGET, bus);
+        Check(debugger.TakeStop(stop) && stop.reason == Debugger::StopReason::Read &&
+              stop.address == 0x2003 && stop.value == 21,
+              name, "read watchpoint matches the value read");
+
+        // Disabled points cost nothing and never stop
+        debugger.Enable(point, false);
+        Check(!debugger.Armed() && cpu.RunFor(CHECK_BUDGET, bus) >= CHECK_BUDGET &&
+              !debugger.TakeStop(stop),
+              name, "disabled watchpoint lets the batch run");
+
+        Check(!Condition::Parse("A ==", condition) && !Condition::Parse("Q", condition),
+              name, "bad conditions are rejected");
+    }
+
+    enum class Mode { None, Disarmed, Armed };
+
+    template <typename Bus>
+    double Measure(Mode mode) {
+        Bus bus;
+        Benchmarks::LoadMixedWorkload(bus);
+        BasicCPU<Bus> cpu;
+        cpu.Reset(bus);
+
+        Debugger debugger;
+        if (mode != Mode::None) {
+            debugger.Attach(cpu, bus);
+            Debugger::PointId point = debugger.AddBreakpoint(UNUSED_CODE);
+            if (mode == Mode::Disarmed) {
+                debugger.Enable(point, false);
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        Cycles cycles = cpu.RunFor(BUDGET, bus);
+        auto end = std::chrono::steady_clock::now();
+
+        // Emulated clock rate in MHz
+        return cycles / std::chrono::duration<double>(end - start).count() / 1e6;
+    }
+
+    template <typename Bus>
+    void Compare(const char* name) {
+        const double none = Measure<Bus>(Mode::None);
+        const double disarmed = Measure<Bus>(Mode::Disarmed);
+        const double armed = Measure<Bus>(Mode::Armed);
+
+        std::cout << std::left << std::setw(12) << name << std::right << std::fixed
+                  << std::setprecision(1)
+                  << std::setw(10) << none << " MHz"
+                  << std::setw(10) << disarmed << " MHz"
+                  << std::setw(10) << armed << " MHz"
+                  << std::setprecision(2)
+                  << std::setw(8) << none / armed << "x\n";
+    }
+
+} // namespace
+
+int main() {
+    std::cout << "Debugger benchmark (" << BUDGET << " cycles)\n\n";
+
+    CheckStops<Memory>("Memory");
+    CheckStops<MemoryBus>("MemoryBus");
+    std::cout << (Benchmarks::failures == 0 ? "All stop checks passed\n\n" : "\n");
+
+    std::cout << std::setw(26) << "no debugger" << std::setw(14) << "disarmed"
+              << std::setw(14) << "armed" << std::setw(9) << "cost" << "\n";
+    Compare<Memory>("Memory");
+    Compare<MemoryBus>("MemoryBus");
+
+    return Benchmarks::failures == 0 ? 0 : 1;
+}
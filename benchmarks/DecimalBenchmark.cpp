@@ -0,0 +1,199 @@
+/**
+ * @file DecimalBenchmark.cpp
+ * @brief Decimal ADC/SBC tables against the nibble arithmetic
+ *
+ * Checks, for every (A, operand, carry):
+ *   - DecimalAddTable and DecimalSubtractTable against
+ *     ComputeDecimalAdd() and ComputeDecimalSubtract()
+ *   - ADC #imm and SBC #imm on the CPU, as built, against the same
+ *     arithmetic, including that SBC leaves V alone
+ * and exits with status 1 on any mismatch.
+ *
+ * Then times both implementations on chains of dependent operations
+ * (each result is the next accumulator, as in a multi-byte BCD sum):
+ * one with random BCD operands, which spreads lookups over much of the
+ * tables, and one adding the same operand, which keeps them in L1. And
+ * runs the BCD workload on the core this build uses. To compare the two
+ * core builds on every decimal opcode, run benchmark_suite --group
+ * decimal in a tree with M6502_BCD_TABLES on and one with it off, then
+ * compare_benchmarks.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -I. benchmarks/DecimalBenchmark.cpp \
+ *       CPU.cpp Instructions.cpp Memory.cpp MemoryBus.cpp Decimal.cpp \
+ *       -o decimal_bench
+ */
+
+#include "CPU.h"
+#include "Decimal.h"
+#include "Memory.h"
+#include "Workloads.h"
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+using namespace M6502;
+
+namespace {
+
+    constexpr std::size_t OPERATIONS = 50'000'000;
+    constexpr Cycles WORKLOAD_BUDGET = 100'000'000;
+
+    bool Same(const DecimalResult& a, const DecimalResult& b) {
+        return a.result == b.result && a.flags == b.flags;
+    }
+
+    /// Table entries that differ from the arithmetic
+    std::size_t CheckTables() {
+        std::size_t mismatches = 0;
+        for (int carry = 0; carry < 2; carry++) {
+            for (int a = 0; a < 256; a++) {
+                for (int operand = 0; operand < 256; operand++) {
+                    const Byte x = static_cast<Byte>(a);
+                    const Byte y = static_cast<Byte>(operand);
+                    const std::size_t index = DecimalIndex(x, y, carry != 0);
+
+                    if (!Same(DecimalAddTable[index], ComputeDecimalAdd(x, y, carry != 0))) {
+                        mismatches++;
+                    }
+                    if (!Same(DecimalSubtractTable[index], ComputeDecimalSubtract(x, y, carry != 0))) {
+                        mismatches++;
+                    }
+                }
+            }
+        }
+        return mismatches;
+    }
+
+    /**
+     * @brief Inputs for which `opcode` on the CPU disagrees with `compute`
+     *
+     * V starts set, and the flags outside `defined` must come through
+     * unchanged.
+     */
+    std::size_t CheckCore(Byte opcode, DecimalResult (*compute)(Byte, Byte, bool), Byte defined) {
+        Memory memory;
+        CPU cpu;
+        memory[0x0200] = opcode;
+        Benchmarks::SetResetVector(memory, 0x0200);
+        cpu.Reset(memory);
+
+        const Byte preserved = FLAG_OVERFLOW | FLAG_DECIMAL | FLAG_UNUSED;
+        std::size_t mismatches = 0;
+
+        for (int carry = 0; carry < 2; carry++) {
+            for (int a = 0; a < 256; a++) {
+                for (int operand = 0; operand < 256; operand++) {
+                    memory[0x0201] = static_cast<Byte>(operand);
+                    cpu.PC = 0x0200;
+                    cpu.A = static_cast<Byte>(a);
+                    cpu.P = static_cast<Byte>(preserved | (carry ? FLAG_CARRY : 0));
+                    cpu.Execute(memory);
+
+                    const DecimalResult expected =
+                        compute(static_cast<Byte>(a), static_cast<Byte>(operand), carry != 0);
+                    const Byte p = cpu.P;
+                    const Byte expectedP = static_cast<Byte>((preserved & ~defined) | expected.flags);
+
+                    if (cpu.A != expected.result || p != expectedP) {
+                        mismatches++;
+                    }
+                }
+            }
+        }
+        return mismatches;
+    }
+
+    /**
+     * @brief ns per operation over a dependent chain of adds and subtracts
+     */
+    template <typename Add, typename Subtract>
+    double TimeChain(const std::vector<Byte>& operands, Add add, Subtract subtract, std::uint32_t& checksum) {
+        Byte a = 0x00;
+        bool carry = false;
+
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < OPERATIONS; i++) {
+            const Byte operand = operands[i & (operands.size() - 1)];
+            const DecimalResult r = (i & 1) ? subtract(a, operand, carry) : add(a, operand, carry);
+            a = r.result;
+            carry = (r.flags & FLAG_CARRY) != 0;
+            checksum += r.flags;
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        checksum += a;
+        return std::chrono::duration<double, std::nano>(end - start).count() / OPERATIONS;
+    }
+
+    double WorkloadMHz() {
+        Memory memory;
+        CPU cpu;
+        Benchmarks::LoadBcdWorkload(memory);
+        cpu.Reset(memory);
+
+        auto start = std::chrono::steady_clock::now();
+        cpu.RunFor(WORKLOAD_BUDGET, memory);
+        auto end = std::chrono::steady_clock::now();
+        return WORKLOAD_BUDGET / std::chrono::duration<double>(end - start).count() / 1e6;
+    }
+
+} // namespace
+
+int main() {
+    std::cout << "Decimal ADC/SBC: tables against arithmetic\n\n";
+
+    const std::size_t tableMismatches = CheckTables();
+    std::cout << "Tables, " << 2 * DECIMAL_TABLE_SIZE << " entries:    "
+              << (tableMismatches == 0 ? "identical" : "MISMATCH") << "\n";
+
+    const std::size_t coreMismatches =
+        CheckCore(INS_ADC_IM, ComputeDecimalAdd, DECIMAL_ADD_FLAGS) +
+        CheckCore(INS_SBC_IM, ComputeDecimalSubtract, DECIMAL_SUBTRACT_FLAGS);
+    std::cout << "Core (" << (M6502_BCD_TABLES ? "tables" : "arithmetic") << "), "
+              << 2 * DECIMAL_TABLE_SIZE << " inputs: "
+              << (coreMismatches == 0 ? "identical" : "MISMATCH") << "\n";
+
+    if (tableMismatches != 0 || coreMismatches != 0) {
+        std::cout << tableMismatches << " table and " << coreMismatches << " core mismatches\n";
+        return 1;
+    }
+
+    // Valid BCD operands, as decimal-mode code uses; a power-of-two count
+    std::vector<Byte> operands(4096);
+    std::uint32_t seed = 12345;
+    for (Byte& operand : operands) {
+        seed = seed * 1103515245 + 12345;
+        const int value = (seed >> 16) % 100;
+        operand = static_cast<Byte>(((value / 10) << 4) | (value % 10));
+    }
+
+    const std::vector<Byte> constant(operands.size(), 0x01);
+
+    std::cout << "\nDependent chains of " << OPERATIONS << " operations\n" << std::fixed << std::setprecision(2);
+    for (const auto& [name, inputs] : { std::make_pair("random operands", &std::as_const(operands)),
+                                        std::make_pair("same operand", &constant) }) {
+        std::uint32_t computeChecksum = 0;
+        std::uint32_t tableChecksum = 0;
+        const double computeNs = TimeChain(*inputs, ComputeDecimalAdd, ComputeDecimalSubtract, computeChecksum);
+        const double tableNs = TimeChain(
+            *inputs,
+            [](Byte a, Byte operand, bool carry) { return DecimalAddTable[DecimalIndex(a, operand, carry)]; },
+            [](Byte a, Byte operand, bool carry) { return DecimalSubtractTable[DecimalIndex(a, operand, carry)]; },
+            tableChecksum);
+
+        std::cout << "  " << name << "\n"
+                  << "    arithmetic   " << std::setw(6) << computeNs << " ns/op\n"
+                  << "    tables       " << std::setw(6) << tableNs << " ns/op   "
+                  << computeNs / tableNs << "x"
+                  << (computeChecksum == tableChecksum ? "" : "   CHECKSUM DIFFERS") << "\n";
+    }
+
+    std::cout << "\nBCD workload on this build's core (" << (M6502_BCD_TABLES ? "tables" : "arithmetic")
+              << "): " << std::setprecision(1) << WorkloadMHz() << " MHz\n";
+
+    return 0;
+}
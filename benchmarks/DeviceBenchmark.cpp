@@ -0,0 +1,264 @@
+/**
+ * @file DeviceBenchmark.cpp
+ * @brief Lazy, cycle-stamped device synchronization against eager stepping
+ *
+ * The system has four chips: an interval timer at $D000 that interrupts
+ * the guest every TIMER_PERIOD cycles, and three free-running counters
+ * at $D100-$D300 that only a guest looking at them would notice. Two
+ * guests run on it: one polls the timer's counter and writes its data
+ * register every loop iteration, the other sorts and never touches any
+ * chip. Each runs three ways:
+ *   - per cycle        every chip is advanced one cycle at a time after
+ *                      every instruction
+ *   - per instruction  every chip is caught up after every instruction
+ *   - lazy             RunWithDevices(): a chip only runs when the guest
+ *                      touches it or its deadline is due
+ *
+ * All three must end in the same CPU, RAM and chip state.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -I. benchmarks/DeviceBenchmark.cpp \
+ *       CPU.cpp Instructions.cpp Memory.cpp MemoryBus.cpp -o device_bench
+ */
+
+#include "CPU.h"
+#include "Device.h"
+#include "MemoryBus.h"
+#include "Workloads.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace M6502;
+
+namespace {
+
+    using BusCPU = BasicCPU<MemoryBus>;
+
+    constexpr Cycles BUDGET = 20'000'000;
+    constexpr Cycles TIMER_PERIOD = 1000;
+    constexpr Address TIMER_BASE = 0xD000;
+    constexpr int COUNTERS = 3;
+    constexpr Address HANDLER = 0x0F10;
+    constexpr Address INTERRUPT_COUNT = 0x40;
+
+    /**
+     * @brief Down-counter that can raise IRQ on every underflow
+     *
+     *   +0  read: counter, low byte
+     *   +1  write: data latch
+     *   +2  read: bit 7 set if an underflow is pending; reading acknowledges
+     */
+    class IntervalTimer : public Device {
+    public:
+        IntervalTimer(BusCPU& cpu, Cycles period, bool interrupts)
+            : cpu(cpu), period(period), remaining(period), interrupts(interrupts) {}
+
+        Cycles NextDeadline() const override {
+            // Even while IRQ is held: acknowledging it mid-batch must not
+            // move the deadline earlier than the one the batch ran to
+            return interrupts ? SyncedTo() + remaining : NO_DEADLINE;
+        }
+
+        Byte Read(Address address) override {
+            switch (address & 0x03) {
+                case 0:
+                    return static_cast<Byte>(remaining);
+                case 2: {
+                    Byte status = pending ? 0x80 : 0x00;
+                    pending = false;
+                    if (interrupts) {
+                        cpu.SetIRQ(false);
+                    }
+                    return status;
+                }
+                default:
+                    return 0xFF;
+            }
+        }
+
+        void Write(Address address, Byte value) override {
+            if ((address & 0x03) == 1) {
+                latch = value;
+            }
+        }
+
+        bool SameState(const IntervalTimer& other) const {
+            return remaining == other.remaining && pending == other.pending
+                && underflows == other.underflows && latch == other.latch;
+        }
+
+        Cycles Underflows() const { return underflows; }
+
+    protected:
+        void Advance(Cycles from, Cycles to) override {
+            Cycles elapsed = to - from;
+            if (elapsed < remaining) {
+                remaining -= elapsed;
+                return;
+            }
+
+            // Any number of periods in one step
+            elapsed -= remaining;
+            underflows += 1 + elapsed / period;
+            remaining = period - elapsed % period;
+
+            if (!pending) {
+                pending = true;
+                if (interrupts) {
+                    cpu.SetIRQ(true);
+                }
+            }
+        }
+
+    private:
+        BusCPU& cpu;
+        Cycles period;
+        Cycles remaining;
+        Cycles underflows = 0;
+        bool interrupts;
+        bool pending = false;
+        Byte latch = 0;
+    };
+
+    enum class Guest { Polling, Compute };
+
+    struct System {
+        BusCPU cpu;
+        MemoryBus bus;
+        std::vector<IntervalTimer> chips;
+        std::vector<Device*> devices;
+
+        explicit System(Guest guest) {
+            if (guest == Guest::Polling) {
+                Benchmarks::LoadDeviceWorkload(bus, TIMER_BASE);
+            } else {
+                Benchmarks::LoadSortWorkload(bus);
+            }
+
+            // CLI first, then the workload; the handler acknowledges and counts
+            const Byte prologue[] = { INS_CLI, INS_JMP_ABS, 0x00, 0x10 };
+            const Byte handler[] = {
+                INS_PHA,
+                INS_LDA_ABS, (TIMER_BASE + 2) & 0xFF, TIMER_BASE >> 8,
+                INS_INC_ZP,  INTERRUPT_COUNT,
+                INS_PLA,
+                INS_RTI
+            };
+            for (std::size_t i = 0; i < sizeof(prologue); i++) {
+                bus[0x0F00 + i] = prologue[i];
+            }
+            for (std::size_t i = 0; i < sizeof(handler); i++) {
+                bus[HANDLER + i] = handler[i];
+            }
+            Benchmarks::SetResetVector(bus, 0x0F00);
+            bus[VECTOR_IRQ_BRK] = HANDLER & 0xFF;
+            bus[VECTOR_IRQ_BRK + 1] = HANDLER >> 8;
+
+            // Reserved up front: the bus and `devices` keep pointers
+            chips.reserve(1 + COUNTERS);
+            chips.emplace_back(cpu, TIMER_PERIOD, true);
+            for (int i = 1; i <= COUNTERS; i++) {
+                chips.emplace_back(cpu, 256 * i + 1, false);
+            }
+            for (std::size_t i = 0; i < chips.size(); i++) {
+                bus.MapDevice(static_cast<Byte>((TIMER_BASE >> 8) + i), 1, chips[i]);
+                devices.push_back(&chips[i]);
+            }
+
+            bus.SetClock(&cpu.TotalCycles);
+            cpu.Reset(bus);
+        }
+
+        void CatchUpAll(Cycles cycle) {
+            for (IntervalTimer& chip : chips) {
+                chip.CatchUp(cycle);
+            }
+        }
+
+        bool SameState(const System& other) const {
+            for (Address address = 0; address < 0x2200; address++) {
+                if (bus[address] != other.bus[address]) {
+                    return false;
+                }
+            }
+            for (std::size_t i = 0; i < chips.size(); i++) {
+                if (!chips[i].SameState(other.chips[i])) {
+                    return false;
+                }
+            }
+            return cpu.A == other.cpu.A && cpu.X == other.cpu.X && cpu.Y == other.cpu.Y
+                && cpu.SP == other.cpu.SP && static_cast<Byte>(cpu.P) == static_cast<Byte>(other.cpu.P)
+                && cpu.PC == other.cpu.PC && cpu.TotalCycles == other.cpu.TotalCycles;
+        }
+    };
+
+    template <typename RunFunction>
+    double Measure(System& system, RunFunction run) {
+        auto start = std::chrono::steady_clock::now();
+        run(system);
+        auto end = std::chrono::steady_clock::now();
+
+        // Bring every chip level with the CPU so the states compare
+        system.CatchUpAll(system.cpu.TotalCycles);
+        return std::chrono::duration<double>(end - start).count();
+    }
+
+    void Report(const char* name, double seconds, double baseline, bool same) {
+        std::cout << std::left << std::setw(20) << name << std::right << std::fixed
+                  << std::setprecision(1)
+                  << std::setw(10) << BUDGET / seconds / 1e6 << " MHz"
+                  << std::setprecision(2)
+                  << std::setw(8) << baseline / seconds << "x"
+                  << (same ? "" : "   STATE DIFFERS") << "\n";
+    }
+
+    void RunGuest(Guest guest, const char* title) {
+        std::cout << title << "\n";
+
+        System perCycle(guest);
+        const double cycleSeconds = Measure(perCycle, [](System& system) {
+            const Cycles end = system.cpu.TotalCycles + BUDGET;
+            while (system.cpu.TotalCycles < end) {
+                const Cycles from = system.cpu.TotalCycles;
+                system.cpu.Execute(system.bus);
+                for (Cycles cycle = from + 1; cycle <= system.cpu.TotalCycles; cycle++) {
+                    system.CatchUpAll(cycle);
+                }
+            }
+        });
+        Report("  per cycle", cycleSeconds, cycleSeconds, true);
+
+        System perInstruction(guest);
+        const double instructionSeconds = Measure(perInstruction, [](System& system) {
+            const Cycles end = system.cpu.TotalCycles + BUDGET;
+            while (system.cpu.TotalCycles < end) {
+                system.cpu.Execute(system.bus);
+                system.CatchUpAll(system.cpu.TotalCycles);
+            }
+        });
+        Report("  per instruction", instructionSeconds, cycleSeconds, perInstruction.SameState(perCycle));
+
+        System lazy(guest);
+        const double lazySeconds = Measure(lazy, [](System& system) {
+            RunWithDevices(system.cpu, system.bus, BUDGET, system.devices);
+        });
+        Report("  lazy", lazySeconds, cycleSeconds, lazy.SameState(perCycle));
+
+        std::cout << "  " << lazy.chips[0].Underflows() << " timer underflows, "
+                  << static_cast<int>(lazy.bus[INTERRUPT_COUNT]) << " (mod 256) interrupts taken\n\n";
+    }
+
+} // namespace
+
+int main() {
+    std::cout << "Device synchronization benchmark (" << BUDGET << " cycles, "
+              << 1 + COUNTERS << " chips, IRQ every " << TIMER_PERIOD << ")\n\n"
+              << std::setw(40) << "speedup" << "\n";
+
+    RunGuest(Guest::Polling, "Guest polls the timer");
+    RunGuest(Guest::Compute, "Guest sorts, timer only interrupts");
+
+    return 0;
+}
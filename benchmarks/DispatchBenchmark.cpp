@@ -0,0 +1,96 @@
+/**
+ * @file DispatchBenchmark.cpp
+ * @brief Instructions per second for each opcode dispatch strategy
+ *
+ * Runs the same guest loop through:
+ *   - the handler table, one Execute(Memory&) call per instruction
+ *   - the handler table, batched through RunFor()
+ *   - the handler table, batched through RunUntil() with a PC breakpoint
+ *   - the computed-goto interpreter (GCC/Clang only)
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -I. benchmarks/DispatchBenchmark.cpp \
+ *       CPU.cpp Instructions.cpp Memory.cpp MemoryBus.cpp -o dispatch_bench
+ */
+
+#include "CPU.h"
+#include "Memory.h"
+#include "Workloads.h"
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+
+using namespace M6502;
+
+namespace {
+
+    constexpr std::uint64_t INSTRUCTIONS = 50'000'000;
+
+    struct Result {
+        double seconds;
+        Cycles cycles;
+    };
+
+    template <typename RunFunction>
+    Result Measure(RunFunction run) {
+        CPU cpu;
+        Memory memory;
+        Benchmarks::LoadMixedWorkload(memory);
+        cpu.Reset(memory);
+
+        Cycles startCycles = cpu.TotalCycles;
+        auto start = std::chrono::steady_clock::now();
+        run(cpu, memory);
+        auto end = std::chrono::steady_clock::now();
+
+        return { std::chrono::duration<double>(end - start).count(),
+                 cpu.TotalCycles - startCycles };
+    }
+
+    void Report(const char* name, double instructions, const Result& result) {
+        std::cout << std::left << std::setw(28) << name
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << instructions / result.seconds / 1e6 << " MIPS"
+                  << std::setw(10) << result.seconds * 1e3 << " ms\n";
+    }
+
+} // namespace
+
+int main() {
+    std::cout << "Dispatch strategy benchmark (" << INSTRUCTIONS << " instructions)\n\n";
+
+    // Reference run: exact instruction count, gives cycles per instruction
+    Result step = Measure([](CPU& cpu, Memory& memory) {
+        for (std::uint64_t i = 0; i < INSTRUCTIONS; i++) {
+            cpu.Execute(memory);
+        }
+    });
+    const double cyclesPerInstruction =
+        static_cast<double>(step.cycles) / static_cast<double>(INSTRUCTIONS);
+    const Cycles budget = step.cycles;
+
+    Report("table, single step", static_cast<double>(INSTRUCTIONS), step);
+
+    Result batched = Measure([budget](CPU& cpu, Memory& memory) {
+        cpu.RunFor(budget, memory);
+    });
+    Report("table, RunFor", batched.cycles / cyclesPerInstruction, batched);
+
+    Result until = Measure([budget](CPU& cpu, Memory& memory) {
+        // Breakpoint that never hits: measures the cost of the check
+        cpu.RunUntil(memory, budget, [](const CPU& core) { return core.PC == 0xFFF0; });
+    });
+    Report("table, RunUntil", until.cycles / cyclesPerInstruction, until);
+
+#if M6502_HAS_COMPUTED_GOTO
+    Result threaded = Measure([budget](CPU& cpu, Memory& memory) {
+        cpu.ExecuteThreaded(budget, memory);
+    });
+    Report("computed goto", threaded.cycles / cyclesPerInstruction, threaded);
+#else
+    std::cout << "computed goto               not supported by this compiler\n";
+#endif
+
+    return 0;
+}
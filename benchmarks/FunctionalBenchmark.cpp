@@ -0,0 +1,105 @@
+/**
+ * @file FunctionalBenchmark.cpp
+ * @brief Speedup of the functional (no cycle bookkeeping) core
+ *
+ * Runs the same number of instructions of the mixed workload on CPU and
+ * FunctionalCPU, through the table loop, computed goto and the block
+ * cache, and checks that both finish in the same architectural state.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -I. benchmarks/FunctionalBenchmark.cpp \
+ *       CPU.cpp Instructions.cpp Memory.cpp MemoryBus.cpp -o functional_bench
+ */
+
+#include "BlockCache.h"
+#include "CPU.h"
+#include "Memory.h"
+#include "Workloads.h"
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+
+using namespace M6502;
+
+namespace {
+
+    constexpr std::uint64_t INSTRUCTIONS = 100'000'000;
+
+    struct Result {
+        double seconds;
+        Byte a, x, y, p;
+        Word pc;
+
+        bool SameState(const Result& other) const {
+            return a == other.a && x == other.x && y == other.y && p == other.p && pc == other.pc;
+        }
+    };
+
+    template <typename Core, typename RunFunction>
+    Result Measure(RunFunction run) {
+        Core cpu;
+        Memory memory;
+        Benchmarks::LoadMixedWorkload(memory);
+        cpu.Reset(memory);
+
+        auto start = std::chrono::steady_clock::now();
+        run(cpu, memory);
+        auto end = std::chrono::steady_clock::now();
+
+        return { std::chrono::duration<double>(end - start).count(),
+                 cpu.A, cpu.X, cpu.Y, static_cast<Byte>(cpu.P), cpu.PC };
+    }
+
+    void Report(const char* name, const Result& accurate, const Result& functional) {
+        const double instructions = static_cast<double>(INSTRUCTIONS);
+        std::cout << std::left << std::setw(18) << name << std::right << std::fixed
+                  << std::setprecision(1)
+                  << std::setw(10) << instructions / accurate.seconds / 1e6 << " MIPS"
+                  << std::setw(10) << instructions / functional.seconds / 1e6 << " MIPS"
+                  << std::setprecision(2)
+                  << std::setw(8) << accurate.seconds / functional.seconds << "x"
+                  << (accurate.SameState(functional) ? "" : "   STATE DIFFERS") << "\n";
+    }
+
+} // namespace
+
+int main() {
+    std::cout << "Functional core benchmark (" << INSTRUCTIONS << " instructions)\n\n"
+              << std::setw(28) << "accurate" << std::setw(15) << "functional"
+              << std::setw(9) << "speedup" << "\n";
+
+    // Cycle budget that covers exactly INSTRUCTIONS on the accurate core
+    Cycles budget = 0;
+    Measure<CPU>([&budget](CPU& cpu, Memory& memory) {
+        for (std::uint64_t i = 0; i < INSTRUCTIONS; i++) {
+            budget += cpu.Execute(memory);
+        }
+    });
+
+    Report("table, RunFor",
+        Measure<CPU>([budget](CPU& cpu, Memory& memory) { cpu.RunFor(budget, memory); }),
+        Measure<FunctionalCPU>([](FunctionalCPU& cpu, Memory& memory) {
+            cpu.RunFor(INSTRUCTIONS, memory);
+        }));
+
+#if M6502_HAS_COMPUTED_GOTO
+    Report("computed goto",
+        Measure<CPU>([budget](CPU& cpu, Memory& memory) { cpu.ExecuteThreaded(budget, memory); }),
+        Measure<FunctionalCPU>([](FunctionalCPU& cpu, Memory& memory) {
+            cpu.ExecuteThreaded(INSTRUCTIONS, memory);
+        }));
+#endif
+
+    Report("block cache",
+        Measure<CPU>([budget](CPU& cpu, Memory& memory) {
+            BlockCache<Memory> blocks(memory);
+            cpu.RunFor(budget, memory, blocks);
+        }),
+        Measure<FunctionalCPU>([](FunctionalCPU& cpu, Memory& memory) {
+            BlockCache<Memory, Functional> blocks(memory);
+            cpu.RunFor(INSTRUCTIONS, memory, blocks);
+        }));
+
+    return 0;
+}
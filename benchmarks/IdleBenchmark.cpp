@@ -0,0 +1,235 @@
+/**
+ * @file IdleBenchmark.cpp
+ * @brief Scheduler::RunFor() with idle-loop skipping against running every pass
+ *
+ * Firmwares, most of which spend their time waiting:
+ *   - poll RAM   LDA flag / BEQ spins until a periodic event sets the
+ *                flag, then acknowledges it and does a little work. A
+ *                second event pulses NMI, whose handler counts into RAM
+ *                from the middle of the spin.
+ *   - self-jump  CLI then JMP *, woken only by the NMI pulses
+ *   - deadline   the self-jump again, next to a device whose
+ *                NextDeadline() falls a quarter of the way in: nothing
+ *                may be skipped past it
+ *   - poll I/O   LDA/BEQ on a device register whose value changes with
+ *                the cycle count: never idle, so nothing may be skipped
+ *   - busy       INX/INY/BNE, never waiting: the cost of looking for
+ *                idle loops that are not there
+ *
+ * Each runs in RUNS slices with skipping off and on, and both must end
+ * with the same RAM, registers, TotalCycles and event counts after
+ * every slice.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -I. benchmarks/IdleBenchmark.cpp CPU.cpp \
+ *       IdleLoop.cpp Instructions.cpp Memory.cpp MemoryBus.cpp Scheduler.cpp \
+ *       -o idle_bench
+ */
+
+#include "CPU.h"
+#include "Device.h"
+#include "MemoryBus.h"
+#include "Scheduler.h"
+#include "Workloads.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+
+using namespace M6502;
+
+namespace {
+
+    using BusCPU = BasicCPU<MemoryBus>;
+
+    constexpr Cycles BUDGET = 200'000'000;
+    constexpr int RUNS = 10;
+    constexpr Cycles FLAG_PERIOD = 10'007;
+    constexpr Cycles NMI_PERIOD = 33'331;
+    constexpr Address ENTRY = 0x0400;
+    constexpr Address HANDLER = 0x0500;
+    constexpr Address FLAG = 0x10;
+    constexpr Address WORK_COUNT = 0x20;
+    constexpr Address NMI_COUNT = 0x21;
+    constexpr Address STATUS = 0xD000;
+
+    using Benchmarks::Check;
+
+    /**
+     * @brief Reads as 1 for the first quarter of every 4096 cycles, else 0
+     */
+    class Status : public Device {
+    public:
+        Cycles deadline = NO_DEADLINE;
+
+        Cycles NextDeadline() const override { return deadline; }
+        Byte Read(Address /* address */) override { return (SyncedTo() & 0xC00) == 0 ? 1 : 0; }
+        void Write(Address /* address */, Byte /* value */) override {}
+
+    protected:
+        void Advance(Cycles /* from */, Cycles /* to */) override {}
+    };
+
+    enum class Firmware { PollRAM, SelfJump, DeviceDeadline, PollIO, Busy };
+
+    struct System {
+        BusCPU cpu;
+        MemoryBus bus;
+        Scheduler scheduler;
+        Status status;
+        Event flagEvent;
+        Event nmiEvent;
+        Cycles flags = 0;
+        Cycles nmis = 0;
+
+        System(Firmware firmware, bool skip)
+            : scheduler(2), flagEvent(&System::SetFlag, this), nmiEvent(&System::PulseNMI, this) {
+            // Work done on each flag: acknowledge, count, spin X down
+            static const Byte POLL_RAM[] = {
+                INS_LDA_ZP, FLAG, INS_BEQ, 0xFC,
+                INS_LDA_IM, 0x00, INS_STA_ZP, FLAG,
+                INS_INC_ZP, WORK_COUNT,
+                INS_LDX_IM, 40, INS_DEX, INS_BNE, 0xFD,
+                INS_JMP_ABS, ENTRY & 0xFF, ENTRY >> 8
+            };
+            static const Byte SELF_JUMP[] = {
+                INS_CLI, INS_JMP_ABS, (ENTRY + 1) & 0xFF, (ENTRY + 1) >> 8
+            };
+            static const Byte POLL_IO[] = {
+                INS_LDA_ABS, STATUS & 0xFF, STATUS >> 8, INS_BEQ, 0xFB,
+                INS_INC_ZP, WORK_COUNT,
+                INS_LDA_ABS, STATUS & 0xFF, STATUS >> 8, INS_BNE, 0xFB,
+                INS_JMP_ABS, ENTRY & 0xFF, ENTRY >> 8
+            };
+            static const Byte BUSY[] = {
+                INS_INX, INS_INY, INS_BNE, 0xFC,
+                INS_JMP_ABS, ENTRY & 0xFF, ENTRY >> 8
+            };
+            static const Byte HANDLER_CODE[] = { INS_INC_ZP, NMI_COUNT, INS_RTI };
+
+            struct Image { const Byte* code; std::size_t size; };
+            const Image IMAGES[] = {
+                { POLL_RAM, sizeof(POLL_RAM) }, { SELF_JUMP, sizeof(SELF_JUMP) },
+                { SELF_JUMP, sizeof(SELF_JUMP) }, { POLL_IO, sizeof(POLL_IO) }, { BUSY, sizeof(BUSY) }
+            };
+            const Byte* code = IMAGES[static_cast<int>(firmware)].code;
+            const std::size_t size = IMAGES[static_cast<int>(firmware)].size;
+            for (std::size_t i = 0; i < size; i++) {
+                bus[ENTRY + i] = code[i];
+            }
+            for (std::size_t i = 0; i < sizeof(HANDLER_CODE); i++) {
+                bus[HANDLER + i] = HANDLER_CODE[i];
+            }
+            bus[VECTOR_RESET] = ENTRY & 0xFF;
+            bus[VECTOR_RESET + 1] = ENTRY >> 8;
+            bus[VECTOR_NMI] = HANDLER & 0xFF;
+            bus[VECTOR_NMI + 1] = HANDLER >> 8;
+
+            bus.MapDevice(STATUS >> 8, 1, status);
+            bus.SetClock(&cpu.TotalCycles);
+            cpu.Reset(bus);
+
+            scheduler.SetIdleSkip(skip);
+            if (firmware == Firmware::PollRAM) {
+                scheduler.Schedule(flagEvent, cpu.TotalCycles + FLAG_PERIOD);
+            }
+            if (firmware == Firmware::PollRAM || firmware == Firmware::SelfJump ||
+                firmware == Firmware::DeviceDeadline) {
+                scheduler.Schedule(nmiEvent, cpu.TotalCycles + NMI_PERIOD);
+            }
+            if (firmware == Firmware::DeviceDeadline) {
+                status.deadline = cpu.TotalCycles + BUDGET / 4;
+            }
+        }
+
+        static void SetFlag(void* context, Cycles deadline) {
+            System* system = static_cast<System*>(context);
+            system->bus[FLAG] = 1;
+            system->flags++;
+            system->scheduler.Schedule(system->flagEvent, deadline + FLAG_PERIOD);
+        }
+
+        static void PulseNMI(void* context, Cycles deadline) {
+            System* system = static_cast<System*>(context);
+            system->cpu.SetNMI(true);
+            system->cpu.SetNMI(false);
+            system->nmis++;
+            system->scheduler.Schedule(system->nmiEvent, deadline + NMI_PERIOD);
+        }
+
+        bool SameState(const System& other) const {
+            for (Address address = 0; address < 0x0600; address++) {
+                if (bus[address] != other.bus[address]) {
+                    return false;
+                }
+            }
+            return flags == other.flags && nmis == other.nmis
+                && cpu.A == other.cpu.A && cpu.X == other.cpu.X && cpu.Y == other.cpu.Y
+                && cpu.SP == other.cpu.SP && static_cast<Byte>(cpu.P) == static_cast<Byte>(other.cpu.P)
+                && cpu.PC == other.cpu.PC && cpu.TotalCycles == other.cpu.TotalCycles;
+        }
+    };
+
+    void Run(const char* name, Firmware firmware) {
+        // Tens of KiB each, so not on the stack
+        auto plain = std::make_unique<System>(firmware, false);
+        auto skipping = std::make_unique<System>(firmware, true);
+
+        double plainSeconds = 0;
+        double skipSeconds = 0;
+        bool same = true;
+        for (int i = 0; i < RUNS; i++) {
+            auto start = std::chrono::steady_clock::now();
+            plain->scheduler.RunFor(plain->cpu, plain->bus, BUDGET / RUNS);
+            auto middle = std::chrono::steady_clock::now();
+            skipping->scheduler.RunFor(skipping->cpu, skipping->bus, BUDGET / RUNS);
+            auto end = std::chrono::steady_clock::now();
+
+            plainSeconds += std::chrono::duration<double>(middle - start).count();
+            skipSeconds += std::chrono::duration<double>(end - middle).count();
+            same &= skipping->SameState(*plain);
+        }
+
+        const double skipped = 100.0 * skipping->scheduler.IdleCyclesSkipped() / BUDGET;
+        std::cout << std::left << std::setw(12) << name << std::right << std::fixed
+                  << std::setprecision(1)
+                  << std::setw(10) << BUDGET / plainSeconds / 1e6 << " MHz"
+                  << std::setw(10) << BUDGET / skipSeconds / 1e6 << " MHz"
+                  << std::setw(9) << skipped << "%"
+                  << std::setprecision(2)
+                  << std::setw(9) << plainSeconds / skipSeconds << "x"
+                  << (same ? "" : "   STATE DIFFERS") << "\n";
+
+        Check(same, "skipping ends every run in the same state");
+        if (firmware == Firmware::PollIO) {
+            Check(skipping->scheduler.IdleCyclesSkipped() == 0, "a loop reading I/O is never skipped");
+        } else if (firmware == Firmware::Busy) {
+            Check(skipping->scheduler.IdleCyclesSkipped() == 0, "a loop that never repeats is never skipped");
+        } else {
+            Check(skipping->scheduler.IdleCyclesSkipped() > 0, "the idle loop is skipped");
+            if (firmware == Firmware::DeviceDeadline) {
+                // Never caught up, so the deadline stays pending for good
+                Check(skipping->scheduler.IdleCyclesSkipped() < BUDGET / 4,
+                      "nothing is skipped past a device deadline");
+            }
+            Check(skipping->nmis > 0 && skipping->bus[NMI_COUNT] == static_cast<Byte>(skipping->nmis),
+                  "every NMI is taken");
+        }
+    }
+
+} // namespace
+
+int main() {
+    std::cout << "Idle-loop skipping benchmark (" << BUDGET << " cycles in " << RUNS
+              << " runs)\n\n" << std::setw(26) << "plain" << std::setw(14) << "skipping"
+              << std::setw(10) << "skipped" << std::setw(10) << "speedup" << "\n";
+
+    Run("poll RAM", Firmware::PollRAM);
+    Run("self-jump", Firmware::SelfJump);
+    Run("deadline", Firmware::DeviceDeadline);
+    Run("poll I/O", Firmware::PollIO);
+    Run("busy", Firmware::Busy);
+
+    std::cout << (Benchmarks::failures == 0 ? "\nAll idle-loop checks passed\n" : "\n");
+    return Benchmarks::failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,252 @@
+/**
+ * @file LoaderBenchmark.cpp
+ * @brief Load time of program images in every format
+ *
+ * Writes the same two-segment program (40 KiB) as a segment image,
+ * Intel HEX and S-records, and its first segment as a raw binary. Each
+ * file is loaded with LoadProgramFile() and from a buffer, checked
+ * against the program written byte by byte through operator[], and
+ * timed against that byte-by-byte copy. Then checks that malformed
+ * images are rejected.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -I. benchmarks/LoaderBenchmark.cpp Loader.cpp Memory.cpp \
+ *       -o loader_bench
+ */
+
+#include "Loader.h"
+#include "Memory.h"
+#include "Workloads.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace M6502;
+
+namespace {
+
+    constexpr int REPEATS = 2000;
+    constexpr Address ENTRY = 0x0400;
+    constexpr std::size_t RECORD_BYTES = 32;
+
+    using Benchmarks::Check;
+
+    template <typename Function>
+    double MicrosecondsPer(Function function) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < REPEATS; i++) {
+            function();
+        }
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::micro>(end - start).count() / REPEATS;
+    }
+
+    // ====================================================================
+    // WRITING THE IMAGES
+    // ====================================================================
+
+    void AppendHex(std::string& text, Byte value) {
+        static const char DIGITS[] = "0123456789ABCDEF";
+        text += DIGITS[value >> 4];
+        text += DIGITS[value & 0x0F];
+    }
+
+    std::string ToIntelHex(const std::vector<ImageSegment>& segments, Address entry) {
+        std::string text;
+        auto record = [&](Byte type, Address address, const Byte* data, std::size_t count) {
+            Byte sum = static_cast<Byte>(count + (address >> 8) + (address & 0xFF) + type);
+            text += ':';
+            AppendHex(text, static_cast<Byte>(count));
+            AppendHex(text, static_cast<Byte>(address >> 8));
+            AppendHex(text, static_cast<Byte>(address & 0xFF));
+            AppendHex(text, type);
+            for (std::size_t i = 0; i < count; i++) {
+                AppendHex(text, data[i]);
+                sum += data[i];
+            }
+            AppendHex(text, static_cast<Byte>(-sum));
+            text += "\r\n";
+        };
+
+        for (const ImageSegment& segment : segments) {
+            for (std::size_t done = 0; done < segment.size; done += RECORD_BYTES) {
+                record(0x00, static_cast<Address>(segment.address + done), segment.data + done,
+                       std::min(RECORD_BYTES, segment.size - done));
+            }
+        }
+        const Byte start[4] = { 0, 0, static_cast<Byte>(entry >> 8), static_cast<Byte>(entry & 0xFF) };
+        record(0x05, 0, start, 4);
+        record(0x01, 0, nullptr, 0);
+        return text;
+    }
+
+    std::string ToSRecord(const std::vector<ImageSegment>& segments, Address entry) {
+        std::string text;
+        auto record = [&](char type, Address address, const Byte* data, std::size_t count) {
+            Byte sum = static_cast<Byte>(count + 3 + (address >> 8) + (address & 0xFF));
+            text += 'S';
+            text += type;
+            AppendHex(text, static_cast<Byte>(count + 3));
+            AppendHex(text, static_cast<Byte>(address >> 8));
+            AppendHex(text, static_cast<Byte>(address & 0xFF));
+            for (std::size_t i = 0; i < count; i++) {
+                AppendHex(text, data[i]);
+                sum += data[i];
+            }
+            AppendHex(text, static_cast<Byte>(~sum));
+            text += '\n';
+        };
+
+        const Byte header[] = { 'b', 'e', 'n', 'c', 'h' };
+        record('0', 0, header, sizeof(header));
+        for (const ImageSegment& segment : segments) {
+            for (std::size_t done = 0; done < segment.size; done += RECORD_BYTES) {
+                record('1', static_cast<Address>(segment.address + done), segment.data + done,
+                       std::min(RECORD_BYTES, segment.size - done));
+            }
+        }
+        record('9', entry, nullptr, 0);
+        return text;
+    }
+
+    bool WriteFile(const char* path, const void* data, std::size_t size) {
+        std::FILE* file = std::fopen(path, "wb");
+        if (file == nullptr) {
+            return false;
+        }
+        bool written = std::fwrite(data, 1, size, file) == size;
+        return std::fclose(file) == 0 && written;
+    }
+
+    bool SameMemory(const Memory& a, const Memory& b) {
+        for (std::size_t page = 0; page < Memory::PAGE_COUNT; page++) {
+            if (std::memcmp(a.PageData(static_cast<Byte>(page)),
+                            b.PageData(static_cast<Byte>(page)), Memory::PAGE_SIZE) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // ====================================================================
+    // LOADING
+    // ====================================================================
+
+    void Run(const char* name, const char* path, const std::vector<Byte>& image,
+             const LoadOptions& options, ImageFormat format, const Memory& expected,
+             double byteByByte) {
+        if (!WriteFile(path, image.data(), image.size())) {
+            Check(false, path, "cannot write the image");
+            return;
+        }
+
+        Memory memory;
+        ImageInfo info;
+        bool loaded = true;
+        const double file = MicrosecondsPer([&] {
+            loaded &= LoadProgramFile(path, memory, options, info);
+        });
+        Check(loaded && info.format == format && SameMemory(memory, expected),
+              "file loads the expected memory");
+        Check(format == ImageFormat::Raw || (info.hasEntry && info.entry == ENTRY),
+              "entry point found");
+
+        const double buffer = MicrosecondsPer([&] {
+            loaded &= LoadProgramImage(memory, image.data(), image.size(), options, info);
+        });
+        Check(loaded && SameMemory(memory, expected), "buffer loads the expected memory");
+
+        std::cout << std::left << std::setw(12) << name << std::right << std::fixed
+                  << std::setw(10) << image.size() << " bytes"
+                  << std::setprecision(2)
+                  << std::setw(10) << file << " us"
+                  << std::setw(10) << buffer << " us"
+                  << std::setprecision(1)
+                  << std::setw(8) << byteByByte / file << "x\n";
+        std::remove(path);
+    }
+
+} // namespace
+
+int main() {
+    std::cout << "Loader benchmark (" << REPEATS << " loads each)\n\n";
+
+    // Two segments of pseudo-random bytes, 40 KiB in all
+    std::vector<Byte> low(0x8000 - ENTRY), high(0x2000);
+    std::uint32_t seed = 12345;
+    for (auto* block : { &low, &high }) {
+        for (Byte& value : *block) {
+            seed = seed * 1103515245 + 12345;
+            value = static_cast<Byte>(seed >> 16);
+        }
+    }
+    const std::vector<ImageSegment> segments = {
+        { ENTRY, low.data(), low.size() },
+        { 0xC000, high.data(), high.size() }
+    };
+
+    // What main.cpp would do: one operator[] write per byte
+    Memory expected;
+    const double byteByByte = MicrosecondsPer([&] {
+        for (const ImageSegment& segment : segments) {
+            for (std::size_t i = 0; i < segment.size; i++) {
+                expected[static_cast<Address>(segment.address + i)] = segment.data[i];
+            }
+        }
+    });
+    Memory withVector = expected;
+    withVector[VECTOR_RESET] = ENTRY & 0xFF;
+    withVector[VECTOR_RESET + 1] = ENTRY >> 8;
+    Memory rawExpected;
+    rawExpected.LoadProgram(ENTRY, low.data(), low.size());
+
+    std::cout << std::setw(40) << "file" << std::setw(13) << "buffer"
+              << std::setw(14) << "vs bytes" << "\n";
+
+    LoadOptions options;
+    options.setResetVector = true;
+    ImageVectors vectors;
+    vectors.present = ImageVectors::RESET;
+    vectors.reset = ENTRY;
+    Run("Segments", "loader_bench.seg", SaveSegmentImage(segments, vectors), options,
+        ImageFormat::Segments, withVector, byteByByte);
+
+    const std::string hex = ToIntelHex(segments, ENTRY);
+    Run("Intel HEX", "loader_bench.hex", std::vector<Byte>(hex.begin(), hex.end()), options,
+        ImageFormat::IntelHex, withVector, byteByByte);
+
+    const std::string srec = ToSRecord(segments, ENTRY);
+    Run("S-record", "loader_bench.s19", std::vector<Byte>(srec.begin(), srec.end()), options,
+        ImageFormat::SRecord, withVector, byteByByte);
+
+    LoadOptions raw;
+    raw.format = ImageFormat::Raw;
+    raw.base = ENTRY;
+    Run("Raw", "loader_bench.bin", low, raw, ImageFormat::Raw, rawExpected, byteByByte);
+
+    // Malformed images are rejected
+    Memory memory;
+    ImageInfo info;
+    std::string bad = hex;
+    bad[9] = bad[9] == '0' ? '1' : '0';     // First data digit
+    Check(!LoadProgramImage(memory, reinterpret_cast<const Byte*>(bad.data()), bad.size(),
+                            LoadOptions(), info), "bad HEX checksum rejected");
+    bad = srec;
+    bad[bad.size() - 2] = bad[bad.size() - 2] == '0' ? '1' : '0';
+    Check(!LoadProgramImage(memory, reinterpret_cast<const Byte*>(bad.data()), bad.size(),
+                            LoadOptions(), info), "bad S-record checksum rejected");
+    raw.base = 0xF000;
+    Check(!LoadProgramImage(memory, low.data(), low.size(), raw, info), "raw past $FFFF rejected");
+    const char* beyond = ":020000040001F9\n:01000000AA55\n";
+    Check(!LoadProgramImage(memory, reinterpret_cast<const Byte*>(beyond), std::strlen(beyond),
+                            LoadOptions(), info), "HEX above $FFFF rejected");
+
+    std::cout << (Benchmarks::failures == 0 ? "\nAll loader checks passed\n" : "\n");
+    return Benchmarks::failures == 0 ? 0 : 1;
+}
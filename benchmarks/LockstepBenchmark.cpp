@@ -0,0 +1,108 @@
+/**
+ * @file LockstepBenchmark.cpp
+ * @brief LockstepCPU against the same number of scalar CPUs run one by one
+ *
+ * Each lane gets the same program with its own data table, as in an
+ * input sweep. Reports aggregate emulated MHz for LANES scalar CPUs and
+ * for one LockstepCPU, the share of lane-instructions that ran
+ * vectorised, and checks every lane against its scalar twin.
+ *
+ * Build from the repository root (add -mavx2 for 32 lanes):
+ *   g++ -std=c++17 -O2 -I. benchmarks/LockstepBenchmark.cpp \
+ *       CPU.cpp Instructions.cpp Memory.cpp MemoryBus.cpp LockstepCPU.cpp \
+ *       Snapshot.cpp -o lockstep_bench
+ */
+
+#include "CPU.h"
+#include "LockstepCPU.h"
+#include "Memory.h"
+#include "Workloads.h"
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace M6502;
+
+#if M6502_HAS_LOCKSTEP
+
+namespace {
+
+    constexpr Cycles BUDGET = 10'000'000;
+
+    template <typename LoadFunction>
+    void Run(const char* name, LoadFunction load) {
+        constexpr std::size_t LANES = LockstepCPU::LANES;
+
+        // Same program everywhere; the table at $2000 differs per lane
+        std::vector<Memory> memories(LANES);
+        LockstepCPU lockstep;
+        for (std::size_t lane = 0; lane < LANES; lane++) {
+            load(memories[lane]);
+            for (int i = 0; i < 0x100; i++) {
+                memories[lane][0x2000 + i] = static_cast<Byte>(i * 13 + lane * 7);
+            }
+            lockstep.LaneMemory(lane) = memories[lane];
+        }
+
+        std::vector<CPU> cpus(LANES);
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t lane = 0; lane < LANES; lane++) {
+            cpus[lane].Reset(memories[lane]);
+            cpus[lane].RunFor(BUDGET, memories[lane]);
+        }
+        auto middle = std::chrono::steady_clock::now();
+        lockstep.Reset();
+        lockstep.RunFor(BUDGET);
+        auto end = std::chrono::steady_clock::now();
+
+        bool same = true;
+        for (std::size_t lane = 0; lane < LANES; lane++) {
+            const CPU& cpu = cpus[lane];
+            same &= lockstep.A[lane] == cpu.A && lockstep.X[lane] == cpu.X &&
+                    lockstep.Y[lane] == cpu.Y && lockstep.SP[lane] == cpu.SP &&
+                    lockstep.P[lane] == static_cast<Byte>(cpu.P) && lockstep.PC[lane] == cpu.PC &&
+                    lockstep.TotalCycles[lane] == cpu.TotalCycles;
+        }
+
+        const double cycles = static_cast<double>(BUDGET) * LANES;
+        const double scalarSeconds = std::chrono::duration<double>(middle - start).count();
+        const double lockstepSeconds = std::chrono::duration<double>(end - middle).count();
+        const double laneSteps = static_cast<double>(lockstep.VectorLaneSteps());
+
+        std::cout << name << "\n" << std::fixed << std::setprecision(1)
+                  << "  " << LANES << " x CPU         " << std::setw(10)
+                  << cycles / scalarSeconds / 1e6 << " MHz\n"
+                  << "  LockstepCPU       " << std::setw(10)
+                  << cycles / lockstepSeconds / 1e6 << " MHz  ("
+                  << std::setprecision(2) << scalarSeconds / lockstepSeconds << "x)\n"
+                  << std::setprecision(1)
+                  << "  vectorised        " << std::setw(10)
+                  << 100.0 * laneSteps / (laneSteps + lockstep.ScalarSteps()) << " %"
+                  << "  (" << std::setprecision(1)
+                  << laneSteps / std::max<std::uint64_t>(1, lockstep.VectorSteps())
+                  << " lanes per vector step)\n"
+                  << (same ? "" : "  STATE DIFFERS\n") << "\n";
+    }
+
+} // namespace
+
+int main() {
+    std::cout << "Lockstep benchmark (" << LockstepCPU::LANES << " lanes, "
+              << BUDGET << " cycles per lane)\n\n";
+
+    Run("Mixed workload (all lane-parallel instructions)", Benchmarks::LoadMixedWorkload<Memory>);
+    Run("Page-fill workload (INC and indirect stores)", Benchmarks::LoadPageFillWorkload<Memory>);
+
+    return 0;
+}
+
+#else
+
+int main() {
+    std::cout << "LockstepCPU needs GCC or Clang vector extensions\n";
+    return 0;
+}
+
+#endif
@@ -0,0 +1,89 @@
+/**
+ * @file ProfilerBenchmark.cpp
+ * @brief Cost of the profiler, plus a sample report and flame graph input
+ *
+ * Runs the mixed and call workloads with and without a Profiler
+ * attached, checks both runs end in the same state, then prints the
+ * call workload's hot-spot report and writes its folded stacks to
+ * profile.folded (feed it to flamegraph.pl).
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -I. benchmarks/ProfilerBenchmark.cpp CPU.cpp Instructions.cpp \
+ *       Memory.cpp MemoryBus.cpp Mnemonics.cpp Profiler.cpp -o profiler_bench
+ */
+
+#include "CPU.h"
+#include "Memory.h"
+#include "Profiler.h"
+#include "Workloads.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace M6502;
+
+namespace {
+
+    constexpr Cycles BUDGET = 50'000'000;
+
+    struct Result {
+        double seconds;
+        Byte a, x, y, p;
+        Word pc;
+
+        bool SameState(const Result& other) const {
+            return a == other.a && x == other.x && y == other.y && p == other.p && pc == other.pc;
+        }
+    };
+
+    template <typename LoadFunction>
+    Result Measure(LoadFunction load, Profiler* profiler) {
+        CPU cpu;
+        Memory memory;
+        load(memory);
+        cpu.Reset(memory);
+        cpu.SetProfiler(profiler);
+
+        auto start = std::chrono::steady_clock::now();
+        cpu.RunFor(BUDGET, memory);
+        auto end = std::chrono::steady_clock::now();
+
+        return { std::chrono::duration<double>(end - start).count(),
+                 cpu.A, cpu.X, cpu.Y, static_cast<Byte>(cpu.P), cpu.PC };
+    }
+
+    template <typename LoadFunction>
+    void Compare(const char* name, LoadFunction load, Profiler& profiler) {
+        Result detached = Measure(load, nullptr);
+        profiler.Clear();
+        Result attached = Measure(load, &profiler);
+
+        std::cout << std::left << std::setw(10) << name << std::right << std::fixed
+                  << std::setprecision(1)
+                  << std::setw(10) << BUDGET / detached.seconds / 1e6 << " MHz"
+                  << std::setw(10) << BUDGET / attached.seconds / 1e6 << " MHz"
+                  << std::setprecision(2)
+                  << std::setw(8) << attached.seconds / detached.seconds << "x"
+                  << (attached.SameState(detached) ? "" : "   STATE DIFFERS") << "\n";
+    }
+
+} // namespace
+
+int main() {
+    std::cout << "Profiler benchmark (" << BUDGET << " cycles)\n\n"
+              << std::setw(24) << "detached" << std::setw(14) << "attached"
+              << std::setw(9) << "cost" << "\n";
+
+    Profiler profiler;
+    Compare("mixed", Benchmarks::LoadMixedWorkload<Memory>, profiler);
+    Compare("calls", Benchmarks::LoadCallWorkload<Memory>, profiler);
+
+    std::cout << "\n";
+    profiler.WriteReport(std::cout, 10);
+
+    if (profiler.SaveFoldedStacks("profile.folded")) {
+        std::cout << "\nFolded stacks written to profile.folded\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,240 @@
+/**
+ * @file SchedulerBenchmark.cpp
+ * @brief Event scheduler against polling every deadline on every instruction
+ *
+ * TICKERS periodic events (periods from 5,000 to 500,000 cycles) stand
+ * in for the timers, UART baud clocks and video line counters of a busy
+ * system. A doorbell device at $D000 adds the case a scheduler has to
+ * get right: a register write arms a one-shot event DELAY cycles later,
+ * from inside the running batch, which pulses NMI. Reads return the low
+ * byte of the access's cycle, so any timing error shows up in the
+ * guest's RAM.
+ *
+ * The same system runs three ways:
+ *   - poll       after every instruction, compare every deadline
+ *   - heap/step  after every instruction, Scheduler::RunDue()
+ *   - scheduler  Scheduler::RunFor(): each batch runs straight to the
+ *                earliest deadline
+ *
+ * All three must end in the same CPU and RAM state with every event
+ * having fired the same number of times.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -I. benchmarks/SchedulerBenchmark.cpp \
+ *       CPU.cpp Instructions.cpp Memory.cpp MemoryBus.cpp Scheduler.cpp \
+ *       -o scheduler_bench
+ */
+
+#include "CPU.h"
+#include "Device.h"
+#include "MemoryBus.h"
+#include "Scheduler.h"
+#include "Workloads.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace M6502;
+
+namespace {
+
+    using BusCPU = BasicCPU<MemoryBus>;
+
+    constexpr Cycles BUDGET = 20'000'000;
+    constexpr std::size_t TICKERS = 500;
+    constexpr Cycles DELAY = 2'000;
+    constexpr Address DOORBELL_BASE = 0xD000;
+    constexpr Address HANDLER = 0x0F10;
+    constexpr Address NMI_COUNT = 0x41;
+
+    /**
+     * @brief Periodic event; counts its firings and rearms itself
+     */
+    struct Ticker {
+        Event event;
+        Scheduler* scheduler;
+        Cycles period;
+        Cycles deadline;     ///< Next firing, for the polling loop
+        Cycles fired = 0;
+
+        Ticker(Scheduler* scheduler, Cycles period)
+            : event(&Ticker::Fire, this), scheduler(scheduler), period(period), deadline(period) {}
+
+        static void Fire(void* context, Cycles deadline) {
+            Ticker* ticker = static_cast<Ticker*>(context);
+            ticker->fired++;
+            ticker->scheduler->Schedule(ticker->event, deadline + ticker->period);
+        }
+    };
+
+    /**
+     * @brief Writes arm a one-shot NMI pulse DELAY cycles later
+     *
+     * With a scheduler the pulse is an Event; without one the polling
+     * loop watches `deadline`.
+     */
+    class Doorbell : public Device {
+    public:
+        Doorbell(BusCPU& cpu, Scheduler* scheduler)
+            : event(&Doorbell::Ring, this), cpu(cpu), scheduler(scheduler) {}
+
+        Byte Read(Address /* address */) override {
+            return static_cast<Byte>(SyncedTo());
+        }
+
+        void Write(Address /* address */, Byte /* value */) override {
+            // A pulse already on its way absorbs the write
+            if (scheduler != nullptr) {
+                if (!event.Scheduled()) {
+                    scheduler->Schedule(event, SyncedTo() + DELAY);
+                }
+            } else if (deadline == NO_DEADLINE) {
+                deadline = SyncedTo() + DELAY;
+            }
+        }
+
+        static void Ring(void* context, Cycles /* deadline */) {
+            Doorbell* doorbell = static_cast<Doorbell*>(context);
+            doorbell->cpu.SetNMI(true);
+            doorbell->cpu.SetNMI(false);
+            doorbell->rings++;
+        }
+
+        Event event;
+        Cycles deadline = NO_DEADLINE;
+        Cycles rings = 0;
+
+    protected:
+        void Advance(Cycles /* from */, Cycles /* to */) override {}
+
+    private:
+        BusCPU& cpu;
+        Scheduler* scheduler;
+    };
+
+    struct System {
+        BusCPU cpu;
+        MemoryBus bus;
+        Scheduler scheduler;
+        std::vector<std::unique_ptr<Ticker>> tickers;
+        Doorbell doorbell;
+
+        explicit System(bool scheduled)
+            : scheduler(TICKERS + 1), doorbell(cpu, scheduled ? &scheduler : nullptr) {
+            Benchmarks::LoadDeviceWorkload(bus, DOORBELL_BASE);
+
+            const Byte handler[] = { INS_INC_ZP, NMI_COUNT, INS_RTI };
+            for (std::size_t i = 0; i < sizeof(handler); i++) {
+                bus[HANDLER + i] = handler[i];
+            }
+            bus[VECTOR_NMI] = HANDLER & 0xFF;
+            bus[VECTOR_NMI + 1] = HANDLER >> 8;
+
+            bus.MapDevice(DOORBELL_BASE >> 8, 1, doorbell);
+            bus.SetClock(&cpu.TotalCycles);
+            cpu.Reset(bus);
+
+            // Allocated once, here; nothing allocates while running
+            for (std::size_t i = 0; i < TICKERS; i++) {
+                tickers.push_back(std::make_unique<Ticker>(&scheduler, 5'000 + 991 * i));
+                Ticker& ticker = *tickers.back();
+                ticker.deadline += cpu.TotalCycles;
+                if (scheduled) {
+                    scheduler.Schedule(ticker.event, ticker.deadline);
+                }
+            }
+        }
+
+        Cycles Fired() const {
+            Cycles total = doorbell.rings;
+            for (const auto& ticker : tickers) {
+                total += ticker->fired;
+            }
+            return total;
+        }
+
+        bool SameState(const System& other) const {
+            for (Address address = 0; address < 0x2200; address++) {
+                if (bus[address] != other.bus[address]) {
+                    return false;
+                }
+            }
+            for (std::size_t i = 0; i < TICKERS; i++) {
+                if (tickers[i]->fired != other.tickers[i]->fired) {
+                    return false;
+                }
+            }
+            return doorbell.rings == other.doorbell.rings
+                && cpu.A == other.cpu.A && cpu.X == other.cpu.X && cpu.Y == other.cpu.Y
+                && cpu.SP == other.cpu.SP && static_cast<Byte>(cpu.P) == static_cast<Byte>(other.cpu.P)
+                && cpu.PC == other.cpu.PC && cpu.TotalCycles == other.cpu.TotalCycles;
+        }
+    };
+
+    template <typename RunFunction>
+    double Measure(System& system, RunFunction run) {
+        auto start = std::chrono::steady_clock::now();
+        run(system);
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double>(end - start).count();
+    }
+
+    void Report(const char* name, double seconds, double baseline, bool same) {
+        std::cout << std::left << std::setw(12) << name << std::right << std::fixed
+                  << std::setprecision(1)
+                  << std::setw(10) << BUDGET / seconds / 1e6 << " MHz"
+                  << std::setprecision(2)
+                  << std::setw(8) << baseline / seconds << "x"
+                  << (same ? "" : "   STATE DIFFERS") << "\n";
+    }
+
+} // namespace
+
+int main() {
+    std::cout << "Event scheduler benchmark (" << BUDGET << " cycles, " << TICKERS
+              << " periodic events + doorbell)\n\n" << std::setw(32) << "speedup" << "\n";
+
+    System poll(false);
+    const double pollSeconds = Measure(poll, [](System& system) {
+        const Cycles end = system.cpu.TotalCycles + BUDGET;
+        while (system.cpu.TotalCycles < end) {
+            system.cpu.Execute(system.bus);
+
+            const Cycles now = system.cpu.TotalCycles;
+            for (auto& ticker : system.tickers) {
+                if (ticker->deadline <= now) {
+                    ticker->fired++;
+                    ticker->deadline += ticker->period;
+                }
+            }
+            if (system.doorbell.deadline <= now) {
+                system.doorbell.deadline = Device::NO_DEADLINE;
+                Doorbell::Ring(&system.doorbell, now);
+            }
+        }
+    });
+    Report("poll", pollSeconds, pollSeconds, true);
+
+    System stepped(true);
+    const double steppedSeconds = Measure(stepped, [](System& system) {
+        const Cycles end = system.cpu.TotalCycles + BUDGET;
+        while (system.cpu.TotalCycles < end) {
+            system.cpu.Execute(system.bus);
+            system.scheduler.RunDue(system.cpu.TotalCycles);
+        }
+    });
+    Report("heap/step", steppedSeconds, pollSeconds, stepped.SameState(poll));
+
+    System scheduled(true);
+    const double scheduledSeconds = Measure(scheduled, [](System& system) {
+        system.scheduler.RunFor(system.cpu, system.bus, BUDGET);
+    });
+    Report("scheduler", scheduledSeconds, pollSeconds, scheduled.SameState(poll));
+
+    std::cout << "\n" << scheduled.Fired() << " events fired, "
+              << scheduled.doorbell.rings << " of them NMI pulses\n";
+
+    return 0;
+}
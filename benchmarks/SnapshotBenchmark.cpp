@@ -0,0 +1,152 @@
+/**
+ * @file SnapshotBenchmark.cpp
+ * @brief Save and restore latency of machine snapshots
+ *
+ * Runs the mixed workload for a while, then times:
+ *   - SaveSnapshot / LoadSnapshot to and from a buffer, raw and compressed
+ *   - LoadSnapshotFile (mmap, then copy into Memory)
+ *   - MappedSnapshot::Restore (copy-on-write mapping under a MemoryBus)
+ *
+ * Every restore is checked by running on and comparing against the
+ * machine the snapshot was taken from.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -I. benchmarks/SnapshotBenchmark.cpp \
+ *       CPU.cpp Instructions.cpp Memory.cpp MemoryBus.cpp Snapshot.cpp -o snapshot_bench
+ */
+
+#include "CPU.h"
+#include "Memory.h"
+#include "MemoryBus.h"
+#include "Snapshot.h"
+#include "Workloads.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace M6502;
+
+namespace {
+
+    constexpr int REPEATS = 2000;
+    constexpr Cycles WARMUP = 1'000'000;
+    constexpr Cycles CHECK_RUN = 100'000;
+    const char* const SNAPSHOT_PATH = "snapshot_bench.m6502";
+
+    template <typename Function>
+    double MicrosecondsPer(Function function) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < REPEATS; i++) {
+            function();
+        }
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::micro>(end - start).count() / REPEATS;
+    }
+
+    void Report(const char* name, double microseconds, std::size_t size, bool same) {
+        std::cout << std::left << std::setw(30) << name << std::right << std::fixed
+                  << std::setprecision(2) << std::setw(10) << microseconds << " us";
+        if (size != 0) {
+            std::cout << std::setw(10) << size << " bytes";
+        } else {
+            std::cout << std::setw(16) << "";
+        }
+        std::cout << (same ? "" : "   STATE DIFFERS") << "\n";
+    }
+
+    template <typename CoreA, typename BusA, typename CoreB, typename BusB>
+    bool SameMachine(CoreA& a, BusA& busA, CoreB& b, BusB& busB) {
+        if (a.A != b.A || a.X != b.X || a.Y != b.Y || a.SP != b.SP ||
+            static_cast<Byte>(a.P) != static_cast<Byte>(b.P) || a.PC != b.PC ||
+            a.TotalCycles != b.TotalCycles) {
+            return false;
+        }
+        for (std::size_t address = 0; address < MEMORY_SIZE; address++) {
+            if (busA[static_cast<Address>(address)] != busB[static_cast<Address>(address)]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Run a restored machine and the reference on, then compare
+     */
+    template <typename Core, typename Bus>
+    bool RunsTheSame(Core& restored, Bus& restoredBus, const CPU& reference,
+                     const Memory& referenceMemory) {
+        CPU cpu = reference;
+        Memory memory = referenceMemory;
+        cpu.RunFor(CHECK_RUN, memory);
+        restored.RunFor(CHECK_RUN, restoredBus);
+        return SameMachine(cpu, memory, restored, restoredBus);
+    }
+
+} // namespace
+
+int main() {
+    CPU cpu;
+    Memory memory;
+    Benchmarks::LoadMixedWorkload(memory);
+    cpu.Reset(memory);
+    cpu.RunFor(WARMUP, memory);
+
+    std::cout << "Snapshot benchmark (" << REPEATS << " repeats, mean per operation)\n\n";
+
+    for (bool compress : { false, true }) {
+        std::vector<Byte> snapshot;
+        double save = MicrosecondsPer([&] { snapshot = SaveSnapshot(cpu, memory, compress); });
+
+        CPU restored;
+        Memory restoredMemory;
+        bool loaded = true;
+        double load = MicrosecondsPer([&] {
+            loaded &= LoadSnapshot(restored, restoredMemory, snapshot.data(), snapshot.size());
+        });
+        bool same = loaded && RunsTheSame(restored, restoredMemory, cpu, memory);
+
+        Report(compress ? "save, compressed" : "save, raw", save, snapshot.size(), true);
+        Report(compress ? "load, compressed" : "load, raw", load, 0, same);
+    }
+
+    if (!SaveSnapshotFile(SNAPSHOT_PATH, cpu, memory)) {
+        std::cerr << "cannot write " << SNAPSHOT_PATH << "\n";
+        return 1;
+    }
+
+    {
+        CPU restored;
+        Memory restoredMemory;
+        bool loaded = true;
+        double load = MicrosecondsPer([&] {
+            loaded &= LoadSnapshotFile(SNAPSHOT_PATH, restored, restoredMemory);
+        });
+        Report("LoadSnapshotFile", load, 0,
+               loaded && RunsTheSame(restored, restoredMemory, cpu, memory));
+    }
+
+    {
+        MappedSnapshot mapped;
+        BasicCPU<MemoryBus> restored;
+        MemoryBus bus;
+        if (mapped.Open(SNAPSHOT_PATH)) {
+            // Dirty the mapping between restores, as a real run would
+            bool loaded = true;
+            double load = MicrosecondsPer([&] {
+                loaded &= mapped.Restore(restored, bus);
+                restored.RunFor(1000, bus);
+            });
+            loaded &= mapped.Restore(restored, bus);
+            Report("MappedSnapshot::Restore + run", load, 0,
+                   loaded && RunsTheSame(restored, bus, cpu, memory));
+        } else {
+            std::cout << "MappedSnapshot unavailable on this platform\n";
+        }
+    }
+
+    std::remove(SNAPSHOT_PATH);
+    return 0;
+}
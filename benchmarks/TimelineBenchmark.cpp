@@ -0,0 +1,246 @@
+/**
+ * @file TimelineBenchmark.cpp
+ * @brief Checks reverse execution, then measures what going back costs
+ *
+ * Records a long run of each workload on a Timeline, poking the byte
+ * the mixed workload ORs in as a logged input, and keeps full snapshots
+ * along the way. Then steps back over the last few hundred instructions,
+ * seeks to every snapshot, reverse-continues to a PC and replays to the
+ * end, checking every state reached against the recording. Reports the
+ * checkpoint interval the timeline settled on, its footprint and the
+ * latency of each way back.
+ *
+ * The device workload runs on a MemoryBus with a device that answers
+ * every read with a new pseudo-random byte, so replay only reaches the
+ * recorded states if it gets the logged reads back. Afterwards the
+ * device must have seen exactly what a plain run to the same end shows
+ * it: no read or write twice.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -I. benchmarks/TimelineBenchmark.cpp CPU.cpp \
+ *       Instructions.cpp Memory.cpp MemoryBus.cpp Snapshot.cpp \
+ *       Checkpoint.cpp Timeline.cpp -o timeline_bench
+ */
+
+#include "CPU.h"
+#include "Device.h"
+#include "Memory.h"
+#include "MemoryBus.h"
+#include "Snapshot.h"
+#include "Timeline.h"
+#include "Workloads.h"
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+using namespace M6502;
+
+namespace {
+
+    constexpr int CHUNKS = 400;
+    constexpr Cycles CHUNK = 25'013;
+    constexpr int REFERENCE_EVERY = 20;
+    constexpr int STEPS = 500;
+
+    constexpr Address INPUT = 0x0010;       // ORA $10 in the mixed workload
+    constexpr Address STORE = 0x1008;       // STA $2100,X
+    constexpr Address DEVICE_STORE = 0x1009;    // The same in the device workload
+    constexpr Address PORT = 0xD000;        // The device workload's registers
+
+    using Clock = std::chrono::steady_clock;
+
+    double Microseconds(Clock::time_point start, Clock::time_point end) {
+        return std::chrono::duration<double, std::micro>(end - start).count();
+    }
+
+    using Benchmarks::Check;
+
+    /**
+     * @brief Reads as a new pseudo-random byte every time; counts what is written
+     */
+    class Port : public Device {
+    public:
+        std::uint32_t state = 1;
+        Cycles reads = 0;
+        Cycles writes = 0;
+        Byte checksum = 0;
+
+        Byte Read(Address /* address */) override {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            reads++;
+            return static_cast<Byte>(state);
+        }
+
+        void Write(Address /* address */, Byte value) override {
+            writes++;
+            checksum = static_cast<Byte>((checksum << 1 | checksum >> 7) ^ value);
+        }
+
+    protected:
+        void Advance(Cycles from, Cycles to) override { state += static_cast<std::uint32_t>(to - from); }
+    };
+
+    void AttachClock(Memory& /* memory */, const Cycles* /* total */) {}
+    void AttachClock(MemoryBus& bus, const Cycles* total) { bus.SetClock(total); }
+
+    /// CPU state and every byte, comparable on either bus
+    template <typename Bus>
+    std::vector<Byte> State(const BasicCPU<Bus>& cpu, const Bus& memory) {
+        std::vector<Byte> state;
+        SnapshotWriter writer(state);
+        cpu.SaveState(writer);
+        for (std::size_t address = 0; address < MEMORY_SIZE; address++) {
+            state.push_back(memory[static_cast<Address>(address)]);
+        }
+        return state;
+    }
+
+    template <typename Bus, typename LoadFunction>
+    void Run(const char* name, LoadFunction load, bool pokes, Address store = STORE,
+             const TimelineOptions& options = TimelineOptions()) {
+        BasicCPU<Bus> cpu;
+        Bus memory;
+        Port port;
+        load(memory, port);
+        AttachClock(memory, &cpu.TotalCycles);
+        cpu.Reset(memory);
+
+        BasicTimeline<Bus> timeline(cpu, memory, options);
+        std::vector<std::pair<Cycles, std::vector<Byte>>> references;
+
+        // Record, poking a new input after every chunk
+        auto start = Clock::now();
+        for (int i = 0; i < CHUNKS; i++) {
+            timeline.RunFor(CHUNK);
+            if (pokes) {
+                timeline.Poke(INPUT, static_cast<Byte>(i * 7));
+            }
+            if (i % REFERENCE_EVERY == 0) {
+                references.emplace_back(timeline.Now(), State(cpu, memory));
+            }
+        }
+        const double recordTime = Microseconds(start, Clock::now());
+
+        // The last instructions one at a time, remembering each boundary
+        std::vector<std::pair<Cycles, Word>> boundaries;
+        for (int i = 0; i < STEPS; i++) {
+            boundaries.emplace_back(timeline.Now(), cpu.PC);
+            timeline.RunFor(1);
+        }
+        const Cycles end = timeline.Now();
+        const std::vector<Byte> final = State(cpu, memory);
+
+        // Step back over them
+        bool same = true;
+        start = Clock::now();
+        for (int i = STEPS; i-- > 0;) {
+            same = timeline.StepBack() && same &&
+                   timeline.Now() == boundaries[i].first && cpu.PC == boundaries[i].second;
+        }
+        const double stepTime = Microseconds(start, Clock::now()) / STEPS;
+        Check(same, name, "step back retraces every instruction");
+
+        // Reverse-continue from the end to the last STA $2100,X
+        timeline.Seek(end);
+        Check(timeline.Now() == end && State(cpu, memory) == final,
+              name, "seek forward replays the logged future");
+        Cycles expected = 0;
+        bool any = false;
+        for (const auto& boundary : boundaries) {
+            if (boundary.second == store) {
+                expected = boundary.first;
+                any = true;
+            }
+        }
+        start = Clock::now();
+        const bool found = timeline.ReverseContinue([store](const BasicCPU<Bus>& c) {
+            return c.PC == store;
+        });
+        const double reverseTime = Microseconds(start, Clock::now());
+        if (any) {
+            Check(found && timeline.Now() == expected && cpu.PC == store,
+                  name, "reverse-continue stops at the last store");
+        }
+
+        // Seek to every reference, newest first
+        same = true;
+        start = Clock::now();
+        for (std::size_t i = references.size(); i-- > 0;) {
+            timeline.Seek(references[i].first);
+            same = same && State(cpu, memory) == references[i].second;
+        }
+        const double seekTime = Microseconds(start, Clock::now()) / references.size();
+        Check(same, name, "seek back restores every recorded state");
+        timeline.Seek(0);
+        Check(!timeline.StepBack(), name, "no step back before the history");
+
+        // From the start, the whole log replays to the same end
+        timeline.RunFor(end - timeline.Now());
+        Check(timeline.Now() == end && State(cpu, memory) == final,
+              name, "replay from the start reaches the same end");
+
+        // A new input in the past discards the future after it
+        if (pokes) {
+            timeline.Seek(references[1].first);
+            timeline.Poke(INPUT, 0xFF);
+            Check(timeline.InputCount() == static_cast<std::size_t>(REFERENCE_EVERY + 2),
+                  name, "a new input discards the logged future");
+        }
+
+        // The device saw the run once, as a plain run to the same end shows it
+        if (!pokes) {
+            timeline.Seek(end);
+            BasicCPU<Bus> plainCPU;
+            Bus plainMemory;
+            Port plainPort;
+            load(plainMemory, plainPort);
+            AttachClock(plainMemory, &plainCPU.TotalCycles);
+            plainCPU.Reset(plainMemory);
+            plainCPU.RunFor(end - plainCPU.TotalCycles, plainMemory);
+            Check(State(plainCPU, plainMemory) == final && port.reads == plainPort.reads &&
+                  port.writes == plainPort.writes && port.checksum == plainPort.checksum &&
+                  timeline.IOReadCount() == port.reads,
+                  name, "devices only see the recorded run");
+        }
+
+        std::cout << name << "\n" << std::fixed << std::setprecision(1)
+                  << "  recorded           " << std::setw(12) << end << " cycles in "
+                  << recordTime / 1000 << " ms\n"
+                  << "  checkpoints        " << std::setw(12) << timeline.CheckpointCount()
+                  << " (interval " << timeline.Interval() << ")\n"
+                  << "  footprint          " << std::setw(12)
+                  << timeline.FootprintBytes() / 1024.0 << " KiB\n"
+                  << std::setprecision(2)
+                  << "  step back          " << std::setw(12) << stepTime << " us\n"
+                  << "  seek back          " << std::setw(12) << seekTime << " us\n"
+                  << "  reverse-continue   " << std::setw(12) << reverseTime << " us\n";
+    }
+
+} // namespace
+
+int main() {
+    std::cout << "Timeline benchmark (" << CHUNKS << " x " << CHUNK << " cycles)\n\n";
+
+    Run<Memory>("Mixed", [](Memory& m, Port&) { Benchmarks::LoadMixedWorkload(m); }, true);
+    Run<Memory>("PageFill", [](Memory& m, Port&) { Benchmarks::LoadPageFillWorkload(m); }, false);
+    Run<MemoryBus>("Device (MemoryBus)", [](MemoryBus& bus, Port& port) {
+        Benchmarks::LoadDeviceWorkload(bus, PORT);
+        bus.MapDevice(PORT >> 8, 1, port);
+    }, false, DEVICE_STORE);
+
+    // A tighter page budget stretches the interval on the same program,
+    // trading step-back latency for fewer checkpoints
+    TimelineOptions tight;
+    tight.pageBudget = 4;
+    tight.maxInterval = 200'000;
+    Run<Memory>("PageFill, budget 4", [](Memory& m, Port&) { Benchmarks::LoadPageFillWorkload(m); },
+                false, STORE, tight);
+
+    std::cout << (Benchmarks::failures == 0 ? "\nAll timeline checks passed\n" : "\n");
+    return Benchmarks::failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,504 @@
+/**
+ * @file Workloads.h
+ * @brief Guest programs and the result check shared by the benchmark programs
+ *
+ * Every workload is an endless loop so a benchmark can run it for any
+ * number of instructions or cycles. Programs are written byte by byte
+ * through operator[], the same way main.cpp sets up its examples.
+ */
+
+#ifndef M6502_BENCHMARK_WORKLOADS_H
+#define M6502_BENCHMARK_WORKLOADS_H
+
+#include "Constants.h"
+#include <iostream>
+
+namespace M6502 {
+namespace Benchmarks {
+
+    // ====================================================================
+    // CHECKS
+    // ====================================================================
+
+    /// Failed Check()s so far; main() returns nonzero if there are any
+    inline int failures = 0;
+
+    /**
+     * @brief Print `what` as a failure and count it, unless `condition` holds
+     */
+    inline void Check(bool condition, const char* what) {
+        if (!condition) {
+            std::cout << "  FAIL  " << what << "\n";
+            failures++;
+        }
+    }
+
+    /**
+     * @brief The same, naming the `subject` (a bus, a workload) it failed on
+     */
+    inline void Check(bool condition, const char* subject, const char* what) {
+        if (!condition) {
+            std::cout << "  FAIL  " << subject << ": " << what << "\n";
+            failures++;
+        }
+    }
+
+    // ====================================================================
+    // WORKLOADS
+    // ====================================================================
+
+    constexpr Address WORKLOAD_START = 0x1000;
+
+    /**
+     * @brief Point the reset vector at `start`
+     */
+    template <typename MemoryType>
+    void SetResetVector(MemoryType& memory, Address start) {
+        memory[VECTOR_RESET] = start & 0xFF;
+        memory[VECTOR_RESET + 1] = (start >> 8) & 0xFF;
+    }
+
+    /**
+     * @brief Mixed load/ALU/store/branch loop over a 256-byte table
+     *
+     *        LDX #$00
+     * loop:  LDA $2000,X
+     *        CLC
+     *        ADC #$03
+     *        STA $2100,X
+     *        EOR #$55
+     *        AND #$0F
+     *        ORA $10
+     *        CMP #$80
+     *        INX
+     *        BNE loop
+     *        JMP loop
+     */
+    template <typename MemoryType>
+    void LoadMixedWorkload(MemoryType& memory) {
+        const Byte program[] = {
+            INS_LDX_IM,   0x00,
+            INS_LDA_ABSX, 0x00, 0x20,
+            INS_CLC,
+            INS_ADC_IM,   0x03,
+            INS_STA_ABSX, 0x00, 0x21,
+            INS_EOR_IM,   0x55,
+            INS_AND_IM,   0x0F,
+            INS_ORA_ZP,   0x10,
+            INS_CMP_IM,   0x80,
+            INS_INX,
+            INS_BNE,      0xEC,         // back to $1002
+            INS_JMP_ABS,  0x02, 0x10
+        };
+
+        Address address = WORKLOAD_START;
+        for (Byte value : program) {
+            memory[address++] = value;
+        }
+
+        for (int i = 0; i < 0x100; i++) {
+            memory[0x2000 + i] = static_cast<Byte>(i * 7);
+        }
+
+        SetResetVector(memory, WORKLOAD_START);
+    }
+
+    /**
+     * @brief Loop that talks to a device at `device` every iteration
+     *
+     *        LDX #$00
+     * loop:  LDA device        ; status register
+     *        CLC
+     *        ADC $2000,X
+     *        STA $2100,X
+     *        STA device+1      ; data register
+     *        INX
+     *        BNE loop
+     *        JMP loop
+     *
+     * On a flat memory the device registers are ordinary RAM, so the
+     * instruction stream and cycle count are the same on every bus.
+     */
+    template <typename MemoryType>
+    void LoadDeviceWorkload(MemoryType& memory, Address device) {
+        const Byte deviceLow = device & 0xFF;
+        const Byte deviceHigh = (device >> 8) & 0xFF;
+        const Byte program[] = {
+            INS_LDX_IM,   0x00,
+            INS_LDA_ABS,  deviceLow, deviceHigh,
+            INS_CLC,
+            INS_ADC_ABSX, 0x00, 0x20,
+            INS_STA_ABSX, 0x00, 0x21,
+            INS_STA_ABS,  static_cast<Byte>(deviceLow + 1), deviceHigh,
+            INS_INX,
+            INS_BNE,      0xF0,         // back to $1002
+            INS_JMP_ABS,  0x02, 0x10
+        };
+
+        Address address = WORKLOAD_START;
+        for (Byte value : program) {
+            memory[address++] = value;
+        }
+
+        for (int i = 0; i < 0x100; i++) {
+            memory[0x2000 + i] = static_cast<Byte>(i * 7);
+        }
+
+        SetResetVector(memory, WORKLOAD_START);
+    }
+
+    /**
+     * @brief Loop that rewrites one of its own operands every iteration
+     *
+     * loop:  LDA #$00          ; operand incremented below
+     *        CLC
+     *        ADC $2000,X
+     *        INC loop+1
+     *        INX
+     *        BNE loop
+     *        JMP loop
+     *
+     * Exercises code caches: the LDA must see the new operand each time.
+     */
+    template <typename MemoryType>
+    void LoadSelfModifyingWorkload(MemoryType& memory) {
+        const Byte program[] = {
+            INS_LDA_IM,   0x00,
+            INS_CLC,
+            INS_ADC_ABSX, 0x00, 0x20,
+            INS_INC_ABS,  0x01, 0x10,   // LDA's operand
+            INS_INX,
+            INS_BNE,      0xF4,         // back to $1000
+            INS_JMP_ABS,  0x00, 0x10
+        };
+
+        Address address = WORKLOAD_START;
+        for (Byte value : program) {
+            memory[address++] = value;
+        }
+
+        for (int i = 0; i < 0x100; i++) {
+            memory[0x2000 + i] = static_cast<Byte>(i * 7);
+        }
+
+        SetResetVector(memory, WORKLOAD_START);
+    }
+
+    /**
+     * @brief Fills pages $30-$3F over and over with a changing pattern
+     *
+     *        LDY #$00
+     * loop:  TYA
+     *        CLC
+     *        ADC $22           ; lap counter
+     *        STA ($20),Y       ; $20/$21 walks $3000-$3FFF
+     *        INY
+     *        BNE loop
+     *        INC $21
+     *        LDA $21
+     *        CMP #$40
+     *        BNE loop
+     *        LDA #$30
+     *        STA $21
+     *        INC $22
+     *        JMP loop
+     *
+     * Write-heavy: every page it touches really changes on every lap.
+     */
+    template <typename MemoryType>
+    void LoadPageFillWorkload(MemoryType& memory) {
+        const Byte program[] = {
+            INS_LDY_IM,   0x00,
+            INS_TYA,
+            INS_CLC,
+            INS_ADC_ZP,   0x22,
+            INS_STA_INDY, 0x20,
+            INS_INY,
+            INS_BNE,      0xF7,         // back to $1002
+            INS_INC_ZP,   0x21,
+            INS_LDA_ZP,   0x21,
+            INS_CMP_IM,   0x40,
+            INS_BNE,      0xEF,         // back to $1002
+            INS_LDA_IM,   0x30,
+            INS_STA_ZP,   0x21,
+            INS_INC_ZP,   0x22,
+            INS_JMP_ABS,  0x02, 0x10
+        };
+
+        Address address = WORKLOAD_START;
+        for (Byte value : program) {
+            memory[address++] = value;
+        }
+
+        memory[0x20] = 0x00;
+        memory[0x21] = 0x30;
+        memory[0x22] = 0x00;
+
+        SetResetVector(memory, WORKLOAD_START);
+    }
+
+    /**
+     * @brief Main loop calling nested subroutines, for call-stack profiles
+     *
+     * main:   JSR sum
+     *         JSR scale
+     *         INC $30
+     *         JMP main
+     *
+     * sum:    LDX #$00         ; $1010
+     * loop:   LDA $20F0,X      ; crosses into $21xx from X = $10 on
+     *         CLC
+     *         ADC $31
+     *         STA $31
+     *         INX
+     *         BNE loop
+     *         RTS
+     *
+     * scale:  LDY #$00         ; $1020
+     * again:  JSR double
+     *         INY
+     *         CPY #$40
+     *         BNE again
+     *         RTS
+     *
+     * double: LDA $2100,Y      ; $1030
+     *         ASL A
+     *         STA $2100,Y
+     *         RTS
+     */
+    template <typename MemoryType>
+    void LoadCallWorkload(MemoryType& memory) {
+        const Byte main[] = {
+            INS_JSR,      0x10, 0x10,
+            INS_JSR,      0x20, 0x10,
+            INS_INC_ZP,   0x30,
+            INS_JMP_ABS,  0x00, 0x10
+        };
+        const Byte sum[] = {
+            INS_LDX_IM,   0x00,
+            INS_LDA_ABSX, 0xF0, 0x20,
+            INS_CLC,
+            INS_ADC_ZP,   0x31,
+            INS_STA_ZP,   0x31,
+            INS_INX,
+            INS_BNE,      0xF5,         // back to $1012
+            INS_RTS
+        };
+        const Byte scale[] = {
+            INS_LDY_IM,   0x00,
+            INS_JSR,      0x30, 0x10,
+            INS_INY,
+            INS_CPY_IM,   0x40,
+            INS_BNE,      0xF8,         // back to $1022
+            INS_RTS
+        };
+        const Byte twice[] = {
+            INS_LDA_ABSY, 0x00, 0x21,
+            INS_ASL_ACC,
+            INS_STA_ABSY, 0x00, 0x21,
+            INS_RTS
+        };
+
+        auto place = [&memory](Address address, const Byte* bytes, std::size_t size) {
+            for (std::size_t i = 0; i < size; i++) {
+                memory[address++] = bytes[i];
+            }
+        };
+        place(0x1000, main, sizeof(main));
+        place(0x1010, sum, sizeof(sum));
+        place(0x1020, scale, sizeof(scale));
+        place(0x1030, twice, sizeof(twice));
+
+        for (int i = 0; i < 0x200; i++) {
+            memory[0x2000 + i] = static_cast<Byte>(i * 5);
+        }
+
+        SetResetVector(memory, WORKLOAD_START);
+    }
+
+    /**
+     * @brief Copies pages $30-$3F to $40-$4F over and over
+     *
+     * start:  LDA #$30
+     *         STA $21          ; source pointer $20/$21
+     *         LDA #$40
+     *         STA $23          ; destination pointer $22/$23
+     *         LDY #$00
+     * loop:   LDA ($20),Y
+     *         STA ($22),Y
+     *         INY
+     *         BNE loop
+     *         INC $21
+     *         INC $23
+     *         LDA $23
+     *         CMP #$50
+     *         BNE loop
+     *         INC $3000        ; so every pass copies something new
+     *         JMP start
+     */
+    template <typename MemoryType>
+    void LoadMemcpyWorkload(MemoryType& memory) {
+        const Byte program[] = {
+            INS_LDA_IM,   0x30,
+            INS_STA_ZP,   0x21,
+            INS_LDA_IM,   0x40,
+            INS_STA_ZP,   0x23,
+            INS_LDY_IM,   0x00,
+            INS_LDA_INDY, 0x20,
+            INS_STA_INDY, 0x22,
+            INS_INY,
+            INS_BNE,      0xF9,         // back to $100A
+            INS_INC_ZP,   0x21,
+            INS_INC_ZP,   0x23,
+            INS_LDA_ZP,   0x23,
+            INS_CMP_IM,   0x50,
+            INS_BNE,      0xEF,         // back to $100A
+            INS_INC_ABS,  0x00, 0x30,
+            INS_JMP_ABS,  0x00, 0x10
+        };
+
+        Address address = WORKLOAD_START;
+        for (Byte value : program) {
+            memory[address++] = value;
+        }
+
+        memory[0x20] = 0x00;
+        memory[0x22] = 0x00;
+        for (int i = 0; i < 0x1000; i++) {
+            memory[0x3000 + i] = static_cast<Byte>(i * 3);
+        }
+
+        SetResetVector(memory, WORKLOAD_START);
+    }
+
+    /**
+     * @brief Bubble-sorts 64 descending bytes at $2000, then starts over
+     *
+     * start:  LDX #$00
+     * fill:   TXA
+     *         EOR #$FF         ; $FF, $FE, ... - the worst case
+     *         STA $2000,X
+     *         INX
+     *         CPX #$40
+     *         BNE fill
+     * pass:   LDA #$00
+     *         STA $24          ; swapped this pass
+     *         LDX #$00
+     * inner:  LDA $2000,X
+     *         CMP $2001,X
+     *         BCC next
+     *         BEQ next
+     *         LDY $2001,X
+     *         STA $2001,X
+     *         TYA
+     *         STA $2000,X
+     *         INC $24
+     * next:   INX
+     *         CPX #$3F
+     *         BNE inner
+     *         LDA $24
+     *         BNE pass
+     *         JMP start
+     */
+    template <typename MemoryType>
+    void LoadSortWorkload(MemoryType& memory) {
+        const Byte program[] = {
+            INS_LDX_IM,   0x00,
+            INS_TXA,
+            INS_EOR_IM,   0xFF,
+            INS_STA_ABSX, 0x00, 0x20,
+            INS_INX,
+            INS_CPX_IM,   0x40,
+            INS_BNE,      0xF5,         // back to $1002
+            INS_LDA_IM,   0x00,
+            INS_STA_ZP,   0x24,
+            INS_LDX_IM,   0x00,
+            INS_LDA_ABSX, 0x00, 0x20,
+            INS_CMP_ABSX, 0x01, 0x20,
+            INS_BCC,      0x0E,         // on to $1029
+            INS_BEQ,      0x0C,         // on to $1029
+            INS_LDY_ABSX, 0x01, 0x20,
+            INS_STA_ABSX, 0x01, 0x20,
+            INS_TYA,
+            INS_STA_ABSX, 0x00, 0x20,
+            INS_INC_ZP,   0x24,
+            INS_INX,
+            INS_CPX_IM,   0x3F,
+            INS_BNE,      0xE5,         // back to $1013
+            INS_LDA_ZP,   0x24,
+            INS_BNE,      0xDB,         // back to $100D
+            INS_JMP_ABS,  0x00, 0x10
+        };
+
+        Address address = WORKLOAD_START;
+        for (Byte value : program) {
+            memory[address++] = value;
+        }
+
+        SetResetVector(memory, WORKLOAD_START);
+    }
+
+    /**
+     * @brief Decimal-mode add and subtract on 4-byte BCD numbers
+     *
+     *         SED
+     * loop:   CLC
+     *         LDX #$FC         ; counts up to 0; zp,X wraps, so $34,X is $30
+     * add:    LDA $34,X        ; $30-$33 += $34-$37
+     *         ADC $38,X
+     *         STA $34,X
+     *         INX              ; INX/BNE keep the carry, CPX would not
+     *         BNE add
+     *         SEC
+     *         LDX #$FC
+     * sub:    LDA $3C,X        ; $38-$3B -= $3C-$3F
+     *         SBC $40,X
+     *         STA $3C,X
+     *         INX
+     *         BNE sub
+     *         JMP loop
+     */
+    template <typename MemoryType>
+    void LoadBcdWorkload(MemoryType& memory) {
+        const Byte program[] = {
+            INS_SED,
+            INS_CLC,
+            INS_LDX_IM,   0xFC,
+            INS_LDA_ZPX,  0x34,
+            INS_ADC_ZPX,  0x38,
+            INS_STA_ZPX,  0x34,
+            INS_INX,
+            INS_BNE,      0xF7,         // back to $1004
+            INS_SEC,
+            INS_LDX_IM,   0xFC,
+            INS_LDA_ZPX,  0x3C,
+            INS_SBC_ZPX,  0x40,
+            INS_STA_ZPX,  0x3C,
+            INS_INX,
+            INS_BNE,      0xF7,         // back to $1010
+            INS_JMP_ABS,  0x01, 0x10
+        };
+
+        Address address = WORKLOAD_START;
+        for (Byte value : program) {
+            memory[address++] = value;
+        }
+
+        // Little-endian BCD: 00000000 += 00001237, 99999999 -= 00000099
+        const Byte numbers[] = {
+            0x00, 0x00, 0x00, 0x00,
+            0x37, 0x12, 0x00, 0x00,
+            0x99, 0x99, 0x99, 0x99,
+            0x99, 0x00, 0x00, 0x00
+        };
+        for (std::size_t i = 0; i < sizeof(numbers); i++) {
+            memory[0x30 + i] = numbers[i];
+        }
+
+        SetResetVector(memory, WORKLOAD_START);
+    }
+
+} // namespace Benchmarks
+} // namespace M6502
+
+#endif // M6502_BENCHMARK_WORKLOADS_H
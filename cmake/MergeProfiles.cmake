@@ -0,0 +1,20 @@
+# Merges Clang's raw profiles into the default.profdata a USE build reads
+#
+#   cmake -DPROFDATA=<llvm-profdata> -DDIRECTORY=<profile dir> -P MergeProfiles.cmake
+
+if(NOT PROFDATA)
+    message(FATAL_ERROR "llvm-profdata is needed to merge Clang profiles")
+endif()
+
+file(GLOB raw_profiles "${DIRECTORY}/*.profraw")
+if(NOT raw_profiles)
+    message(FATAL_ERROR "No .profraw files in ${DIRECTORY}; did the training run?")
+endif()
+
+execute_process(
+    COMMAND ${PROFDATA} merge -output=${DIRECTORY}/default.profdata ${raw_profiles}
+    RESULT_VARIABLE result
+)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "llvm-profdata merge failed")
+endif()
@@ -0,0 +1,148 @@
+/**
+ * @file CompareBenchmarks.cpp
+ * @brief Speedup between two benchmark_suite JSON files
+ *
+ * Usage: compare_benchmarks <before.json> <after.json> [count]
+ *
+ * Matches cases by group and name and prints the geometric-mean speedup
+ * of each group and of everything, followed by the `count` (default 5)
+ * biggest gains and losses. Speedup is before/after ns per instruction,
+ * so above 1.00 means faster.
+ *
+ * Only reads the one-result-per-line layout BenchmarkSuite writes; it
+ * is not a general JSON parser.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 tools/CompareBenchmarks.cpp -o compare_benchmarks
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+    struct Entry {
+        std::string group;
+        std::string name;
+        double ns;
+    };
+
+    /// The string value after `"key": "`, or empty
+    std::string StringField(const std::string& line, const char* key) {
+        const std::string marker = std::string("\"") + key + "\": \"";
+        const std::size_t start = line.find(marker);
+        if (start == std::string::npos) {
+            return {};
+        }
+        const std::size_t begin = start + marker.size();
+        const std::size_t end = line.find('"', begin);
+        return end == std::string::npos ? std::string() : line.substr(begin, end - begin);
+    }
+
+    /// The number after `"key": `, or a negative value
+    double NumberField(const std::string& line, const char* key) {
+        const std::string marker = std::string("\"") + key + "\": ";
+        const std::size_t start = line.find(marker);
+        if (start == std::string::npos) {
+            return -1.0;
+        }
+        return std::strtod(line.c_str() + start + marker.size(), nullptr);
+    }
+
+    bool ReadResults(const char* path, std::map<std::string, Entry>& entries) {
+        std::ifstream file(path);
+        if (!file) {
+            return false;
+        }
+
+        std::string line;
+        while (std::getline(file, line)) {
+            Entry entry{ StringField(line, "group"), StringField(line, "name"),
+                         NumberField(line, "ns_per_instruction") };
+            if (!entry.name.empty() && entry.ns > 0.0) {
+                entries[entry.group + "/" + entry.name] = entry;
+            }
+        }
+        return !entries.empty();
+    }
+
+    struct Mean {
+        double logSum = 0.0;
+        int count = 0;
+
+        void Add(double speedup) {
+            logSum += std::log(speedup);
+            count++;
+        }
+        double Value() const { return count == 0 ? 1.0 : std::exp(logSum / count); }
+    };
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3 || argc > 4) {
+        std::fprintf(stderr, "usage: %s <before.json> <after.json> [count]\n", argv[0]);
+        return 2;
+    }
+    const std::size_t count = argc == 4 ? std::strtoul(argv[3], nullptr, 10) : 5;
+
+    std::map<std::string, Entry> before, after;
+    for (auto [path, entries] : { std::make_pair(argv[1], &before), std::make_pair(argv[2], &after) }) {
+        if (!ReadResults(path, *entries)) {
+            std::fprintf(stderr, "%s: no benchmark results\n", path);
+            return 1;
+        }
+    }
+
+    struct Change {
+        std::string key;
+        double speedup;
+    };
+    std::vector<Change> changes;
+    std::map<std::string, Mean> groups;
+    Mean overall;
+
+    for (const auto& [key, old] : before) {
+        auto found = after.find(key);
+        if (found == after.end()) {
+            continue;
+        }
+        const double speedup = old.ns / found->second.ns;
+        changes.push_back({ key, speedup });
+        groups[old.group].Add(speedup);
+        overall.Add(speedup);
+    }
+
+    if (changes.empty()) {
+        std::fprintf(stderr, "no cases in common\n");
+        return 1;
+    }
+
+    std::printf("Speedup, %s -> %s (geometric mean, >1 is faster)\n\n", argv[1], argv[2]);
+    for (const auto& [group, mean] : groups) {
+        std::printf("  %-12s %6.3fx  (%d cases)\n", group.c_str(), mean.Value(), mean.count);
+    }
+    std::printf("  %-12s %6.3fx  (%d cases)\n", "overall", overall.Value(), overall.count);
+
+    std::sort(changes.begin(), changes.end(),
+              [](const Change& a, const Change& b) { return a.speedup > b.speedup; });
+    const std::size_t shown = std::min(count, changes.size());
+
+    std::printf("\nBiggest gains\n");
+    for (std::size_t i = 0; i < shown; i++) {
+        std::printf("  %-36s %6.3fx\n", changes[i].key.c_str(), changes[i].speedup);
+    }
+    std::printf("\nBiggest losses\n");
+    for (std::size_t i = 0; i < shown; i++) {
+        const Change& change = changes[changes.size() - 1 - i];
+        std::printf("  %-36s %6.3fx\n", change.key.c_str(), change.speedup);
+    }
+
+    return 0;
+}
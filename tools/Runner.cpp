@@ -0,0 +1,336 @@
+/**
+ * @file Runner.cpp
+ * @brief Headless runner: load an image, run it to a stop, print JSON
+ *
+ * Usage: m6502_run [options] <image>
+ *
+ *   --format F        auto (default), raw, hex, srec or seg (Loader.h)
+ *   --base ADDR       Load address of a raw image (default $0000)
+ *   --entry ADDR      Reset vector; default is the image's own entry,
+ *                     else the vector already in the image
+ *   --cycles N        Cycle budget (default 100000000)
+ *   --stop-pc ADDR    Stop before the instruction at ADDR (repeatable)
+ *   --stop-store ADDR Stop after a store to ADDR (repeatable)
+ *   --no-brk          Let BRK run its handler instead of stopping
+ *   --no-self-jump    Let a jump or branch to itself spin on
+ *
+ * Addresses and counts are decimal, $hex or 0xhex. Runs the image from
+ * reset with CPU::Execute(Cycles, Memory&) and prints one JSON object:
+ * why and where it stopped, the registers, cycles, wall time, effective
+ * MHz and a digest of the 64 KiB of memory (64-bit FNV-1a, hex).
+ *
+ * Stop reasons are "brk", "store", "pc", "self-jump" and "budget".
+ * Every stop except the budget is a debugger point (Debugger.h), so the
+ * run stops on the exact instruction and costs about one page test per
+ * instruction:
+ *   - BRK is a read watchpoint on the BRK vector at $FFFE; the runner
+ *     raises no IRQs, so only BRK (or code reading the vector) reads it.
+ *     The machine is left in the handler, with "address" the BRK.
+ *   - Self-jumps are found by scanning memory after loading for JMP abs
+ *     to its own address and branches with offset $FE, each becoming a
+ *     breakpoint whose condition is the branch being taken. One written
+ *     at run time is not found; the budget still ends the run.
+ *
+ * Exit status is 0 after a run (whatever stopped it), 1 if the image
+ * cannot be loaded and 2 on a usage error. There is no iostream, so
+ * the process starts and exits without its static setup.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -I. tools/Runner.cpp CPU.cpp Debugger.cpp \
+ *       Instructions.cpp Loader.cpp Memory.cpp -o m6502_run
+ */
+
+#include "CPU.h"
+#include "Debugger.h"
+#include "Loader.h"
+#include "Memory.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace M6502;
+
+namespace {
+
+    constexpr Cycles DEFAULT_BUDGET = 100'000'000;
+
+    struct Options {
+        const char* image = nullptr;
+        LoadOptions load;
+        bool hasEntry = false;
+        Address entry = 0;
+        Cycles budget = DEFAULT_BUDGET;
+        std::vector<Address> stopPCs;
+        std::vector<Address> stopStores;
+        bool stopOnBRK = true;
+        bool stopOnSelfJump = true;
+    };
+
+    /// Decimal, $hex or 0xhex, all of `text`, at most `limit`
+    bool ParseNumber(const char* text, std::uint64_t limit, std::uint64_t& value) {
+        int base = 10;
+        if (text[0] == '$') {
+            text++;
+            base = 16;
+        } else if (text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+            text += 2;
+            base = 16;
+        }
+        if (*text == '\0') {
+            return false;
+        }
+        char* end;
+        value = std::strtoull(text, &end, base);
+        return *end == '\0' && value <= limit;
+    }
+
+    bool ParseAddress(const char* text, Address& address) {
+        std::uint64_t value;
+        if (!ParseNumber(text, 0xFFFF, value)) {
+            return false;
+        }
+        address = static_cast<Address>(value);
+        return true;
+    }
+
+    bool ParseFormat(const char* text, ImageFormat& format) {
+        static const struct { const char* name; ImageFormat format; } FORMATS[] = {
+            { "auto", ImageFormat::Detect }, { "raw", ImageFormat::Raw },
+            { "hex", ImageFormat::IntelHex }, { "srec", ImageFormat::SRecord },
+            { "seg", ImageFormat::Segments }
+        };
+        for (const auto& entry : FORMATS) {
+            if (std::strcmp(text, entry.name) == 0) {
+                format = entry.format;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool ParseArguments(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; i++) {
+            const char* argument = argv[i];
+            const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+            Address address;
+            std::uint64_t number;
+
+            if (std::strcmp(argument, "--no-brk") == 0) {
+                options.stopOnBRK = false;
+                continue;
+            }
+            if (std::strcmp(argument, "--no-self-jump") == 0) {
+                options.stopOnSelfJump = false;
+                continue;
+            }
+            if (argument[0] != '-') {
+                if (options.image != nullptr) {
+                    return false;
+                }
+                options.image = argument;
+                continue;
+            }
+
+            // Everything else takes a value
+            if (value == nullptr) {
+                return false;
+            }
+            i++;
+            if (std::strcmp(argument, "--format") == 0) {
+                if (!ParseFormat(value, options.load.format)) {
+                    return false;
+                }
+            } else if (std::strcmp(argument, "--base") == 0) {
+                if (!ParseAddress(value, options.load.base)) {
+                    return false;
+                }
+            } else if (std::strcmp(argument, "--entry") == 0) {
+                if (!ParseAddress(value, options.entry)) {
+                    return false;
+                }
+                options.hasEntry = true;
+            } else if (std::strcmp(argument, "--cycles") == 0) {
+                if (!ParseNumber(value, UINT64_MAX, number) || number == 0) {
+                    return false;
+                }
+                options.budget = number;
+            } else if (std::strcmp(argument, "--stop-pc") == 0) {
+                if (!ParseAddress(value, address)) {
+                    return false;
+                }
+                options.stopPCs.push_back(address);
+            } else if (std::strcmp(argument, "--stop-store") == 0) {
+                if (!ParseAddress(value, address)) {
+                    return false;
+                }
+                options.stopStores.push_back(address);
+            } else {
+                return false;
+            }
+        }
+        return options.image != nullptr;
+    }
+
+    // ====================================================================
+    // STOP POINTS
+    // ====================================================================
+
+    /**
+     * @brief Breakpoints on every jump or branch to itself in memory
+     *
+     * Scans every address, not just code: a breakpoint only fires when
+     * an instruction starts there, so one on data is never hit.
+     */
+    void AddSelfJumps(Debugger& debugger, const Memory& memory) {
+        // Branch opcodes and the flag test that makes each one taken
+        static const struct { Byte opcode; const char* taken; } BRANCHES[] = {
+            { INS_BPL, "!N" }, { INS_BMI, "N" }, { INS_BVC, "!V" }, { INS_BVS, "V" },
+            { INS_BCC, "!C" }, { INS_BCS, "C" }, { INS_BNE, "!Z" }, { INS_BEQ, "Z" }
+        };
+        Condition taken[8];
+        for (int i = 0; i < 8; i++) {
+            Condition::Parse(BRANCHES[i].taken, taken[i]);
+        }
+
+        for (std::uint32_t address = 0; address + 2 < MEMORY_SIZE; address++) {
+            const Byte opcode = memory[static_cast<Address>(address)];
+            const Byte first = memory[static_cast<Address>(address + 1)];
+            if (opcode == INS_JMP_ABS) {
+                const Address target = first | (memory[static_cast<Address>(address + 2)] << 8);
+                if (target == address) {
+                    debugger.AddBreakpoint(target);
+                }
+            } else if (first == 0xFE) {
+                for (int i = 0; i < 8; i++) {
+                    if (opcode == BRANCHES[i].opcode) {
+                        debugger.AddBreakpoint(static_cast<Address>(address), taken[i]);
+                    }
+                }
+            }
+        }
+    }
+
+    /// 64-bit FNV-1a of the whole address space
+    std::uint64_t Digest(const Memory& memory) {
+        std::uint64_t hash = 0xCBF29CE484222325ull;
+        for (std::size_t page = 0; page < Memory::PAGE_COUNT; page++) {
+            const Byte* bytes = memory.PageData(static_cast<Byte>(page));
+            for (std::size_t i = 0; i < Memory::PAGE_SIZE; i++) {
+                hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+            }
+        }
+        return hash;
+    }
+
+    // Static rather than on the stack: both are tens of KiB
+    Memory memory;
+    CPU cpu;
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseArguments(argc, argv, options)) {
+        std::fprintf(stderr,
+                     "usage: %s [--format auto|raw|hex|srec|seg] [--base ADDR] [--entry ADDR]\n"
+                     "       [--cycles N] [--stop-pc ADDR]... [--stop-store ADDR]...\n"
+                     "       [--no-brk] [--no-self-jump] <image>\n", argv[0]);
+        return 2;
+    }
+
+    options.load.setResetVector = !options.hasEntry;
+    ImageInfo info;
+    if (!LoadProgramFile(options.image, memory, options.load, info)) {
+        std::fprintf(stderr, "%s: cannot load image\n", options.image);
+        return 1;
+    }
+    if (options.hasEntry) {
+        const Byte vector[2] = { static_cast<Byte>(options.entry & 0xFF),
+                                 static_cast<Byte>(options.entry >> 8) };
+        memory.LoadProgram(VECTOR_RESET, vector, sizeof(vector));
+    }
+
+    cpu.Reset(memory);
+
+    // Attached after the reset so its vector fetch is not a BRK
+    Debugger debugger;
+    debugger.Attach(cpu, memory);
+    Debugger::PointId brk = Debugger::NO_POINT;
+    if (options.stopOnBRK) {
+        brk = debugger.AddWatchpoint(VECTOR_IRQ_BRK, VECTOR_IRQ_BRK, AccessWatcher::WATCH_READ);
+    }
+    Debugger::PointId lastRequested = brk;
+    for (Address address : options.stopStores) {
+        lastRequested = debugger.AddWatchpoint(address, address, AccessWatcher::WATCH_WRITE);
+    }
+    for (Address address : options.stopPCs) {
+        lastRequested = debugger.AddBreakpoint(address);
+    }
+    if (options.stopOnSelfJump) {
+        AddSelfJumps(debugger, memory);
+    }
+
+    // Run until a point stops the CPU or the budget is spent
+    const char* reason = "budget";
+    Address where = cpu.PC;
+    int stored = -1;
+    Cycles elapsed = 0;
+    const auto start = std::chrono::steady_clock::now();
+    while (elapsed < options.budget) {
+        const Cycles ran = cpu.Execute(options.budget - elapsed, memory);
+        elapsed += ran;
+
+        Debugger::Stop stop;
+        if (!debugger.TakeStop(stop)) {
+            if (ran == 0) {
+                break;
+            }
+            continue;
+        }
+        if (stop.point == brk) {
+            // A vector read by anything but BRK is not a stop
+            if (memory.ReadByteNoCycles(stop.registers.PC) != INS_BRK) {
+                continue;
+            }
+            reason = "brk";
+            where = stop.registers.PC;
+        } else if (stop.reason == Debugger::StopReason::Write) {
+            reason = "store";
+            where = stop.address;
+            stored = stop.value;
+        } else {
+            // Ids count up, so points added after the requested ones are self-jumps
+            reason = stop.point > lastRequested ? "self-jump" : "pc";
+            where = stop.address;
+        }
+        break;
+    }
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (std::strcmp(reason, "budget") == 0) {
+        where = cpu.PC;
+    }
+
+    std::printf("{\"image\": \"");
+    for (const char* c = options.image; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') {
+            std::putchar('\\');
+        }
+        std::putchar(*c);
+    }
+    std::printf("\", \"stop\": \"%s\", \"address\": %u", reason, where);
+    if (stored >= 0) {
+        std::printf(", \"value\": %d", stored);
+    }
+    std::printf(", \"cycles\": %llu, \"seconds\": %.6f, \"mhz\": %.2f, "
+                "\"registers\": {\"pc\": %u, \"a\": %u, \"x\": %u, \"y\": %u, \"sp\": %u, \"p\": %u}, "
+                "\"memory_fnv1a64\": \"%016llx\"}\n",
+                static_cast<unsigned long long>(elapsed), seconds,
+                seconds > 0 ? elapsed / seconds / 1e6 : 0.0,
+                cpu.PC, cpu.A, cpu.X, cpu.Y, cpu.SP, static_cast<unsigned>(static_cast<Byte>(cpu.P)),
+                static_cast<unsigned long long>(Digest(memory)));
+    return 0;
+}